@@ -16,15 +16,21 @@
 
 #include "JadeWindow.h"
 #include "AboutDialog.h"
+#include "DrawingProfiler.h"
 #include "DrawingWidget.h"
 #include "ExportDialog.h"
+#include "MemoryUsageDialog.h"
+#include "MultiScalePngWriter.h"
 #include "OdgItem.h"
 #include "OdgPage.h"
 #include "OdgStyle.h"
 #include "PagesWidget.h"
+#include "PdfWriter.h"
+#include "PngWriter.h"
 #include "PreferencesDialog.h"
 #include "PropertiesWidget.h"
 #include "SvgWriter.h"
+#include "version.h"
 #include <QApplication>
 #include <QCloseEvent>
 #include <QComboBox>
@@ -34,17 +40,21 @@
 #include <QLabel>
 #include <QMenuBar>
 #include <QMessageBox>
+#include <QMutex>
 #include <QPainter>
+#include <QProgressDialog>
 #include <QSettings>
 #include <QShowEvent>
 #include <QStatusBar>
+#include <QThreadPool>
 #include <QToolBar>
 
 JadeWindow::JadeWindow() : QMainWindow(), mDrawingWidget(nullptr),
     mPagesWidget(nullptr), mPagesDock(nullptr), mPropertiesWidget(nullptr), mPropertiesDock(nullptr),
     mModeLabel(nullptr), mModifiedLabel(nullptr), mMouseInfoLabel(nullptr), mZoomCombo(nullptr),
     mFilePath(), mNewDrawingCount(0), mWorkingDir(), mPromptOverwrite(true), mPromptCloseUnsaved(true),
-    mPagesDockVisibleOnClose(true), mPropertiesDockVisibleOnClose(true), mExportPixelsPerInch(600), mExportItemsOnly(true)
+    mPagesDockVisibleOnClose(true), mPropertiesDockVisibleOnClose(true), mExportPixelsPerInch(600), mExportItemsOnly(true),
+    mExportFileNamePattern("{name}"), mExportResolutions(), mUndoMemoryBudget(512), mUndoSpillEnabled(true)
 {
     mDrawingWidget = new DrawingWidget();
     setCentralWidget(mDrawingWidget);
@@ -105,6 +115,7 @@ void JadeWindow::createActions()
     addAction("Close", this, SLOT(closeDrawing()), ":/icons/oxygen/document-close.png", "Ctrl+W");
     addAction("Export PNG...", this, SLOT(exportPng()), ":/icons/oxygen/image-x-generic.png");
     addAction("Export SVG...", this, SLOT(exportSvg()), ":/icons/oxygen/image-svg+xml.png");
+    addAction("Export PDF...", this, SLOT(exportPdf()));
     addAction("Preferences...", this, SLOT(preferences()), ":/icons/oxygen/configure.png");
     addAction("Exit", this, SLOT(close()), ":/icons/oxygen/application-exit.png");
 
@@ -119,6 +130,12 @@ void JadeWindow::createActions()
     pagesAction->setChecked(true);
     connect(mPagesDock, SIGNAL(visibilityChanged(bool)), pagesAction, SLOT(setChecked(bool)));
 
+    QAction* profilerAction = addAction("Profiler Overlay", mDrawingWidget, SLOT(setProfilerOverlayVisible(bool)),
+                                        QString(), "Ctrl+Shift+P");
+    profilerAction->setCheckable(true);
+    addAction("Export Profiler Trace...", this, SLOT(exportProfilerTrace()));
+    addAction("Memory Usage...", this, SLOT(showMemoryUsage()));
+
     addAction("About...", this, SLOT(about()), ":/icons/oxygen/help-about.png");
     addAction("About Qt...", qApp, SLOT(aboutQt()));
 }
@@ -139,6 +156,7 @@ void JadeWindow::createMenus()
     fileMenu->addSeparator();
     fileMenu->addAction(windowActions.at(JadeWindow::ExportPngAction));
     fileMenu->addAction(windowActions.at(JadeWindow::ExportSvgAction));
+    fileMenu->addAction(windowActions.at(JadeWindow::ExportPdfAction));
     fileMenu->addSeparator();
     fileMenu->addAction(windowActions.at(JadeWindow::PreferencesAction));
     fileMenu->addSeparator();
@@ -202,6 +220,10 @@ void JadeWindow::createMenus()
     drawingMenu->addAction(drawingActions.at(DrawingWidget::ZoomInAction));
     drawingMenu->addAction(drawingActions.at(DrawingWidget::ZoomOutAction));
     drawingMenu->addAction(drawingActions.at(DrawingWidget::ZoomFitAction));
+    drawingMenu->addSeparator();
+    drawingMenu->addAction(windowActions.at(JadeWindow::ViewProfilerAction));
+    drawingMenu->addAction(windowActions.at(JadeWindow::ExportProfilerTraceAction));
+    drawingMenu->addAction(windowActions.at(JadeWindow::MemoryUsageAction));
 
     QMenu* aboutMenu = menuBar()->addMenu("About");
     aboutMenu->addAction(windowActions.at(JadeWindow::AboutAction));
@@ -437,47 +459,98 @@ void JadeWindow::closeDrawing()
 
 void JadeWindow::exportPng()
 {
-    OdgPage* currentPage = mDrawingWidget->currentPage();
-    if (mDrawingWidget->isVisible() && currentPage)
-    {
-        // Determine export path
-        QString exportPath = QDir(mWorkingDir).absoluteFilePath(currentPage->name() + ".png");
+    exportPages("PNG");
+}
 
-        // Calculate the page and items' rects
-        const QRectF pageRect = mDrawingWidget->pageRect();
+void JadeWindow::exportSvg()
+{
+    exportPages("SVG");
+}
 
-        QRectF itemsRect;
-        const QList<OdgItem*> items = currentPage->items();
-        for(auto& item : items)
-            itemsRect = itemsRect.united(item->mapToScene(item->boundingRect()).normalized());
+void JadeWindow::exportPdf()
+{
+    exportPages("PDF");
+}
 
-        if (itemsRect.width() != 0 && itemsRect.height() != 0)
-        {
-            const QMarginsF pageMargins = mDrawingWidget->pageMargins();
-            itemsRect.adjust(-pageMargins.left(), -pageMargins.top(), pageMargins.right(), pageMargins.bottom());
-        }
-        else itemsRect = pageRect;
+void JadeWindow::exportProfilerTrace()
+{
+    const QString path = QFileDialog::getSaveFileName(
+        this, "Export Profiler Trace", QDir(mWorkingDir).absoluteFilePath("jade-trace.json"),
+        "Chrome Trace (*.json);;All Files (*)", nullptr,
+        ((mPromptOverwrite) ? (QFileDialog::Options)0 : QFileDialog::DontConfirmOverwrite));
+
+    if (!path.isEmpty() && !DrawingProfiler::exportChromeTrace(path))
+        QMessageBox::critical(this, "Export Profiler Trace Error", "Error writing profiler trace to " + path + ".");
+}
+
+void JadeWindow::showMemoryUsage()
+{
+    MemoryUsageDialog dialog(mDrawingWidget, this);
+    dialog.exec();
+}
+
+//======================================================================================================================
+
+void JadeWindow::exportPages(const QString& format)
+{
+    OdgPage* currentPage = mDrawingWidget->currentPage();
+    if (mDrawingWidget->isVisible() && currentPage)
+    {
+        const QList<OdgPage*> pages = mDrawingWidget->pages();
+        QStringList pageNames;
+        for(auto& page : pages)
+            pageNames.append(page->name());
 
         // Run export dialog
         ExportDialog dialog(this);
-        dialog.setWindowTitle("Export PNG");
-        dialog.setPath(exportPath);
+        dialog.setWindowTitle("Export " + format);
+        dialog.setPath(QDir(mWorkingDir).absoluteFilePath(currentPage->name() + "." + format.toLower()));
         dialog.setPromptOverwrite(mPromptOverwrite);
-        dialog.setPageRect(pageRect);
-        dialog.setItemsRect(itemsRect);
+        dialog.setPages(pageNames, pages.indexOf(currentPage));
+        dialog.setFileNamePattern(mExportFileNamePattern);
+        dialog.setResolutions(mExportResolutions);
+        dialog.setPageRect(exportRect(currentPage, false));
+        dialog.setItemsRect(exportRect(currentPage, true));
         dialog.setPixelsPerInch(mExportPixelsPerInch);
         dialog.setExportItemsOnly(mExportItemsOnly);
 
         if (dialog.exec() == QDialog::Accepted)
         {
-            QFileInfo targetFileInfo(dialog.path());
+            const QList<int> pageIndices = dialog.pageIndices();
+            const QList<double> resolutions = dialog.resolutions();
+            QList<OdgPage*> selectedPages;
+            QStringList selectedPaths, existingFileNames;
+            for(auto& pageIndex : pageIndices)
+            {
+                selectedPages.append(pages.at(pageIndex));
+                selectedPaths.append(dialog.pagePath(pageIndex));
+
+                QStringList targetPaths;
+                for(auto& factor : resolutions)
+                    targetPaths.append(MultiScalePngWriter::scaledPath(selectedPaths.last(), factor));
+                if (targetPaths.isEmpty()) targetPaths.append(selectedPaths.last());
+
+                for(auto& targetPath : qAsConst(targetPaths))
+                {
+                    QFileInfo targetFileInfo(targetPath);
+                    if (targetFileInfo.exists()) existingFileNames.append(targetFileInfo.fileName());
+                }
+            }
+
+            // A PDF holds all of the selected pages in one file; other formats have one distinct path per page
+            if (format == "PDF") selectedPaths.removeDuplicates();
+            existingFileNames.removeDuplicates();
+
             bool proceedToExport = true;
-            if (targetFileInfo.exists() && mPromptOverwrite)
+            if (!existingFileNames.isEmpty() && mPromptOverwrite)
             {
-                proceedToExport = (QMessageBox::warning(
-                                       this, "Confirm Export",
-                                       targetFileInfo.fileName() + " already exists.\nDo you want to replace it?",
-                                       QMessageBox::Yes | QMessageBox::No, QMessageBox::No) == QMessageBox::Yes);
+                const QString message = (existingFileNames.size() == 1) ?
+                                            existingFileNames.first() + " already exists.\nDo you want to replace it?" :
+                                            QString::number(existingFileNames.size()) +
+                                                " files already exist.\nDo you want to replace them?";
+                proceedToExport = (QMessageBox::warning(this, "Confirm Export", message,
+                                                        QMessageBox::Yes | QMessageBox::No,
+                                                        QMessageBox::No) == QMessageBox::Yes);
             }
 
             if (proceedToExport)
@@ -485,92 +558,146 @@ void JadeWindow::exportPng()
                 // Save export settings for next time
                 mExportPixelsPerInch = dialog.pixelsPerInch();
                 mExportItemsOnly = dialog.shouldExportItemsOnly();
+                mExportFileNamePattern = dialog.fileNamePattern();
+                if (format == "PNG") mExportResolutions = resolutions;
 
-                // Export the PNG image
+                // A single page gets every thread for its own bands; several pages are exported concurrently instead
                 const double exportScale = (mDrawingWidget->units() == Odg::UnitsInches) ? mExportPixelsPerInch :
                                                mExportPixelsPerInch * 25;
-                const QRectF exportRect = (mExportItemsOnly) ? itemsRect : pageRect;
-                const int exportWidth = qRound(exportRect.width() * exportScale);
-                const int exportHeight = qRound(exportRect.height() * exportScale);
-
-                QImage pngImage(exportWidth, exportHeight, QImage::Format_ARGB32);
-
-                QPainter painter(&pngImage);
-                painter.setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing, true);
-                painter.scale(exportScale, exportScale);
-                painter.translate(-exportRect.left(), -exportRect.top());
-                mDrawingWidget->paint(painter, true);
-                painter.end();
-
-                if (!pngImage.save(dialog.path()))
-                    QMessageBox::critical(this, "Export PNG Error", "Error exporting drawing to PNG file.  File not exported!");
+                QStringList failedPaths;
+                if (format == "PDF")
+                {
+                    if (!exportPdf(selectedPages, selectedPaths.first())) failedPaths.append(selectedPaths.first());
+                }
+                else if (selectedPages.size() == 1)
+                {
+                    if (!exportPage(selectedPages.first(), selectedPaths.first(), format, exportScale, 0))
+                        failedPaths.append(selectedPaths.first());
+                }
+                else failedPaths = exportPagesInParallel(selectedPages, selectedPaths, format, exportScale);
+
+                if (!failedPaths.isEmpty())
+                {
+                    QMessageBox::critical(this, "Export " + format + " Error", "Error exporting drawing to " + format +
+                                          " file.  File not exported!\n\n" + failedPaths.join("\n"));
+                }
             }
         }
     }
 }
 
-void JadeWindow::exportSvg()
+QStringList JadeWindow::exportPagesInParallel(const QList<OdgPage*>& pages, const QStringList& paths,
+                                              const QString& format, double scale)
 {
-    OdgPage* currentPage = mDrawingWidget->currentPage();
-    if (mDrawingWidget->isVisible() && currentPage)
+    QProgressDialog progress("Exporting pages...", "Cancel", 0, pages.size(), this);
+    progress.setWindowTitle("Export " + format);
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setMinimumDuration(0);
+    progress.setValue(0);
+
+    // Each page is exported on its own worker; pages that haven't started yet are skipped once the user cancels.
+    // The progress dialog is modal, so the drawing can't change while the workers read it.
+    QAtomicInt canceled(0);
+    QAtomicInt completedCount(0);
+    QStringList failedPaths;
+    QMutex failedPathsMutex;
+
+    QThreadPool pool;
+    for(int pageIndex = 0; pageIndex < pages.size(); pageIndex++)
     {
-        // Determine export path
-        QString exportPath = QDir(mWorkingDir).absoluteFilePath(currentPage->name() + ".svg");
+        OdgPage* page = pages.at(pageIndex);
+        const QString path = paths.at(pageIndex);
+        pool.start([this, page, path, &format, scale, &canceled, &completedCount, &failedPaths, &failedPathsMutex]()
+        {
+            if (canceled.loadAcquire() == 0 && !exportPage(page, path, format, scale, 1))
+            {
+                QMutexLocker locker(&failedPathsMutex);
+                failedPaths.append(path);
+            }
+            completedCount.fetchAndAddRelease(1);
+        });
+    }
 
-        // Calculate the page and items' rects
-        const QRectF pageRect = mDrawingWidget->pageRect();
+    while (!pool.waitForDone(50))
+    {
+        progress.setValue(completedCount.loadAcquire());
+        QCoreApplication::processEvents();
+        if (progress.wasCanceled()) canceled.storeRelease(1);
+    }
+    progress.setValue(pages.size());
+
+    return failedPaths;
+}
 
-        QRectF itemsRect;
-        const QList<OdgItem*> items = currentPage->items();
-        for(auto& item : items)
-            itemsRect = itemsRect.united(item->mapToScene(item->boundingRect()).normalized());
+bool JadeWindow::exportPage(OdgPage* page, const QString& path, const QString& format, double scale,
+                            int threadCount) const
+{
+    const QRectF rect = exportRect(page, mExportItemsOnly);
 
-        if (itemsRect.width() != 0 && itemsRect.height() != 0)
+    if (format == "SVG")
+    {
+        // .svgz files are meant for publishing, so they get the compact profile as well as compression
+        SvgWriter svg(rect, scale);
+        svg.setThreadCount(threadCount);
+        if (path.endsWith(".svgz", Qt::CaseInsensitive))
         {
-            const QMarginsF pageMargins = mDrawingWidget->pageMargins();
-            itemsRect.adjust(-pageMargins.left(), -pageMargins.top(), pageMargins.right(), pageMargins.bottom());
+            svg.setProfile(SvgWriter::CompactProfile);
+            svg.setCompressed(true);
         }
-        else itemsRect = pageRect;
+        return svg.write(path, mDrawingWidget->backgroundColor(), page->items());
+    }
 
-        // Run export dialog
-        ExportDialog dialog(this);
-        dialog.setWindowTitle("Export SVG");
-        dialog.setPath(exportPath);
-        dialog.setPromptOverwrite(mPromptOverwrite);
-        dialog.setPageRect(pageRect);
-        dialog.setItemsRect(itemsRect);
-        dialog.setPixelsPerInch(mExportPixelsPerInch);
-        dialog.setExportItemsOnly(mExportItemsOnly);
+    auto paint = [this, page](QPainter& painter, const QRectF& sceneRect)
+    {
+        painter.setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing, true);
+        mDrawingWidget->paintPage(painter, page, sceneRect);
+    };
 
-        if (dialog.exec() == QDialog::Accepted)
-        {
-            QFileInfo targetFileInfo(dialog.path());
-            bool proceedToExport = true;
-            if (targetFileInfo.exists() && mPromptOverwrite)
-            {
-                proceedToExport = (QMessageBox::warning(
-                                       this, "Confirm Export",
-                                       targetFileInfo.fileName() + " already exists.\nDo you want to replace it?",
-                                       QMessageBox::Yes | QMessageBox::No, QMessageBox::No) == QMessageBox::Yes);
-            }
+    // Several resolutions are written in one pass as name@<factor>x.png
+    if (!mExportResolutions.isEmpty())
+    {
+        MultiScalePngWriter pngWriter(rect);
+        pngWriter.setThreadCount(threadCount);
+        for(auto& factor : mExportResolutions)
+            pngWriter.addOutput(scale * factor, MultiScalePngWriter::scaledPath(path, factor));
+        return pngWriter.write(paint);
+    }
 
-            if (proceedToExport)
-            {
-                // Save export settings for next time
-                mExportPixelsPerInch = dialog.pixelsPerInch();
-                mExportItemsOnly = dialog.shouldExportItemsOnly();
+    // Rendered in bands so that large, high-resolution exports don't need the whole image in memory
+    PngWriter pngWriter(rect, scale);
+    pngWriter.setThreadCount(threadCount);
+    return pngWriter.write(path, paint);
+}
 
-                // Export the SVG image
-                const double exportScale = (mDrawingWidget->units() == Odg::UnitsInches) ? mExportPixelsPerInch :
-                                               mExportPixelsPerInch * 25;
-                const QRectF exportRect = (mExportItemsOnly) ? itemsRect : pageRect;
+bool JadeWindow::exportPdf(const QList<OdgPage*>& pages, const QString& path) const
+{
+    PdfWriter pdfWriter(mDrawingWidget->units());
+    pdfWriter.setTitle(QFileInfo(path).completeBaseName());
+    pdfWriter.setCreator("Jade " + QString(PROJECT_VERSION));
+    for(auto& page : pages)
+        pdfWriter.addPage(exportRect(page, mExportItemsOnly), page->items());
+    return pdfWriter.write(path, mDrawingWidget->backgroundColor());
+}
 
-                SvgWriter svg(exportRect, exportScale);
-                if (!svg.write(dialog.path(), mDrawingWidget->backgroundColor(), currentPage->items()))
-                    QMessageBox::critical(this, "Export SVG Error", "Error exporting drawing to SVG file.  File not exported!");
-            }
-        }
+QRectF JadeWindow::exportRect(OdgPage* page, bool itemsOnly) const
+{
+    const QRectF pageRect = mDrawingWidget->pageRect();
+    if (!itemsOnly) return pageRect;
+
+    // Calculate the page items' rect
+    QRectF itemsRect;
+    const QList<OdgItem*> items = page->items();
+    for(auto& item : items)
+        itemsRect = itemsRect.united(item->mapToScene(item->boundingRect()).normalized());
+
+    if (itemsRect.width() != 0 && itemsRect.height() != 0)
+    {
+        const QMarginsF pageMargins = mDrawingWidget->pageMargins();
+        itemsRect.adjust(-pageMargins.left(), -pageMargins.top(), pageMargins.right(), pageMargins.bottom());
+        return itemsRect;
     }
+
+    return pageRect;
 }
 
 //======================================================================================================================
@@ -579,11 +706,15 @@ void JadeWindow::preferences()
 {
     PreferencesDialog dialog(this);
     dialog.setPrompts(mPromptOverwrite, mPromptCloseUnsaved);
+    dialog.setUndoSettings(mUndoMemoryBudget, mUndoSpillEnabled);
     dialog.setDrawingTemplate(mDrawingWidget->drawingTemplate(), mDrawingWidget->styleTemplate());
 
     if (dialog.exec() == QDialog::Accepted)
     {
         dialog.updatePrompts(mPromptOverwrite, mPromptCloseUnsaved);
+        dialog.updateUndoSettings(mUndoMemoryBudget, mUndoSpillEnabled);
+        mDrawingWidget->setUndoMemoryBudget(static_cast<qint64>(mUndoMemoryBudget) * 1024 * 1024);
+        mDrawingWidget->setUndoSpillEnabled(mUndoSpillEnabled);
         dialog.updateDrawingTemplate(mDrawingWidget->drawingTemplate(), mDrawingWidget->styleTemplate());
     }
 }
@@ -647,6 +778,7 @@ void JadeWindow::setDrawingVisible(bool visible)
     windowActions.at(JadeWindow::CloseAction)->setEnabled(visible);
     windowActions.at(JadeWindow::ExportPngAction)->setEnabled(visible);
     windowActions.at(JadeWindow::ExportSvgAction)->setEnabled(visible);
+    windowActions.at(JadeWindow::ExportPdfAction)->setEnabled(visible);
     windowActions.at(JadeWindow::ViewPagesAction)->setEnabled(visible);
     windowActions.at(JadeWindow::ViewPropertiesAction)->setEnabled(visible);
 
@@ -725,6 +857,8 @@ void JadeWindow::saveSettings()
     settings.setValue("workingDir", mWorkingDir);
     settings.setValue("exportPixelsPerInch", mExportPixelsPerInch);
     settings.setValue("exportItemsOnly", mExportItemsOnly);
+    settings.setValue("exportFileNamePattern", mExportFileNamePattern);
+    settings.setValue("exportResolutions", MultiScalePngWriter::formatFactors(mExportResolutions));
     settings.endGroup();
 
     settings.beginGroup("Prompts");
@@ -732,6 +866,11 @@ void JadeWindow::saveSettings()
     settings.setValue("promptOnOverwrite", mPromptOverwrite);
     settings.endGroup();
 
+    settings.beginGroup("Undo");
+    settings.setValue("memoryBudget", mUndoMemoryBudget);
+    settings.setValue("spillToDisk", mUndoSpillEnabled);
+    settings.endGroup();
+
     OdgDrawing* drawingTemplate = mDrawingWidget->drawingTemplate();
     OdgStyle* styleTemplate = mDrawingWidget->styleTemplate();
     if (drawingTemplate || styleTemplate)
@@ -804,11 +943,21 @@ void JadeWindow::loadSettings()
     mPromptOverwrite = settings.value("promptOnOverwrite", mPromptOverwrite).toBool();
     settings.endGroup();
 
+    settings.beginGroup("Undo");
+    mUndoMemoryBudget = settings.value("memoryBudget", mUndoMemoryBudget).toInt();
+    mUndoSpillEnabled = settings.value("spillToDisk", mUndoSpillEnabled).toBool();
+    settings.endGroup();
+
+    mDrawingWidget->setUndoMemoryBudget(static_cast<qint64>(mUndoMemoryBudget) * 1024 * 1024);
+    mDrawingWidget->setUndoSpillEnabled(mUndoSpillEnabled);
+
     settings.beginGroup("Recent");
     const QDir newDir(settings.value("workingDir", mWorkingDir).toString());
     if (newDir.exists()) mWorkingDir = newDir.path();
     mExportPixelsPerInch = settings.value("exportPixelsPerInch", mExportPixelsPerInch).toDouble();
     mExportItemsOnly = settings.value("exportItemsOnly", mExportItemsOnly).toBool();
+    mExportFileNamePattern = settings.value("exportFileNamePattern", mExportFileNamePattern).toString();
+    mExportResolutions = MultiScalePngWriter::parseFactors(settings.value("exportResolutions").toString());
     settings.endGroup();
 
     OdgDrawing* drawingTemplate = mDrawingWidget->drawingTemplate();
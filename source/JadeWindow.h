@@ -22,6 +22,7 @@
 class QComboBox;
 class QLabel;
 class DrawingWidget;
+class OdgPage;
 class PagesWidget;
 class PropertiesWidget;
 class StylesWidget;
@@ -32,8 +33,8 @@ class JadeWindow : public QMainWindow
 
 public:
     enum ActionIndex { NewAction, OpenAction, SaveAction, SaveAsAction, CloseAction, ExportPngAction, ExportSvgAction,
-                       PreferencesAction, ExitAction, ViewPropertiesAction, ViewPagesAction,
-                       AboutAction, AboutQtAction };
+                       ExportPdfAction, PreferencesAction, ExitAction, ViewPropertiesAction, ViewPagesAction,
+                       ViewProfilerAction, ExportProfilerTraceAction, MemoryUsageAction, AboutAction, AboutQtAction };
 
 private:
     DrawingWidget* mDrawingWidget;
@@ -59,6 +60,10 @@ private:
     bool mPropertiesDockVisibleOnClose;
     double mExportPixelsPerInch;
     bool mExportItemsOnly;
+    QString mExportFileNamePattern;
+    QList<double> mExportResolutions;
+    int mUndoMemoryBudget;
+    bool mUndoSpillEnabled;
 
 public:
     JadeWindow();
@@ -83,11 +88,21 @@ public slots:
 
     void exportPng();
     void exportSvg();
+    void exportPdf();
+    void exportProfilerTrace();
+    void showMemoryUsage();
 
     void preferences();
     void about();
 
 private:
+    void exportPages(const QString& format);
+    QStringList exportPagesInParallel(const QList<OdgPage*>& pages, const QStringList& paths, const QString& format,
+                                      double scale);
+    bool exportPage(OdgPage* page, const QString& path, const QString& format, double scale, int threadCount) const;
+    bool exportPdf(const QList<OdgPage*>& pages, const QString& path) const;
+    QRectF exportRect(OdgPage* page, bool itemsOnly) const;
+
     void showEvent(QShowEvent* event) override;
     void closeEvent(QCloseEvent* event) override;
 
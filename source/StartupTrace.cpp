@@ -0,0 +1,145 @@
+// File: StartupTrace.cpp
+// Copyright (C) 2023  Jason Allen
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "StartupTrace.h"
+#include "DrawingProfiler.h"
+#include <QCoreApplication>
+#include <QEvent>
+#include <QTextStream>
+#include <QTimer>
+#include <QWidget>
+
+StartupTrace::StartupTrace(qint64 elapsedBeforeTrace, QObject* parent) : QObject(parent),
+    mPhases(), mPhaseStart(0), mBudget(1000), mTraceFileName(), mQuitWhenFinished(false),
+    mFirstFrameWidget(nullptr), mFinished(false)
+{
+    // Whatever happened before the trace was created (i.e. constructing the QApplication) is reported as a phase of
+    // its own, but it can't be placed in the profiler's timeline
+    Phase phase = { "startup/QApplication", elapsedBeforeTrace };
+    mPhases.append(phase);
+
+    DrawingProfiler::setEnabled(true);
+    mPhaseStart = DrawingProfiler::now();
+}
+
+//======================================================================================================================
+
+void StartupTrace::setBudget(double milliseconds)
+{
+    mBudget = qMax(milliseconds, 0.0);
+}
+
+void StartupTrace::setTraceFileName(const QString& fileName)
+{
+    mTraceFileName = fileName;
+}
+
+void StartupTrace::setQuitWhenFinished(bool quit)
+{
+    mQuitWhenFinished = quit;
+}
+
+double StartupTrace::budget() const
+{
+    return mBudget;
+}
+
+QString StartupTrace::traceFileName() const
+{
+    return mTraceFileName;
+}
+
+bool StartupTrace::quitWhenFinished() const
+{
+    return mQuitWhenFinished;
+}
+
+//======================================================================================================================
+
+void StartupTrace::endPhase(const char* name)
+{
+    if (mFinished) return;
+
+    const qint64 now = DrawingProfiler::now();
+    DrawingProfiler::addDuration(name, mPhaseStart, now - mPhaseStart);
+
+    Phase phase = { name, now - mPhaseStart };
+    mPhases.append(phase);
+    mPhaseStart = now;
+}
+
+void StartupTrace::waitForFirstFrame(QWidget* widget)
+{
+    if (widget && !mFinished)
+    {
+        mFirstFrameWidget = widget;
+        mFirstFrameWidget->installEventFilter(this);
+    }
+}
+
+//======================================================================================================================
+
+qint64 StartupTrace::totalTime() const
+{
+    qint64 total = 0;
+    for(auto& phase : mPhases) total += phase.duration;
+    return total;
+}
+
+bool StartupTrace::isWithinBudget() const
+{
+    return (mBudget <= 0 || totalTime() <= mBudget * 1E6);
+}
+
+//======================================================================================================================
+
+bool StartupTrace::eventFilter(QObject* object, QEvent* event)
+{
+    if (object == mFirstFrameWidget && event->type() == QEvent::Paint)
+    {
+        // Finish once the paint event has been handled, i.e. once the first frame is actually drawn
+        mFirstFrameWidget->removeEventFilter(this);
+        mFirstFrameWidget = nullptr;
+        QTimer::singleShot(0, this, SLOT(finish()));
+    }
+
+    return QObject::eventFilter(object, event);
+}
+
+void StartupTrace::finish()
+{
+    if (mFinished) return;
+
+    endPhase("startup/firstFrame");
+    mFinished = true;
+    DrawingProfiler::setEnabled(false);
+
+    QTextStream err(stderr);
+    for(auto& phase : qAsConst(mPhases))
+        err << QString("%1 %2 ms").arg(phase.name, -28).arg(phase.duration / 1E6, 10, 'f', 1) << Qt::endl;
+    err << QString("%1 %2 ms").arg("startup/total", -28).arg(totalTime() / 1E6, 10, 'f', 1) << Qt::endl;
+
+    if (!isWithinBudget())
+    {
+        err << QString("jade: startup took %1 ms, over the %2 ms budget").arg(totalTime() / 1E6, 0, 'f', 1)
+                                                                         .arg(mBudget, 0, 'f', 0) << Qt::endl;
+    }
+
+    if (!mTraceFileName.isEmpty() && !DrawingProfiler::exportChromeTrace(mTraceFileName))
+        err << "jade: unable to write " << mTraceFileName << Qt::endl;
+
+    if (mQuitWhenFinished) QCoreApplication::exit(isWithinBudget() ? 0 : 1);
+}
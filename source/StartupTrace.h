@@ -0,0 +1,72 @@
+// File: StartupTrace.h
+// Copyright (C) 2023  Jason Allen
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef STARTUPTRACE_H
+#define STARTUPTRACE_H
+
+#include <QList>
+#include <QObject>
+#include <QString>
+
+class QWidget;
+
+// Measures cold start to first frame.  Each startup phase is recorded into the drawing profiler as it ends; once the
+// watched widget has painted for the first time the phases are reported on stderr, checked against the startup
+// budget and optionally exported as a Chrome trace.
+class StartupTrace : public QObject
+{
+    Q_OBJECT
+
+private:
+    struct Phase
+    {
+        const char* name;
+        qint64 duration;
+    };
+
+    QList<Phase> mPhases;
+    qint64 mPhaseStart;
+    double mBudget;
+    QString mTraceFileName;
+    bool mQuitWhenFinished;
+
+    QWidget* mFirstFrameWidget;
+    bool mFinished;
+
+public:
+    StartupTrace(qint64 elapsedBeforeTrace, QObject* parent = nullptr);
+
+    void setBudget(double milliseconds);
+    void setTraceFileName(const QString& fileName);
+    void setQuitWhenFinished(bool quit);
+    double budget() const;
+    QString traceFileName() const;
+    bool quitWhenFinished() const;
+
+    void endPhase(const char* name);
+    void waitForFirstFrame(QWidget* widget);
+
+    qint64 totalTime() const;
+    bool isWithinBudget() const;
+
+protected:
+    bool eventFilter(QObject* object, QEvent* event) override;
+
+private slots:
+    void finish();
+};
+
+#endif
@@ -0,0 +1,85 @@
+// File: BenchAllocations.cpp
+// Copyright (C) 2023  Jason Allen
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "BenchAllocations.h"
+#include <QAtomicInteger>
+#include <cstdlib>
+#include <new>
+
+static QAtomicInteger<quint64> sAllocationCount = 0;
+
+quint64 benchAllocationCount()
+{
+    return sAllocationCount.loadRelaxed();
+}
+
+//======================================================================================================================
+
+#if defined(__GLIBC__)
+
+// Qt's containers allocate through malloc rather than operator new, so hook the C allocator itself and forward to
+// glibc's internal entry points.  operator new is implemented on top of malloc and is counted here as well.
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t count, size_t size);
+extern "C" void* __libc_realloc(void* pointer, size_t size);
+
+extern "C" void* malloc(size_t size) __THROW
+{
+    sAllocationCount.fetchAndAddRelaxed(1);
+    return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t count, size_t size) __THROW
+{
+    sAllocationCount.fetchAndAddRelaxed(1);
+    return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* pointer, size_t size) __THROW
+{
+    sAllocationCount.fetchAndAddRelaxed(1);
+    return __libc_realloc(pointer, size);
+}
+
+#else
+
+void* operator new(std::size_t size)
+{
+    sAllocationCount.fetchAndAddRelaxed(1);
+    if (void* pointer = std::malloc(size > 0 ? size : 1))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    sAllocationCount.fetchAndAddRelaxed(1);
+    if (void* pointer = std::malloc(size > 0 ? size : 1))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+#endif
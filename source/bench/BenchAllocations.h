@@ -0,0 +1,26 @@
+// File: BenchAllocations.h
+// Copyright (C) 2023  Jason Allen
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef BENCHALLOCATIONS_H
+#define BENCHALLOCATIONS_H
+
+#include <QtGlobal>
+
+// Returns the number of heap allocations made by the process so far.  On glibc every malloc/calloc/realloc is
+// counted, which includes the allocations made by Qt's containers; elsewhere only operator new is counted.
+quint64 benchAllocationCount();
+
+#endif
@@ -0,0 +1,304 @@
+// File: BenchGenerator.cpp
+// Copyright (C) 2023  Jason Allen
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "BenchGenerator.h"
+#include "DrawingWidget.h"
+#include "ElectricItems.h"
+#include "LogicItems.h"
+#include "OdgControlPoint.h"
+#include "OdgGluePoint.h"
+#include "OdgPage.h"
+#include "OdgPathItem.h"
+#include "OdgPolylineItem.h"
+#include "OdgStyle.h"
+#include "OdgTextItem.h"
+#include <QtMath>
+
+BenchGenerator::BenchGenerator() :
+    mPageCount(1), mItemsPerPage(1000), mPathWeight(60), mPolylineWeight(30), mTextWeight(10),
+    mConnectionDensity(0.5), mSeed(1), mPathTemplates()
+{
+    mPathTemplates.append(ElectricItems::items());
+    mPathTemplates.append(LogicItems::items());
+}
+
+BenchGenerator::~BenchGenerator()
+{
+    qDeleteAll(mPathTemplates);
+}
+
+//======================================================================================================================
+
+void BenchGenerator::setPageCount(int count)
+{
+    mPageCount = qMax(count, 1);
+}
+
+void BenchGenerator::setItemsPerPage(int count)
+{
+    mItemsPerPage = qMax(count, 0);
+}
+
+void BenchGenerator::setMix(int pathWeight, int polylineWeight, int textWeight)
+{
+    mPathWeight = qMax(pathWeight, 0);
+    mPolylineWeight = qMax(polylineWeight, 0);
+    mTextWeight = qMax(textWeight, 0);
+    if (mPathWeight + mPolylineWeight + mTextWeight == 0) mPathWeight = 1;
+}
+
+void BenchGenerator::setConnectionDensity(double density)
+{
+    mConnectionDensity = qBound(0.0, density, 1.0);
+}
+
+void BenchGenerator::setSeed(quint32 seed)
+{
+    mSeed = seed;
+}
+
+int BenchGenerator::pageCount() const
+{
+    return mPageCount;
+}
+
+int BenchGenerator::itemsPerPage() const
+{
+    return mItemsPerPage;
+}
+
+int BenchGenerator::pathWeight() const
+{
+    return mPathWeight;
+}
+
+int BenchGenerator::polylineWeight() const
+{
+    return mPolylineWeight;
+}
+
+int BenchGenerator::textWeight() const
+{
+    return mTextWeight;
+}
+
+double BenchGenerator::connectionDensity() const
+{
+    return mConnectionDensity;
+}
+
+quint32 BenchGenerator::seed() const
+{
+    return mSeed;
+}
+
+//======================================================================================================================
+
+QList<OdgPage*> BenchGenerator::createPages(DrawingWidget* drawing) const
+{
+    QList<OdgPage*> pages;
+    if (!drawing || mPathTemplates.isEmpty()) return pages;
+
+    QRandomGenerator random(mSeed);
+    const int totalWeight = mPathWeight + mPolylineWeight + mTextWeight;
+
+    for(int pageIndex = 0; pageIndex < mPageCount; pageIndex++)
+    {
+        OdgPage* page = new OdgPage("Page " + QString::number(pageIndex + 1));
+        QList<OdgItem*> pathItems;
+
+        for(int itemIndex = 0; itemIndex < mItemsPerPage; itemIndex++)
+        {
+            const int choice = random.bounded(totalWeight);
+            if (choice < mPathWeight)
+            {
+                OdgPathItem* pathItem = createPathItem(drawing, random);
+                page->addItem(pathItem);
+                pathItems.append(pathItem);
+            }
+            else if (choice < mPathWeight + mPolylineWeight)
+            {
+                // Glue a fraction of the polylines between two existing symbols so that the generated pages
+                // exercise the connection-maintenance code the same way a real schematic does
+                if (pathItems.size() >= 2 && random.generateDouble() < mConnectionDensity)
+                {
+                    OdgItem* startItem = pathItems.at(random.bounded(pathItems.size()));
+                    OdgItem* endItem = pathItems.at(random.bounded(pathItems.size()));
+                    if (startItem != endItem && !startItem->gluePoints().isEmpty() &&
+                        !endItem->gluePoints().isEmpty())
+                    {
+                        page->addItem(createWire(drawing, startItem, random.bounded(startItem->gluePoints().size()),
+                                                 endItem, random.bounded(endItem->gluePoints().size())));
+                        continue;
+                    }
+                }
+
+                page->addItem(createPolylineItem(drawing, random));
+            }
+            else page->addItem(createTextItem(drawing, random, itemIndex));
+        }
+
+        pages.append(page);
+    }
+
+    return pages;
+}
+
+OdgPage* BenchGenerator::createConnectionStressPage(DrawingWidget* drawing, int wireCount,
+                                                    OdgItem*& hubItem) const
+{
+    hubItem = nullptr;
+    if (!drawing || mPathTemplates.isEmpty()) return nullptr;
+
+    OdgPage* page = new OdgPage("Connection Stress");
+
+    // One symbol in the middle of the page with every wire glued to it, so that moving the symbol forces all of
+    // the wires to be resized in a single maintainItemConnections pass
+    OdgPathItem* hub = static_cast<OdgPathItem*>(mPathTemplates.first()->copy());
+    hub->setPen(drawing->defaultStyle()->lookupPen());
+    hub->setBrush(drawing->defaultStyle()->lookupBrush());
+    hub->placeCreateEvent(drawing->contentRect(), drawing->grid());
+    hub->setPosition(drawing->contentRect().center());
+    page->addItem(hub);
+    hubItem = hub;
+
+    const QList<OdgGluePoint*> gluePoints = hub->gluePoints();
+    if (gluePoints.isEmpty()) return page;
+
+    const QPointF center = drawing->contentRect().center();
+    const double radius = qMin(drawing->contentRect().width(), drawing->contentRect().height()) * 0.4;
+    for(int i = 0; i < wireCount; i++)
+    {
+        const double angle = 2 * M_PI * i / wireCount;
+        const QPointF endPosition = center + QPointF(radius * qCos(angle), radius * qSin(angle));
+        const QPointF startPosition = hub->mapToScene(gluePoints.at(i % gluePoints.size())->position());
+
+        QPolygonF polyline;
+        polyline << startPosition << QPointF(endPosition.x(), startPosition.y()) << endPosition;
+
+        OdgPolylineItem* wire = new OdgPolylineItem();
+        wire->setPen(drawing->defaultStyle()->lookupPen());
+        wire->setPolyline(polyline);
+        wire->controlPoints().first()->setConnectable(true);
+        wire->controlPoints().last()->setConnectable(true);
+        wire->controlPoints().first()->connect(gluePoints.at(i % gluePoints.size()));
+        page->addItem(wire);
+    }
+
+    return page;
+}
+
+QList<OdgItem*> BenchGenerator::createWires(DrawingWidget* drawing,
+                                            const QList<QPointF>& startPoints) const
+{
+    QList<OdgItem*> wires;
+    if (!drawing) return wires;
+
+    const double length = drawing->grid() > 0 ? 10 * drawing->grid() : drawing->contentRect().width() / 32;
+    for(auto& startPoint : startPoints)
+    {
+        QPolygonF polyline;
+        polyline << startPoint << startPoint + QPointF(length, 0) << startPoint + QPointF(length, length);
+
+        OdgPolylineItem* wire = new OdgPolylineItem();
+        wire->setPen(drawing->defaultStyle()->lookupPen());
+        wire->setPolyline(polyline);
+        wire->controlPoints().first()->setConnectable(true);
+        wire->controlPoints().last()->setConnectable(true);
+        wires.append(wire);
+    }
+
+    return wires;
+}
+
+//======================================================================================================================
+
+OdgPathItem* BenchGenerator::createPathItem(DrawingWidget* drawing, QRandomGenerator& random) const
+{
+    // Copies share the template's path data, just like items placed from the palette
+    OdgPathItem* item = static_cast<OdgPathItem*>(mPathTemplates.at(random.bounded(mPathTemplates.size()))->copy());
+    item->setPen(drawing->defaultStyle()->lookupPen());
+    item->setBrush(drawing->defaultStyle()->lookupBrush());
+    item->placeCreateEvent(drawing->contentRect(), drawing->grid());
+    item->setPosition(randomPosition(drawing, random));
+    return item;
+}
+
+OdgPolylineItem* BenchGenerator::createPolylineItem(DrawingWidget* drawing,
+                                                    QRandomGenerator& random) const
+{
+    const double span = drawing->contentRect().width() / 16;
+    const QPointF startPosition = randomPosition(drawing, random);
+    const QPointF midPosition = startPosition + QPointF(span * (random.generateDouble() - 0.5), 0);
+    const QPointF endPosition = midPosition + QPointF(0, span * (random.generateDouble() - 0.5));
+
+    QPolygonF polyline;
+    polyline << startPosition << midPosition << endPosition;
+
+    OdgPolylineItem* item = new OdgPolylineItem();
+    item->setPen(drawing->defaultStyle()->lookupPen());
+    item->setPolyline(polyline);
+    return item;
+}
+
+OdgPolylineItem* BenchGenerator::createWire(DrawingWidget* drawing, OdgItem* startItem, int startIndex,
+                                            OdgItem* endItem, int endIndex) const
+{
+    OdgGluePoint* startGluePoint = startItem->gluePoints().at(startIndex);
+    OdgGluePoint* endGluePoint = endItem->gluePoints().at(endIndex);
+    const QPointF startPosition = startItem->mapToScene(startGluePoint->position());
+    const QPointF endPosition = endItem->mapToScene(endGluePoint->position());
+
+    QPolygonF polyline;
+    polyline << startPosition << QPointF(endPosition.x(), startPosition.y()) << endPosition;
+
+    OdgPolylineItem* item = new OdgPolylineItem();
+    item->setPen(drawing->defaultStyle()->lookupPen());
+    item->setPolyline(polyline);
+
+    OdgControlPoint* startPoint = item->controlPoints().first();
+    OdgControlPoint* endPoint = item->controlPoints().last();
+    startPoint->setConnectable(true);
+    endPoint->setConnectable(true);
+    startPoint->connect(startGluePoint);
+    endPoint->connect(endGluePoint);
+
+    return item;
+}
+
+OdgItem* BenchGenerator::createTextItem(DrawingWidget* drawing, QRandomGenerator& random, int index) const
+{
+    OdgTextItem* item = new OdgTextItem();
+    item->setFont(drawing->defaultStyle()->lookupFont());
+    item->setTextAlignment(drawing->defaultStyle()->lookupTextAlignment());
+    item->setTextPadding(drawing->defaultStyle()->lookupTextPadding());
+    item->setTextBrush(drawing->defaultStyle()->lookupTextBrush());
+    item->setCaption("Label " + QString::number(index));
+    item->setPosition(randomPosition(drawing, random));
+    return item;
+}
+
+//======================================================================================================================
+
+QPointF BenchGenerator::randomPosition(DrawingWidget* drawing, QRandomGenerator& random) const
+{
+    const QRectF contentRect = drawing->contentRect();
+    const QPointF position(contentRect.left() + random.generateDouble() * contentRect.width(),
+                           contentRect.top() + random.generateDouble() * contentRect.height());
+
+    // Snap to the drawing's grid so generated items line up the way interactively placed items do
+    return drawing->roundToGrid(position);
+}
@@ -0,0 +1,74 @@
+// File: BenchGenerator.h
+// Copyright (C) 2023  Jason Allen
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef BENCHGENERATOR_H
+#define BENCHGENERATOR_H
+
+#include <QList>
+#include <QPointF>
+#include <QRandomGenerator>
+
+class DrawingWidget;
+class OdgItem;
+class OdgPage;
+class OdgPathItem;
+class OdgPolylineItem;
+
+class BenchGenerator
+{
+private:
+    int mPageCount;
+    int mItemsPerPage;
+    int mPathWeight;
+    int mPolylineWeight;
+    int mTextWeight;
+    double mConnectionDensity;
+    quint32 mSeed;
+
+    QList<OdgPathItem*> mPathTemplates;
+
+public:
+    BenchGenerator();
+    ~BenchGenerator();
+
+    void setPageCount(int count);
+    void setItemsPerPage(int count);
+    void setMix(int pathWeight, int polylineWeight, int textWeight);
+    void setConnectionDensity(double density);
+    void setSeed(quint32 seed);
+    int pageCount() const;
+    int itemsPerPage() const;
+    int pathWeight() const;
+    int polylineWeight() const;
+    int textWeight() const;
+    double connectionDensity() const;
+    quint32 seed() const;
+
+    QList<OdgPage*> createPages(DrawingWidget* drawing) const;
+    OdgPage* createConnectionStressPage(DrawingWidget* drawing, int wireCount, OdgItem*& hubItem) const;
+    QList<OdgItem*> createWires(DrawingWidget* drawing, const QList<QPointF>& startPoints) const;
+
+private:
+    OdgPathItem* createPathItem(DrawingWidget* drawing, QRandomGenerator& random) const;
+    OdgPolylineItem* createPolylineItem(DrawingWidget* drawing, QRandomGenerator& random) const;
+    OdgPolylineItem* createWire(DrawingWidget* drawing, OdgItem* startItem, int startIndex, OdgItem* endItem,
+                                int endIndex) const;
+    OdgItem* createTextItem(DrawingWidget* drawing, QRandomGenerator& random, int index) const;
+
+    QPointF randomPosition(DrawingWidget* drawing, QRandomGenerator& random) const;
+};
+
+#endif
@@ -0,0 +1,228 @@
+// File: BenchRenderCheck.cpp
+// Copyright (C) 2023  Jason Allen
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "BenchRenderCheck.h"
+#include "DrawingWidget.h"
+#include "OdgPage.h"
+#include "OdgReader.h"
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+
+BenchRenderCheck::BenchRenderCheck() :
+    mOutputDirectory("render-check"), mTolerance(0), mZoomFactor(4.0), mViewCount(0), mFailureCount(0),
+    mOut(stdout)
+{
+    // Nothing more to do here.
+}
+
+//======================================================================================================================
+
+void BenchRenderCheck::setOutputDirectory(const QString& path)
+{
+    mOutputDirectory = path;
+}
+
+void BenchRenderCheck::setTolerance(int tolerance)
+{
+    mTolerance = qBound(0, tolerance, 255);
+}
+
+void BenchRenderCheck::setZoomFactor(double factor)
+{
+    if (factor >= 1) mZoomFactor = factor;
+}
+
+QString BenchRenderCheck::outputDirectory() const
+{
+    return mOutputDirectory;
+}
+
+int BenchRenderCheck::tolerance() const
+{
+    return mTolerance;
+}
+
+double BenchRenderCheck::zoomFactor() const
+{
+    return mZoomFactor;
+}
+
+//======================================================================================================================
+
+void BenchRenderCheck::printHeader()
+{
+    mOut << QString("%1 %2 %3 %4 %5").arg("view", -48).arg("reference ms", 14).arg("optimized ms", 14)
+                                     .arg("diff pixels", 12).arg("result", 8) << Qt::endl;
+}
+
+bool BenchRenderCheck::checkFile(DrawingWidget* drawing, const QString& fileName)
+{
+    // DrawingWidget::load reports errors with a message box, which would block an offscreen run, so make sure the
+    // file is readable first
+    OdgReader reader(fileName);
+    if (!reader.open() || !reader.read() || !drawing->load(fileName))
+    {
+        mOut << "FAIL " << fileName << ": unable to read drawing" << Qt::endl;
+        mFailureCount++;
+        return false;
+    }
+
+    const QString baseName = QFileInfo(fileName).completeBaseName();
+    const QList<OdgPage*> pages = drawing->pages();
+    bool passed = true;
+
+    for(int pageIndex = 0; pageIndex < pages.size(); pageIndex++)
+    {
+        drawing->setCurrentPageIndex(pageIndex);
+        const QString pageName = baseName + "_" + QString::number(pageIndex + 1);
+
+        // The whole page, where nothing should be culled
+        drawing->zoomFit();
+        if (!checkView(drawing, pageName + "_fit")) passed = false;
+
+        // Zoomed in around several points, where most items are culled and the ones straddling the edges matter
+        const QList<QPointF> centers = viewCenters(drawing);
+        for(int i = 0; i < centers.size(); i++)
+        {
+            drawing->zoomFit();
+            drawing->setScale(drawing->scale() * mZoomFactor);
+            drawing->centerOn(centers.at(i));
+            if (!checkView(drawing, pageName + "_zoom" + QString::number(i + 1))) passed = false;
+        }
+    }
+
+    return passed;
+}
+
+//======================================================================================================================
+
+int BenchRenderCheck::viewCount() const
+{
+    return mViewCount;
+}
+
+int BenchRenderCheck::failureCount() const
+{
+    return mFailureCount;
+}
+
+//======================================================================================================================
+
+bool BenchRenderCheck::checkView(DrawingWidget* drawing, const QString& name)
+{
+    // The reference is the unculled path that every item goes through; the optimized path is the editor's default
+    qint64 referenceTime = 0, optimizedTime = 0;
+    const QImage reference = render(drawing, false, referenceTime);
+    const QImage optimized = render(drawing, true, optimizedTime);
+
+    QImage diffImage;
+    const int differingPixels = compare(reference, optimized, diffImage);
+    const bool passed = (differingPixels == 0);
+
+    mViewCount++;
+    mOut << QString("%1 %2 %3 %4 %5").arg(name, -48)
+                                     .arg(referenceTime / 1E6, 14, 'f', 3)
+                                     .arg(optimizedTime / 1E6, 14, 'f', 3)
+                                     .arg(differingPixels, 12)
+                                     .arg(passed ? "ok" : "FAIL", 8) << Qt::endl;
+
+    if (!passed)
+    {
+        // Dump all three images so the failure can be inspected without rerunning
+        mFailureCount++;
+
+        const QDir dir(mOutputDirectory);
+        if (dir.mkpath("."))
+        {
+            reference.save(dir.filePath(name + "_reference.png"));
+            optimized.save(dir.filePath(name + "_optimized.png"));
+            diffImage.save(dir.filePath(name + "_diff.png"));
+        }
+    }
+
+    return passed;
+}
+
+QImage BenchRenderCheck::render(DrawingWidget* drawing, bool culling, qint64& elapsed) const
+{
+    QImage image(drawing->viewport()->size(), QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+
+    drawing->setCullingEnabled(culling);
+
+    QElapsedTimer timer;
+    timer.start();
+    drawing->viewport()->render(&image);
+    elapsed = timer.nsecsElapsed();
+
+    drawing->setCullingEnabled(true);
+    return image;
+}
+
+int BenchRenderCheck::compare(const QImage& reference, const QImage& image, QImage& diffImage) const
+{
+    if (reference.size() != image.size())
+    {
+        diffImage = QImage();
+        return qMax(reference.width() * reference.height(), image.width() * image.height());
+    }
+
+    // Pixels within the tolerance are drawn as a faded copy of the reference, others in solid red
+    const QImage referenceImage = reference.convertToFormat(QImage::Format_ARGB32);
+    const QImage otherImage = image.convertToFormat(QImage::Format_ARGB32);
+    diffImage = QImage(reference.size(), QImage::Format_ARGB32);
+
+    int differingPixels = 0;
+    for(int y = 0; y < referenceImage.height(); y++)
+    {
+        const QRgb* referenceLine = reinterpret_cast<const QRgb*>(referenceImage.constScanLine(y));
+        const QRgb* otherLine = reinterpret_cast<const QRgb*>(otherImage.constScanLine(y));
+        QRgb* diffLine = reinterpret_cast<QRgb*>(diffImage.scanLine(y));
+
+        for(int x = 0; x < referenceImage.width(); x++)
+        {
+            const QRgb a = referenceLine[x];
+            const QRgb b = otherLine[x];
+            if (qAbs(qRed(a) - qRed(b)) > mTolerance || qAbs(qGreen(a) - qGreen(b)) > mTolerance ||
+                qAbs(qBlue(a) - qBlue(b)) > mTolerance || qAbs(qAlpha(a) - qAlpha(b)) > mTolerance)
+            {
+                diffLine[x] = qRgb(255, 0, 0);
+                differingPixels++;
+            }
+            else
+            {
+                const int gray = 192 + qGray(a) / 4;
+                diffLine[x] = qRgb(gray, gray, gray);
+            }
+        }
+    }
+
+    return differingPixels;
+}
+
+QList<QPointF> BenchRenderCheck::viewCenters(DrawingWidget* drawing) const
+{
+    const QRectF contentRect = drawing->contentRect();
+
+    QList<QPointF> centers;
+    centers << contentRect.center();
+    centers << QPointF(contentRect.left() + contentRect.width() / 4, contentRect.top() + contentRect.height() / 4);
+    centers << QPointF(contentRect.right() - contentRect.width() / 4, contentRect.top() + contentRect.height() / 4);
+    centers << QPointF(contentRect.left() + contentRect.width() / 4, contentRect.bottom() - contentRect.height() / 4);
+    centers << QPointF(contentRect.right() - contentRect.width() / 4, contentRect.bottom() - contentRect.height() / 4);
+    return centers;
+}
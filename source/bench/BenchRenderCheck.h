@@ -0,0 +1,62 @@
+// File: BenchRenderCheck.h
+// Copyright (C) 2023  Jason Allen
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef BENCHRENDERCHECK_H
+#define BENCHRENDERCHECK_H
+
+#include <QImage>
+#include <QList>
+#include <QPointF>
+#include <QSize>
+#include <QTextStream>
+
+class DrawingWidget;
+
+class BenchRenderCheck
+{
+private:
+    QString mOutputDirectory;
+    int mTolerance;
+    double mZoomFactor;
+
+    int mViewCount;
+    int mFailureCount;
+    QTextStream mOut;
+
+public:
+    BenchRenderCheck();
+
+    void setOutputDirectory(const QString& path);
+    void setTolerance(int tolerance);
+    void setZoomFactor(double factor);
+    QString outputDirectory() const;
+    int tolerance() const;
+    double zoomFactor() const;
+
+    void printHeader();
+    bool checkFile(DrawingWidget* drawing, const QString& fileName);
+
+    int viewCount() const;
+    int failureCount() const;
+
+private:
+    bool checkView(DrawingWidget* drawing, const QString& name);
+    QImage render(DrawingWidget* drawing, bool culling, qint64& elapsed) const;
+    int compare(const QImage& reference, const QImage& image, QImage& diffImage) const;
+    QList<QPointF> viewCenters(DrawingWidget* drawing) const;
+};
+
+#endif
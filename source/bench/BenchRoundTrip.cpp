@@ -0,0 +1,766 @@
+// File: BenchRoundTrip.cpp
+// Copyright (C) 2023  Jason Allen
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "BenchRoundTrip.h"
+#include "ElectricItems.h"
+#include "LogicItems.h"
+#include "OdgControlPoint.h"
+#include "OdgCurve.h"
+#include "OdgCurveItem.h"
+#include "OdgDrawing.h"
+#include "OdgEllipseItem.h"
+#include "OdgFontStyle.h"
+#include "OdgGroupItem.h"
+#include "OdgLineItem.h"
+#include "OdgPage.h"
+#include "OdgPathItem.h"
+#include "OdgPolygonItem.h"
+#include "OdgPolylineItem.h"
+#include "OdgReader.h"
+#include "OdgRectItem.h"
+#include "OdgRoundedRectItem.h"
+#include "OdgStyle.h"
+#include "OdgTextEllipseItem.h"
+#include "OdgTextItem.h"
+#include "OdgTextRoundedRectItem.h"
+#include "OdgWriter.h"
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <typeinfo>
+
+// Item properties that don't describe geometry; geometry is compared through the items' control points in scene
+// coordinates, which doesn't depend on how the reader chooses to split it between position and local coordinates
+static const QStringList sComparedProperties = {
+    "pen", "brush", "startMarker", "endMarker", "cornerRadius",
+    "font", "textAlignment", "textPadding", "textBrush", "caption"
+};
+
+BenchRoundTrip::BenchRoundTrip() :
+    mMaximumItems(200), mMaximumGroupDepth(3), mOutputDirectory("roundtrip"),
+    mCaseCount(0), mFailureCount(0), mBytes(0), mWriteTime(0), mReadTime(0), mPathTemplates(), mOut(stdout)
+{
+    mPathTemplates.append(ElectricItems::items());
+    mPathTemplates.append(LogicItems::items());
+}
+
+BenchRoundTrip::~BenchRoundTrip()
+{
+    qDeleteAll(mPathTemplates);
+}
+
+//======================================================================================================================
+
+void BenchRoundTrip::setMaximumItems(int count)
+{
+    mMaximumItems = qMax(count, 1);
+}
+
+void BenchRoundTrip::setMaximumGroupDepth(int depth)
+{
+    mMaximumGroupDepth = qMax(depth, 0);
+}
+
+void BenchRoundTrip::setOutputDirectory(const QString& path)
+{
+    mOutputDirectory = path;
+}
+
+int BenchRoundTrip::maximumItems() const
+{
+    return mMaximumItems;
+}
+
+int BenchRoundTrip::maximumGroupDepth() const
+{
+    return mMaximumGroupDepth;
+}
+
+QString BenchRoundTrip::outputDirectory() const
+{
+    return mOutputDirectory;
+}
+
+//======================================================================================================================
+
+bool BenchRoundTrip::run(quint32 seed)
+{
+    QRandomGenerator random(seed);
+    mCaseCount++;
+
+    OdgDrawing expected;
+    OdgStyle* expectedStyle = nullptr;
+    createDrawing(random, expected, expectedStyle);
+
+    QTemporaryDir tempDir;
+    const QString fileName = tempDir.filePath("roundtrip.odg");
+    QElapsedTimer timer;
+    QString message;
+    bool passed = tempDir.isValid();
+
+    // Write
+    if (passed)
+    {
+        OdgWriter writer(fileName);
+        passed = writer.open();
+        if (passed)
+        {
+            writer.setUnits(expected.units());
+            writer.setPageSize(expected.pageSize());
+            writer.setPageMargins(expected.pageMargins());
+            writer.setBackgroundColor(expected.backgroundColor());
+            writer.setGrid(expected.grid());
+            writer.setGridStyle(expected.gridStyle());
+            writer.setGridColor(expected.gridColor());
+            writer.setGridSpacingMajor(expected.gridSpacingMajor());
+            writer.setGridSpacingMinor(expected.gridSpacingMinor());
+            writer.setDefaultStyle(expectedStyle);
+            writer.setPages(expected.pages());
+
+            timer.start();
+            passed = writer.write();
+            mWriteTime += timer.nsecsElapsed();
+        }
+        if (!passed) message = "unable to write drawing";
+    }
+
+    // Read
+    OdgDrawing actual;
+    OdgStyle* actualStyle = nullptr;
+    if (passed)
+    {
+        mBytes += QFileInfo(fileName).size();
+
+        OdgReader reader(fileName);
+        passed = reader.open();
+        if (passed)
+        {
+            timer.start();
+            passed = reader.read();
+            mReadTime += timer.nsecsElapsed();
+        }
+
+        if (passed)
+        {
+            // Units first, since changing them rescales the drawing's other lengths
+            actual.setUnits(reader.units());
+            actual.setPageSize(reader.pageSize());
+            actual.setPageMargins(reader.pageMargins());
+            actual.setBackgroundColor(reader.backgroundColor());
+            actual.setGrid(reader.grid());
+            actual.setGridStyle(reader.gridStyle());
+            actual.setGridColor(reader.gridColor());
+            actual.setGridSpacingMajor(reader.gridSpacingMajor());
+            actual.setGridSpacingMinor(reader.gridSpacingMinor());
+
+            actualStyle = reader.takeDefaultStyle();
+            const QList<OdgPage*> pages = reader.takePages();
+            for(auto& page : pages)
+                actual.addPage(page);
+        }
+        else message = "unable to read drawing";
+    }
+
+    // Compare
+    if (passed) passed = compareDrawings(expected, expectedStyle, actual, actualStyle, message);
+
+    if (!passed)
+    {
+        // Keep the failing file so it can be inspected; the seed regenerates the original drawing
+        mFailureCount++;
+        mOut << "FAIL seed " << seed << ": " << message << Qt::endl;
+
+        const QDir dir(mOutputDirectory);
+        if (QFile::exists(fileName) && dir.mkpath("."))
+            QFile::copy(fileName, dir.filePath("roundtrip_" + QString::number(seed) + ".odg"));
+    }
+
+    delete expectedStyle;
+    delete actualStyle;
+    return passed;
+}
+
+void BenchRoundTrip::printSummary()
+{
+    const double megabytes = mBytes / 1E6;
+    mOut << QString("# %1 case(s), %2 failure(s), %3 MB").arg(mCaseCount).arg(mFailureCount)
+                                                        .arg(megabytes, 0, 'f', 3) << Qt::endl;
+    if (mWriteTime > 0)
+        mOut << QString("# write: %1 MB/s").arg(megabytes / (mWriteTime / 1E9), 0, 'f', 2) << Qt::endl;
+    if (mReadTime > 0)
+        mOut << QString("# read: %1 MB/s").arg(megabytes / (mReadTime / 1E9), 0, 'f', 2) << Qt::endl;
+}
+
+int BenchRoundTrip::caseCount() const
+{
+    return mCaseCount;
+}
+
+int BenchRoundTrip::failureCount() const
+{
+    return mFailureCount;
+}
+
+//======================================================================================================================
+
+void BenchRoundTrip::createDrawing(QRandomGenerator& random, OdgDrawing& drawing, OdgStyle*& style) const
+{
+    const Odg::Units units = (random.bounded(2) == 0) ? Odg::UnitsInches : Odg::UnitsMillimeters;
+    const double scale = (units == Odg::UnitsInches) ? 1.0 : 25.4;
+
+    drawing.setUnits(units);
+    drawing.setPageSize(QSizeF((4 + random.generateDouble() * 12) * scale, (4 + random.generateDouble() * 12) * scale));
+    drawing.setPageMargins(QMarginsF(random.generateDouble() * 0.5 * scale, random.generateDouble() * 0.5 * scale,
+                                     random.generateDouble() * 0.5 * scale, random.generateDouble() * 0.5 * scale));
+    drawing.setBackgroundColor(randomColor(random));
+    drawing.setGrid((0.01 + random.generateDouble() * 0.1) * scale);
+    drawing.setGridStyle((random.bounded(2) == 0) ? Odg::GridHidden : Odg::GridLines);
+    drawing.setGridColor(randomColor(random));
+    drawing.setGridSpacingMajor(1 + random.bounded(16));
+    drawing.setGridSpacingMinor(1 + random.bounded(8));
+
+    style = new OdgStyle(units, true);
+    const QPen pen = randomPen(random, scale);
+    style->setPenStyle(pen.style());
+    style->setPenWidth(pen.widthF());
+    style->setPenColor(pen.color());
+    style->setBrushColor(randomColor(random));
+    style->setStartMarkerStyle(randomMarker(random, scale).style());
+    style->setStartMarkerSize(randomMarker(random, scale).size());
+    style->setEndMarkerStyle(randomMarker(random, scale).style());
+    style->setEndMarkerSize(randomMarker(random, scale).size());
+    const QFont font = randomFont(random, scale);
+    style->setFontFamily(font.family());
+    style->setFontSize(font.pointSizeF());
+    style->setFontStyle(OdgFontStyle(font.bold(), font.italic(), font.underline(), font.strikeOut()));
+    style->setTextAlignment(randomAlignment(random));
+    style->setTextPadding(QSizeF(random.generateDouble() * 0.1 * scale, random.generateDouble() * 0.1 * scale));
+    style->setTextColor(randomColor(random));
+
+    const int pageCount = 1 + random.bounded(3);
+    for(int pageIndex = 0; pageIndex < pageCount; pageIndex++)
+    {
+        OdgPage* page = new OdgPage("Page " + QString::number(pageIndex + 1) + ((pageIndex % 2) ? " & <more>" : ""));
+
+        const int itemCount = random.bounded(mMaximumItems + 1);
+        for(int i = 0; i < itemCount; i++)
+            page->addItem(createItem(random, drawing.contentRect(), scale, 0));
+
+        drawing.addPage(page);
+    }
+}
+
+OdgItem* BenchRoundTrip::createItem(QRandomGenerator& random, const QRectF& rect, double scale, int depth) const
+{
+    enum ItemType { LineType, CurveType, PolylineType, RectType, RoundedRectType, EllipseType, PolygonType, TextType,
+                    TextRoundedRectType, TextEllipseType, PathType, GroupType, NumberOfItemTypes };
+
+    const double size = (0.1 + random.generateDouble()) * scale;
+    const QRectF itemRect(-size / 2, -size / 4, size, size / 2);
+
+    const int type = random.bounded((depth < mMaximumGroupDepth) ? NumberOfItemTypes : GroupType);
+    switch (type)
+    {
+    case LineType:
+    {
+        OdgLineItem* item = new OdgLineItem();
+        item->setLine(QLineF(randomPoint(random, itemRect), randomPoint(random, itemRect)));
+        item->setPen(randomPen(random, scale));
+        item->setStartMarker(randomMarker(random, scale));
+        item->setEndMarker(randomMarker(random, scale));
+        setItemTransform(random, item, rect, true);
+        return item;
+    }
+    case CurveType:
+    {
+        OdgCurveItem* item = new OdgCurveItem();
+        item->setCurve(OdgCurve(randomPoint(random, itemRect), randomPoint(random, itemRect),
+                                randomPoint(random, itemRect), randomPoint(random, itemRect)));
+        item->setPen(randomPen(random, scale));
+        item->setStartMarker(randomMarker(random, scale));
+        item->setEndMarker(randomMarker(random, scale));
+        setItemTransform(random, item, rect, true);
+        return item;
+    }
+    case PolylineType:
+    {
+        QPolygonF polyline;
+        const int pointCount = 2 + random.bounded(6);
+        for(int i = 0; i < pointCount; i++) polyline.append(randomPoint(random, itemRect));
+
+        OdgPolylineItem* item = new OdgPolylineItem();
+        item->setPolyline(polyline);
+        item->setPen(randomPen(random, scale));
+        item->setStartMarker(randomMarker(random, scale));
+        item->setEndMarker(randomMarker(random, scale));
+        setItemTransform(random, item, rect, true);
+        return item;
+    }
+    case RectType:
+    {
+        OdgRectItem* item = new OdgRectItem();
+        item->setRect(itemRect);
+        item->setBrush(randomBrush(random));
+        item->setPen(randomPen(random, scale));
+        setItemTransform(random, item, rect, true);
+        return item;
+    }
+    case RoundedRectType:
+    {
+        OdgRoundedRectItem* item = new OdgRoundedRectItem();
+        item->setRect(itemRect);
+        item->setCornerRadius(random.generateDouble() * itemRect.height() / 2);
+        item->setBrush(randomBrush(random));
+        item->setPen(randomPen(random, scale));
+        setItemTransform(random, item, rect, true);
+        return item;
+    }
+    case EllipseType:
+    {
+        OdgEllipseItem* item = new OdgEllipseItem();
+        item->setEllipse(itemRect);
+        item->setBrush(randomBrush(random));
+        item->setPen(randomPen(random, scale));
+        setItemTransform(random, item, rect, true);
+        return item;
+    }
+    case PolygonType:
+    {
+        QPolygonF polygon;
+        const int pointCount = 3 + random.bounded(6);
+        for(int i = 0; i < pointCount; i++) polygon.append(randomPoint(random, itemRect));
+
+        OdgPolygonItem* item = new OdgPolygonItem();
+        item->setPolygon(polygon);
+        item->setBrush(randomBrush(random));
+        item->setPen(randomPen(random, scale));
+        setItemTransform(random, item, rect, true);
+        return item;
+    }
+    case TextType:
+    {
+        OdgTextItem* item = new OdgTextItem();
+        item->setCaption(randomCaption(random));
+        item->setFont(randomFont(random, scale));
+        item->setTextAlignment(randomAlignment(random));
+        item->setTextPadding(QSizeF(random.generateDouble() * 0.1 * scale, random.generateDouble() * 0.1 * scale));
+        item->setTextBrush(randomBrush(random));
+        setItemTransform(random, item, rect, true);
+        return item;
+    }
+    case TextRoundedRectType:
+    {
+        OdgTextRoundedRectItem* item = new OdgTextRoundedRectItem();
+        item->setRect(itemRect);
+        item->setCornerRadius(random.generateDouble() * itemRect.height() / 2);
+        item->setBrush(randomBrush(random));
+        item->setPen(randomPen(random, scale));
+        item->setCaption(randomCaption(random));
+        item->setFont(randomFont(random, scale));
+        item->setTextAlignment(randomAlignment(random));
+        item->setTextPadding(QSizeF(random.generateDouble() * 0.1 * scale, random.generateDouble() * 0.1 * scale));
+        item->setTextBrush(randomBrush(random));
+        setItemTransform(random, item, rect, true);
+        return item;
+    }
+    case TextEllipseType:
+    {
+        OdgTextEllipseItem* item = new OdgTextEllipseItem();
+        item->setEllipse(itemRect);
+        item->setBrush(randomBrush(random));
+        item->setPen(randomPen(random, scale));
+        item->setCaption(randomCaption(random));
+        item->setFont(randomFont(random, scale));
+        item->setTextAlignment(randomAlignment(random));
+        item->setTextPadding(QSizeF(random.generateDouble() * 0.1 * scale, random.generateDouble() * 0.1 * scale));
+        item->setTextBrush(randomBrush(random));
+        setItemTransform(random, item, rect, true);
+        return item;
+    }
+    case PathType:
+    {
+        OdgPathItem* item = static_cast<OdgPathItem*>(mPathTemplates.at(random.bounded(mPathTemplates.size()))->copy());
+        item->placeCreateEvent(rect, (0.02 + random.generateDouble() * 0.05) * scale);
+        item->setBrush(randomBrush(random));
+        item->setPen(randomPen(random, scale));
+        setItemTransform(random, item, rect, true);
+        return item;
+    }
+    default:
+    {
+        // Children are positioned relative to the group.  Groups are never flipped: the writer bakes a group's
+        // transform into its children because <draw:g> has no transform, and a flip doesn't commute with the
+        // children's own rotations.
+        const QRectF childRect(-rect.width() / 8, -rect.height() / 8, rect.width() / 4, rect.height() / 4);
+
+        QList<OdgItem*> children;
+        const int childCount = 1 + random.bounded(5);
+        for(int i = 0; i < childCount; i++) children.append(createItem(random, childRect, scale, depth + 1));
+
+        OdgGroupItem* item = new OdgGroupItem();
+        item->setItems(children);
+        setItemTransform(random, item, rect, false);
+        return item;
+    }
+    }
+}
+
+void BenchRoundTrip::setItemTransform(QRandomGenerator& random, OdgItem* item, const QRectF& rect, bool canFlip) const
+{
+    item->setPosition(randomPoint(random, rect));
+    item->setRotation(random.bounded(4));
+    item->setFlipped(canFlip && random.bounded(2) == 1);
+}
+
+//======================================================================================================================
+
+QColor BenchRoundTrip::randomColor(QRandomGenerator& random) const
+{
+    // Mostly opaque, with the occasional translucent color to exercise the opacity attributes
+    const int alpha = (random.bounded(4) == 0) ? random.bounded(256) : 255;
+    return QColor(random.bounded(256), random.bounded(256), random.bounded(256), alpha);
+}
+
+QPen BenchRoundTrip::randomPen(QRandomGenerator& random, double scale) const
+{
+    static const Qt::PenStyle styles[] = {
+        Qt::NoPen, Qt::SolidLine, Qt::DashLine, Qt::DotLine, Qt::DashDotLine, Qt::DashDotDotLine
+    };
+
+    // Items always use round caps and joins, matching OdgStyle::lookupPen
+    return QPen(QBrush(randomColor(random)), random.generateDouble() * 0.05 * scale, styles[random.bounded(6)],
+                Qt::RoundCap, Qt::RoundJoin);
+}
+
+QBrush BenchRoundTrip::randomBrush(QRandomGenerator& random) const
+{
+    return QBrush(randomColor(random));
+}
+
+OdgMarker BenchRoundTrip::randomMarker(QRandomGenerator& random, double scale) const
+{
+    static const Odg::MarkerStyle styles[] = { Odg::NoMarker, Odg::TriangleMarker, Odg::CircleMarker };
+    return OdgMarker(styles[random.bounded(3)], (0.01 + random.generateDouble() * 0.1) * scale);
+}
+
+QFont BenchRoundTrip::randomFont(QRandomGenerator& random, double scale) const
+{
+    static const QStringList families = { "Aptos", "Arial", "Courier New", "Times New Roman", "DejaVu Sans" };
+
+    QFont font(families.at(random.bounded(families.size())));
+    font.setPointSizeF((0.05 + random.generateDouble() * 0.2) * scale);
+    font.setBold(random.bounded(2) == 1);
+    font.setItalic(random.bounded(2) == 1);
+    font.setUnderline(random.bounded(2) == 1);
+    font.setStrikeOut(random.bounded(2) == 1);
+    return font;
+}
+
+Qt::Alignment BenchRoundTrip::randomAlignment(QRandomGenerator& random) const
+{
+    static const Qt::Alignment horizontal[] = { Qt::AlignLeft, Qt::AlignHCenter, Qt::AlignRight };
+    static const Qt::Alignment vertical[] = { Qt::AlignTop, Qt::AlignVCenter, Qt::AlignBottom };
+    return horizontal[random.bounded(3)] | vertical[random.bounded(3)];
+}
+
+QString BenchRoundTrip::randomCaption(QRandomGenerator& random) const
+{
+    // Includes characters that must be escaped in XML, non-ASCII text and multiple lines
+    static const QStringList captions = {
+        "R1", "Label", "A & B", "<tag>", "\"quoted\" 'text'", "10 µF", "Ω ≤ 1k",
+        "first line\nsecond line", "x < y > z", "日本語"
+    };
+    return captions.at(random.bounded(captions.size()));
+}
+
+QPointF BenchRoundTrip::randomPoint(QRandomGenerator& random, const QRectF& rect) const
+{
+    return QPointF(rect.left() + random.generateDouble() * rect.width(),
+                   rect.top() + random.generateDouble() * rect.height());
+}
+
+//======================================================================================================================
+
+bool BenchRoundTrip::compareDrawings(OdgDrawing& expected, OdgStyle* expectedStyle, OdgDrawing& actual,
+                                     OdgStyle* actualStyle, QString& message) const
+{
+    if (expected.units() != actual.units() ||
+        !fuzzyEqual(expected.pageSize().width(), actual.pageSize().width()) ||
+        !fuzzyEqual(expected.pageSize().height(), actual.pageSize().height()) ||
+        !fuzzyEqual(expected.pageMargins().left(), actual.pageMargins().left()) ||
+        !fuzzyEqual(expected.pageMargins().top(), actual.pageMargins().top()) ||
+        !fuzzyEqual(expected.pageMargins().right(), actual.pageMargins().right()) ||
+        !fuzzyEqual(expected.pageMargins().bottom(), actual.pageMargins().bottom()) ||
+        !fuzzyEqual(expected.backgroundColor(), actual.backgroundColor()))
+    {
+        message = "page settings differ";
+        return false;
+    }
+
+    if (!fuzzyEqual(expected.grid(), actual.grid()) || expected.gridStyle() != actual.gridStyle() ||
+        !fuzzyEqual(expected.gridColor(), actual.gridColor()) ||
+        expected.gridSpacingMajor() != actual.gridSpacingMajor() ||
+        expected.gridSpacingMinor() != actual.gridSpacingMinor())
+    {
+        message = "grid settings differ";
+        return false;
+    }
+
+    if (!actualStyle ||
+        !compareValues(expectedStyle->lookupPen(), actualStyle->lookupPen()) ||
+        !compareValues(expectedStyle->lookupBrush(), actualStyle->lookupBrush()) ||
+        !compareValues(QVariant::fromValue(expectedStyle->lookupStartMarker()),
+                       QVariant::fromValue(actualStyle->lookupStartMarker())) ||
+        !compareValues(QVariant::fromValue(expectedStyle->lookupEndMarker()),
+                       QVariant::fromValue(actualStyle->lookupEndMarker())) ||
+        !compareValues(expectedStyle->lookupFont(), actualStyle->lookupFont()) ||
+        expectedStyle->lookupTextAlignment() != actualStyle->lookupTextAlignment() ||
+        !compareValues(expectedStyle->lookupTextPadding(), actualStyle->lookupTextPadding()) ||
+        !compareValues(expectedStyle->lookupTextBrush(), actualStyle->lookupTextBrush()))
+    {
+        message = "default style differs";
+        return false;
+    }
+
+    const QList<OdgPage*> expectedPages = expected.pages();
+    const QList<OdgPage*> actualPages = actual.pages();
+    if (expectedPages.size() != actualPages.size())
+    {
+        message = QString("expected %1 page(s), found %2").arg(expectedPages.size()).arg(actualPages.size());
+        return false;
+    }
+
+    for(int pageIndex = 0; pageIndex < expectedPages.size(); pageIndex++)
+    {
+        OdgPage* expectedPage = expectedPages.at(pageIndex);
+        OdgPage* actualPage = actualPages.at(pageIndex);
+        const QString pagePath = "page " + QString::number(pageIndex + 1);
+
+        if (expectedPage->name() != actualPage->name())
+        {
+            message = pagePath + ": expected name \"" + expectedPage->name() + "\", found \"" + actualPage->name() +
+                      "\"";
+            return false;
+        }
+
+        const QList<OdgItem*> expectedItems = expectedPage->items();
+        const QList<OdgItem*> actualItems = actualPage->items();
+        if (expectedItems.size() != actualItems.size())
+        {
+            message = pagePath + QString(": expected %1 item(s), found %2").arg(expectedItems.size())
+                                                                            .arg(actualItems.size());
+            return false;
+        }
+
+        for(int i = 0; i < expectedItems.size(); i++)
+        {
+            if (!compareItems(expectedItems.at(i), QTransform(), actualItems.at(i), QTransform(),
+                              pagePath + " item " + QString::number(i + 1), message))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool BenchRoundTrip::compareItems(OdgItem* expected, const QTransform& expectedParentTransform, OdgItem* actual,
+                                  const QTransform& actualParentTransform, const QString& path,
+                                  QString& message) const
+{
+    if (typeid(*expected) != typeid(*actual))
+    {
+        message = path + ": expected " + typeid(*expected).name() + ", found " + typeid(*actual).name();
+        return false;
+    }
+
+    const QTransform expectedTransform = expected->transform() * expectedParentTransform;
+    const QTransform actualTransform = actual->transform() * actualParentTransform;
+
+    // Groups are compared through their children, since the writer flattens the group's own transform
+    OdgGroupItem* expectedGroup = dynamic_cast<OdgGroupItem*>(expected);
+    if (expectedGroup)
+    {
+        const QList<OdgItem*> expectedChildren = expectedGroup->items();
+        const QList<OdgItem*> actualChildren = static_cast<OdgGroupItem*>(actual)->items();
+        if (expectedChildren.size() != actualChildren.size())
+        {
+            message = path + QString(": expected %1 child item(s), found %2").arg(expectedChildren.size())
+                                                                              .arg(actualChildren.size());
+            return false;
+        }
+
+        for(int i = 0; i < expectedChildren.size(); i++)
+        {
+            if (!compareItems(expectedChildren.at(i), expectedTransform, actualChildren.at(i), actualTransform,
+                              path + "." + QString::number(i + 1), message))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // Orientation (rotation and flip)
+    if (!compareTransforms(expectedTransform, actualTransform))
+    {
+        message = path + ": orientation differs";
+        return false;
+    }
+
+    // Geometry
+    const QList<OdgControlPoint*> expectedPoints = expected->controlPoints();
+    const QList<OdgControlPoint*> actualPoints = actual->controlPoints();
+    if (expectedPoints.size() != actualPoints.size())
+    {
+        message = path + QString(": expected %1 control point(s), found %2").arg(expectedPoints.size())
+                                                                             .arg(actualPoints.size());
+        return false;
+    }
+
+    for(int i = 0; i < expectedPoints.size(); i++)
+    {
+        if (!fuzzyEqual(expectedTransform.map(expectedPoints.at(i)->position()),
+                        actualTransform.map(actualPoints.at(i)->position())))
+        {
+            message = path + ": control point " + QString::number(i + 1) + " differs";
+            return false;
+        }
+    }
+
+    OdgPathItem* expectedPath = dynamic_cast<OdgPathItem*>(expected);
+    if (expectedPath)
+    {
+        OdgPathItem* actualPath = static_cast<OdgPathItem*>(actual);
+        const QPainterPath path1 = expectedPath->path();
+        const QPainterPath path2 = actualPath->path();
+        bool pathsEqual = (path1.elementCount() == path2.elementCount() &&
+                           fuzzyEqual(expectedPath->pathRect().topLeft(), actualPath->pathRect().topLeft()) &&
+                           fuzzyEqual(expectedPath->pathRect().bottomRight(), actualPath->pathRect().bottomRight()));
+        for(int i = 0; pathsEqual && i < path1.elementCount(); i++)
+        {
+            pathsEqual = (path1.elementAt(i).type == path2.elementAt(i).type &&
+                          fuzzyEqual(QPointF(path1.elementAt(i)), QPointF(path2.elementAt(i))));
+        }
+
+        if (!pathsEqual)
+        {
+            message = path + ": path differs";
+            return false;
+        }
+    }
+
+    // Style and text
+    for(auto& name : sComparedProperties)
+    {
+        const QVariant expectedValue = expected->property(name);
+        if (!expectedValue.isValid()) continue;
+
+        const QVariant actualValue = actual->property(name);
+        if (!compareValues(expectedValue, actualValue))
+        {
+            QString expectedText, actualText;
+            QDebug(&expectedText) << expectedValue;
+            QDebug(&actualText) << actualValue;
+            message = path + ": property " + name + " differs (expected " + expectedText + ", found " + actualText +
+                      ")";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool BenchRoundTrip::compareValues(const QVariant& expected, const QVariant& actual) const
+{
+    if (expected.userType() != actual.userType()) return false;
+
+    if (expected.userType() == qMetaTypeId<OdgMarker>())
+    {
+        const OdgMarker marker1 = expected.value<OdgMarker>();
+        const OdgMarker marker2 = actual.value<OdgMarker>();
+        return (marker1.style() == marker2.style() &&
+                (marker1.style() == Odg::NoMarker || fuzzyEqual(marker1.size(), marker2.size())));
+    }
+
+    switch (expected.userType())
+    {
+    case QMetaType::Double:
+        return fuzzyEqual(expected.toDouble(), actual.toDouble());
+    case QMetaType::QSizeF:
+        return fuzzyEqual(QPointF(expected.toSizeF().width(), expected.toSizeF().height()),
+                          QPointF(actual.toSizeF().width(), actual.toSizeF().height()));
+    case QMetaType::QColor:
+        return fuzzyEqual(expected.value<QColor>(), actual.value<QColor>());
+    case QMetaType::QPen:
+    {
+        const QPen pen1 = expected.value<QPen>();
+        const QPen pen2 = actual.value<QPen>();
+        return (pen1.style() == pen2.style() && fuzzyEqual(pen1.widthF(), pen2.widthF()) &&
+                fuzzyEqual(pen1.color(), pen2.color()) && pen1.capStyle() == pen2.capStyle() &&
+                pen1.joinStyle() == pen2.joinStyle());
+    }
+    case QMetaType::QBrush:
+    {
+        const QBrush brush1 = expected.value<QBrush>();
+        const QBrush brush2 = actual.value<QBrush>();
+        return (brush1.style() == brush2.style() && fuzzyEqual(brush1.color(), brush2.color()));
+    }
+    case QMetaType::QFont:
+    {
+        const QFont font1 = expected.value<QFont>();
+        const QFont font2 = actual.value<QFont>();
+        return (font1.family() == font2.family() && fuzzyEqual(font1.pointSizeF(), font2.pointSizeF()) &&
+                font1.bold() == font2.bold() && font1.italic() == font2.italic() &&
+                font1.underline() == font2.underline() && font1.strikeOut() == font2.strikeOut());
+    }
+    default:
+        break;
+    }
+
+    return (expected == actual);
+}
+
+bool BenchRoundTrip::compareTransforms(const QTransform& expected, const QTransform& actual) const
+{
+    return (fuzzyEqual(expected.m11(), actual.m11()) && fuzzyEqual(expected.m12(), actual.m12()) &&
+            fuzzyEqual(expected.m21(), actual.m21()) && fuzzyEqual(expected.m22(), actual.m22()));
+}
+
+//======================================================================================================================
+
+bool BenchRoundTrip::fuzzyEqual(double value1, double value2)
+{
+    // Lengths are written with eight significant digits
+    return (qAbs(value1 - value2) <= 1E-6 * qMax(1.0, qMax(qAbs(value1), qAbs(value2))));
+}
+
+bool BenchRoundTrip::fuzzyEqual(const QPointF& point1, const QPointF& point2)
+{
+    return (fuzzyEqual(point1.x(), point2.x()) && fuzzyEqual(point1.y(), point2.y()));
+}
+
+bool BenchRoundTrip::fuzzyEqual(const QColor& color1, const QColor& color2)
+{
+    // Opacity is written as a percentage with two decimals, so allow one step of rounding in each channel
+    return (qAbs(color1.red() - color2.red()) <= 1 && qAbs(color1.green() - color2.green()) <= 1 &&
+            qAbs(color1.blue() - color2.blue()) <= 1 && qAbs(color1.alpha() - color2.alpha()) <= 1);
+}
@@ -0,0 +1,100 @@
+// File: BenchRoundTrip.h
+// Copyright (C) 2023  Jason Allen
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef BENCHROUNDTRIP_H
+#define BENCHROUNDTRIP_H
+
+#include <QBrush>
+#include <QFont>
+#include <QList>
+#include <QPen>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include <QTransform>
+#include <QVariant>
+#include "OdgGlobal.h"
+#include "OdgMarker.h"
+
+class OdgDrawing;
+class OdgItem;
+class OdgPage;
+class OdgPathItem;
+class OdgStyle;
+
+// Property-based round trip of OdgWriter and OdgReader: each case generates a random drawing covering every item
+// type, writes it, reads it back and compares the two structurally, accumulating the read and write throughput.
+class BenchRoundTrip
+{
+private:
+    int mMaximumItems;
+    int mMaximumGroupDepth;
+    QString mOutputDirectory;
+
+    int mCaseCount;
+    int mFailureCount;
+    qint64 mBytes;
+    qint64 mWriteTime;
+    qint64 mReadTime;
+
+    QList<OdgPathItem*> mPathTemplates;
+    QTextStream mOut;
+
+public:
+    BenchRoundTrip();
+    ~BenchRoundTrip();
+
+    void setMaximumItems(int count);
+    void setMaximumGroupDepth(int depth);
+    void setOutputDirectory(const QString& path);
+    int maximumItems() const;
+    int maximumGroupDepth() const;
+    QString outputDirectory() const;
+
+    bool run(quint32 seed);
+    void printSummary();
+
+    int caseCount() const;
+    int failureCount() const;
+
+private:
+    // Drawing generation
+    void createDrawing(QRandomGenerator& random, OdgDrawing& drawing, OdgStyle*& style) const;
+    OdgItem* createItem(QRandomGenerator& random, const QRectF& rect, double scale, int depth) const;
+    void setItemTransform(QRandomGenerator& random, OdgItem* item, const QRectF& rect, bool canFlip) const;
+
+    QColor randomColor(QRandomGenerator& random) const;
+    QPen randomPen(QRandomGenerator& random, double scale) const;
+    QBrush randomBrush(QRandomGenerator& random) const;
+    OdgMarker randomMarker(QRandomGenerator& random, double scale) const;
+    QFont randomFont(QRandomGenerator& random, double scale) const;
+    Qt::Alignment randomAlignment(QRandomGenerator& random) const;
+    QString randomCaption(QRandomGenerator& random) const;
+    QPointF randomPoint(QRandomGenerator& random, const QRectF& rect) const;
+
+    // Structural comparison
+    bool compareDrawings(OdgDrawing& expected, OdgStyle* expectedStyle, OdgDrawing& actual, OdgStyle* actualStyle,
+                         QString& message) const;
+    bool compareItems(OdgItem* expected, const QTransform& expectedParentTransform, OdgItem* actual,
+                      const QTransform& actualParentTransform, const QString& path, QString& message) const;
+    bool compareValues(const QVariant& expected, const QVariant& actual) const;
+    bool compareTransforms(const QTransform& expected, const QTransform& actual) const;
+
+    static bool fuzzyEqual(double value1, double value2);
+    static bool fuzzyEqual(const QPointF& point1, const QPointF& point2);
+    static bool fuzzyEqual(const QColor& color1, const QColor& color2);
+};
+
+#endif
@@ -0,0 +1,113 @@
+// File: BenchRunner.cpp
+// Copyright (C) 2023  Jason Allen
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "BenchRunner.h"
+#include "BenchAllocations.h"
+#include <QElapsedTimer>
+
+BenchRunner::BenchRunner() :
+    mMinimumIterations(5), mMinimumTime(500), mResults(), mOut(stdout)
+{
+    // Nothing more to do here.
+}
+
+//======================================================================================================================
+
+void BenchRunner::setMinimumIterations(int iterations)
+{
+    mMinimumIterations = qMax(iterations, 1);
+}
+
+void BenchRunner::setMinimumTime(double milliseconds)
+{
+    mMinimumTime = qMax(milliseconds, 0.0);
+}
+
+int BenchRunner::minimumIterations() const
+{
+    return mMinimumIterations;
+}
+
+double BenchRunner::minimumTime() const
+{
+    return mMinimumTime;
+}
+
+//======================================================================================================================
+
+BenchRunner::Result BenchRunner::measure(const QString& name, double unitsPerIteration, const QString& unitName,
+                                         const std::function<void()>& function, const std::function<void()>& reset)
+{
+    // One untimed warm-up pass so that caches, glyph atlases and lazily-built structures don't skew the first sample
+    function();
+    if (reset) reset();
+
+    // Run until both the minimum iteration count and the minimum total time have been reached.  The reset step,
+    // if any, restores the initial state between iterations and is excluded from both the timing and the
+    // allocation count.
+    QElapsedTimer timer;
+    qint64 elapsedNanoseconds = 0;
+    quint64 allocations = 0;
+    int iterations = 0;
+
+    while (iterations < mMinimumIterations || elapsedNanoseconds < mMinimumTime * 1E6)
+    {
+        const quint64 allocationsBefore = benchAllocationCount();
+        timer.start();
+        function();
+        elapsedNanoseconds += timer.nsecsElapsed();
+        allocations += benchAllocationCount() - allocationsBefore;
+        iterations++;
+
+        if (reset) reset();
+    }
+
+    Result result;
+    result.name = name;
+    result.iterations = iterations;
+    result.millisecondsPerIteration = elapsedNanoseconds / 1E6 / iterations;
+    result.throughput = (result.millisecondsPerIteration > 0) ?
+                            unitsPerIteration / (result.millisecondsPerIteration / 1000) : 0;
+    result.throughputUnit = unitName;
+    result.allocationsPerIteration = static_cast<double>(allocations) / iterations;
+    mResults.append(result);
+
+    mOut << QString("%1 %2 %3 %4 %5").arg(name, -28)
+                                     .arg(iterations, 8)
+                                     .arg(result.millisecondsPerIteration, 12, 'f', 3)
+                                     .arg(QString::number(result.throughput, 'f', 1) + " " + unitName + "/s", 24)
+                                     .arg(result.allocationsPerIteration, 14, 'f', 1) << Qt::endl;
+
+    return result;
+}
+
+//======================================================================================================================
+
+void BenchRunner::printHeader()
+{
+    mOut << QString("%1 %2 %3 %4 %5").arg("benchmark", -28).arg("iters", 8).arg("ms/iter", 12)
+                                     .arg("throughput", 24).arg("allocs/iter", 14) << Qt::endl;
+}
+
+void BenchRunner::printNote(const QString& note)
+{
+    mOut << "# " << note << Qt::endl;
+}
+
+QList<BenchRunner::Result> BenchRunner::results() const
+{
+    return mResults;
+}
@@ -0,0 +1,60 @@
+// File: BenchRunner.h
+// Copyright (C) 2023  Jason Allen
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef BENCHRUNNER_H
+#define BENCHRUNNER_H
+
+#include <QList>
+#include <QString>
+#include <QTextStream>
+#include <functional>
+
+class BenchRunner
+{
+public:
+    struct Result
+    {
+        QString name;
+        int iterations;
+        double millisecondsPerIteration;
+        double throughput;
+        QString throughputUnit;
+        double allocationsPerIteration;
+    };
+
+private:
+    int mMinimumIterations;
+    double mMinimumTime;
+    QList<Result> mResults;
+    QTextStream mOut;
+
+public:
+    BenchRunner();
+
+    void setMinimumIterations(int iterations);
+    void setMinimumTime(double milliseconds);
+    int minimumIterations() const;
+    double minimumTime() const;
+
+    Result measure(const QString& name, double unitsPerIteration, const QString& unitName,
+                   const std::function<void()>& function, const std::function<void()>& reset = nullptr);
+
+    void printHeader();
+    void printNote(const QString& note);
+    QList<Result> results() const;
+};
+
+#endif
@@ -0,0 +1,315 @@
+// File: BenchScalability.cpp
+// Copyright (C) 2023  Jason Allen
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "BenchScalability.h"
+#include "BenchGenerator.h"
+#include "DrawingWidget.h"
+#include "OdgItem.h"
+#include "OdgPage.h"
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QImage>
+#include <QMouseEvent>
+#include <QtMath>
+#include <algorithm>
+
+BenchScalability::BenchScalability() :
+    mSizes({1000, 10000, 100000}), mRepeats(3), mMaximumExponent(0), mResults(), mOut(stdout)
+{
+    // Nothing more to do here.
+}
+
+//======================================================================================================================
+
+void BenchScalability::setSizes(const QList<int>& sizes)
+{
+    mSizes.clear();
+    for(auto& size : sizes)
+    {
+        if (size > 0) mSizes.append(size);
+    }
+    std::sort(mSizes.begin(), mSizes.end());
+}
+
+void BenchScalability::setRepeats(int repeats)
+{
+    mRepeats = qMax(repeats, 1);
+}
+
+void BenchScalability::setMaximumExponent(double exponent)
+{
+    mMaximumExponent = qMax(exponent, 0.0);
+}
+
+QList<int> BenchScalability::sizes() const
+{
+    return mSizes;
+}
+
+int BenchScalability::repeats() const
+{
+    return mRepeats;
+}
+
+double BenchScalability::maximumExponent() const
+{
+    return mMaximumExponent;
+}
+
+//======================================================================================================================
+
+bool BenchScalability::run(DrawingWidget* drawing, BenchGenerator* generator, const QString& fileName)
+{
+    if (!drawing || !generator || mSizes.isEmpty()) return false;
+
+    mResults.clear();
+    generator->setPageCount(1);
+
+    for(int sizeIndex = 0; sizeIndex < mSizes.size(); sizeIndex++)
+    {
+        mOut << "# " << mSizes.at(sizeIndex) << " items" << Qt::endl;
+
+        // Start each size from a fresh drawing with an empty undo stack
+        drawing->clear();
+        generator->setItemsPerPage(mSizes.at(sizeIndex));
+        const QList<OdgPage*> pages = generator->createPages(drawing);
+        for(auto& page : pages)
+            drawing->addPage(page);
+        drawing->setCurrentPageIndex(0);
+        drawing->zoomFit();
+
+        // File round trip.  Loading replaces the generated page, so everything after this works on loaded items.
+        addTime("save", sizeIndex, measure([&]() { drawing->save(fileName); }));
+        if (!QFile::exists(fileName)) return false;
+        addTime("load", sizeIndex, measure([&]() { drawing->load(fileName); }));
+        drawing->setCurrentPageIndex(0);
+
+        addTime("zoomFit", sizeIndex, measure([&]() { drawing->zoomFit(); }));
+
+        QImage image(drawing->viewport()->size(), QImage::Format_ARGB32_Premultiplied);
+        addTime("paint", sizeIndex, measure([&]() { drawing->viewport()->render(&image); }));
+
+        // Selection and clipboard.  Paste only enters place mode, so a click at the center of the view completes it.
+        addTime("selectAll", sizeIndex, measure([&]() { drawing->selectAll(); }, [&]() { drawing->selectNone(); }));
+
+        drawing->selectAll();
+        addTime("copy", sizeIndex, measure([&]() { drawing->copy(); }));
+
+        const QPoint center = drawing->viewport()->rect().center();
+        addTime("paste", sizeIndex, measure([&]() {
+            drawing->paste();
+            sendMouseEvent(drawing, QEvent::MouseButtonPress, center, Qt::LeftButton);
+            sendMouseEvent(drawing, QEvent::MouseButtonRelease, center, Qt::NoButton);
+        }, [&]() {
+            drawing->setSelectMode();
+            drawing->undo();
+        }));
+
+        drawing->selectAll();
+        addTime("group", sizeIndex, measure([&]() { drawing->group(); }, [&]() {
+            drawing->undo();
+            drawing->selectAll();
+        }));
+
+        // Drag the whole selection by the mouse, from a point over one of the selected items
+        drawing->selectAll();
+        QPoint pressPosition;
+        bool pressPositionFound = false;
+        const QList<OdgItem*> items = drawing->currentPage()->items();
+        for(auto& item : items)
+        {
+            const QPointF position = item->mapToScene(item->boundingRect().center());
+            if (drawing->itemAt(position) && drawing->viewport()->rect().contains(drawing->mapFromScene(position)))
+            {
+                pressPosition = drawing->mapFromScene(position);
+                pressPositionFound = true;
+                break;
+            }
+        }
+
+        if (pressPositionFound)
+        {
+            addTime("move drag", sizeIndex, measure([&]() {
+                sendMouseEvent(drawing, QEvent::MouseButtonPress, pressPosition, Qt::LeftButton);
+                for(int step = 1; step <= 10; step++)
+                {
+                    sendMouseEvent(drawing, QEvent::MouseMove, pressPosition + QPoint(10 * step, 5 * step),
+                                   Qt::LeftButton);
+                }
+                sendMouseEvent(drawing, QEvent::MouseButtonRelease, pressPosition + QPoint(100, 50), Qt::NoButton);
+            }, [&]() {
+                drawing->undo();
+                drawing->selectAll();
+            }));
+        }
+    }
+
+    drawing->clear();
+
+    for(auto& result : mResults)
+        result.exponent = fitExponent(mSizes, result.milliseconds);
+
+    return true;
+}
+
+//======================================================================================================================
+
+void BenchScalability::printReport()
+{
+    mOut << report();
+    mOut.flush();
+}
+
+bool BenchScalability::writeReport(const QString& fileName) const
+{
+    QFile file(fileName);
+    if (!file.open(QFile::WriteOnly | QFile::Text | QFile::Truncate)) return false;
+
+    QTextStream stream(&file);
+    stream << report();
+    return true;
+}
+
+QList<BenchScalability::Result> BenchScalability::results() const
+{
+    return mResults;
+}
+
+int BenchScalability::regressionCount() const
+{
+    int count = 0;
+    for(auto& result : mResults)
+    {
+        if (isRegression(result)) count++;
+    }
+    return count;
+}
+
+//======================================================================================================================
+
+double BenchScalability::measure(const std::function<void()>& function, const std::function<void()>& reset) const
+{
+    // Best of several runs; each run is followed by the reset step, if any, so that every run starts from the same
+    // state.  A single run at the largest size can take seconds, so there is no untimed warm-up.
+    QElapsedTimer timer;
+    qint64 bestNanoseconds = -1;
+
+    for(int i = 0; i < mRepeats; i++)
+    {
+        timer.start();
+        function();
+        const qint64 elapsedNanoseconds = timer.nsecsElapsed();
+        if (bestNanoseconds < 0 || elapsedNanoseconds < bestNanoseconds) bestNanoseconds = elapsedNanoseconds;
+
+        if (reset) reset();
+    }
+
+    return bestNanoseconds / 1E6;
+}
+
+void BenchScalability::addTime(const QString& name, int sizeIndex, double milliseconds)
+{
+    Result* result = nullptr;
+    for(auto& existingResult : mResults)
+    {
+        if (existingResult.name == name) result = &existingResult;
+    }
+
+    if (!result)
+    {
+        Result newResult;
+        newResult.name = name;
+        newResult.exponent = 0;
+        for(int i = 0; i < mSizes.size(); i++) newResult.milliseconds.append(-1);
+        mResults.append(newResult);
+        result = &mResults.last();
+    }
+
+    result->milliseconds[sizeIndex] = milliseconds;
+    mOut << QString("%1 %2 ms").arg(name, -28).arg(milliseconds, 12, 'f', 3) << Qt::endl;
+}
+
+void BenchScalability::sendMouseEvent(DrawingWidget* drawing, QEvent::Type type, const QPoint& position,
+                                      Qt::MouseButtons buttons) const
+{
+    QWidget* viewport = drawing->viewport();
+    const Qt::MouseButton button = (type == QEvent::MouseMove) ? Qt::NoButton : Qt::LeftButton;
+
+    QMouseEvent event(type, position, viewport->mapToGlobal(position), button, buttons, Qt::NoModifier);
+    QApplication::sendEvent(viewport, &event);
+}
+
+//======================================================================================================================
+
+QString BenchScalability::report() const
+{
+    QString text;
+    QTextStream stream(&text);
+
+    stream << QString("%1").arg("operation", -28);
+    for(auto& size : mSizes)
+        stream << QString(" %1").arg(QString::number(size) + " items", 14);
+    stream << QString(" %1").arg("exponent", 10) << Qt::endl;
+
+    for(auto& result : mResults)
+    {
+        stream << QString("%1").arg(result.name, -28);
+        for(auto& milliseconds : result.milliseconds)
+        {
+            stream << QString(" %1").arg((milliseconds >= 0) ? QString::number(milliseconds, 'f', 3) + " ms" : "-",
+                                         14);
+        }
+        stream << QString(" %1").arg(result.exponent, 10, 'f', 2);
+        if (isRegression(result)) stream << "  exceeds " << QString::number(mMaximumExponent, 'f', 2);
+        stream << Qt::endl;
+    }
+
+    stream << "# exponent is the least-squares slope of log(time) against log(items): about 1 for linear "
+              "operations, 2 for quadratic ones" << Qt::endl;
+    return text;
+}
+
+bool BenchScalability::isRegression(const Result& result) const
+{
+    return (mMaximumExponent > 0 && result.exponent > mMaximumExponent);
+}
+
+//======================================================================================================================
+
+double BenchScalability::fitExponent(const QList<int>& sizes, const QList<double>& milliseconds)
+{
+    // Least-squares fit of log(time) = exponent * log(size) + c over the sizes that have a usable time
+    double sumX = 0, sumY = 0, sumXX = 0, sumXY = 0;
+    int count = 0;
+
+    for(int i = 0; i < sizes.size() && i < milliseconds.size(); i++)
+    {
+        if (milliseconds.at(i) > 0)
+        {
+            const double x = qLn(sizes.at(i));
+            const double y = qLn(milliseconds.at(i));
+            sumX += x;
+            sumY += y;
+            sumXX += x * x;
+            sumXY += x * y;
+            count++;
+        }
+    }
+
+    const double denominator = count * sumXX - sumX * sumX;
+    return (count >= 2 && denominator > 0) ? (count * sumXY - sumX * sumY) / denominator : 0;
+}
@@ -0,0 +1,78 @@
+// File: BenchScalability.h
+// Copyright (C) 2023  Jason Allen
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef BENCHSCALABILITY_H
+#define BENCHSCALABILITY_H
+
+#include <QEvent>
+#include <QList>
+#include <QPoint>
+#include <QString>
+#include <QTextStream>
+#include <functional>
+
+class BenchGenerator;
+class DrawingWidget;
+
+// Times the editor's whole-drawing operations on generated drawings of increasing size and fits each operation's
+// growth exponent, so that accidentally quadratic behavior shows up as a change in slope rather than just in time.
+class BenchScalability
+{
+public:
+    struct Result
+    {
+        QString name;
+        QList<double> milliseconds;
+        double exponent;
+    };
+
+private:
+    QList<int> mSizes;
+    int mRepeats;
+    double mMaximumExponent;
+    QList<Result> mResults;
+    QTextStream mOut;
+
+public:
+    BenchScalability();
+
+    void setSizes(const QList<int>& sizes);
+    void setRepeats(int repeats);
+    void setMaximumExponent(double exponent);
+    QList<int> sizes() const;
+    int repeats() const;
+    double maximumExponent() const;
+
+    bool run(DrawingWidget* drawing, BenchGenerator* generator, const QString& fileName);
+
+    void printReport();
+    bool writeReport(const QString& fileName) const;
+    QList<Result> results() const;
+    int regressionCount() const;
+
+private:
+    double measure(const std::function<void()>& function, const std::function<void()>& reset = nullptr) const;
+    void addTime(const QString& name, int sizeIndex, double milliseconds);
+    void sendMouseEvent(DrawingWidget* drawing, QEvent::Type type, const QPoint& position,
+                        Qt::MouseButtons buttons) const;
+
+    QString report() const;
+    bool isRegression(const Result& result) const;
+
+    static double fitExponent(const QList<int>& sizes, const QList<double>& milliseconds);
+};
+
+#endif
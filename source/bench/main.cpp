@@ -0,0 +1,643 @@
+// File: main.cpp
+// Copyright (C) 2023  Jason Allen
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QPainter>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include "BenchGenerator.h"
+#include "BenchRenderCheck.h"
+#include "BenchRoundTrip.h"
+#include "BenchRunner.h"
+#include "BenchScalability.h"
+#include "CliExporter.h"
+#include "DrawingMimeData.h"
+#include "DrawingProfiler.h"
+#include "DrawingUndo.h"
+#include "DrawingWidget.h"
+#include "OdgControlPoint.h"
+#include "OdgGluePoint.h"
+#include "OdgCurveItem.h"
+#include "OdgItem.h"
+#include "OdgLineItem.h"
+#include "OdgPage.h"
+#include "OdgPathItem.h"
+#include "OdgPolygonItem.h"
+#include "OdgPolylineItem.h"
+#include "OdgReader.h"
+#include "OdgTextEllipseItem.h"
+#include "OdgTextItem.h"
+#include "OdgTextRoundedRectItem.h"
+#include "SvgWriter.h"
+#include "version.h"
+
+// The dynamic_cast chain the writers used to find each item's type, kept as the baseline for the dispatch benchmark.
+// Derived classes are checked before their base classes.
+static OdgItem::Type dynamicCastItemType(OdgItem* item)
+{
+    if (dynamic_cast<OdgLineItem*>(item)) return OdgItem::LineType;
+    if (dynamic_cast<OdgCurveItem*>(item)) return OdgItem::CurveType;
+    if (dynamic_cast<OdgPolylineItem*>(item)) return OdgItem::PolylineType;
+    if (dynamic_cast<OdgTextItem*>(item)) return OdgItem::TextType;
+    if (dynamic_cast<OdgTextRoundedRectItem*>(item)) return OdgItem::TextRoundedRectType;
+    if (dynamic_cast<OdgRoundedRectItem*>(item)) return OdgItem::RoundedRectType;
+    if (dynamic_cast<OdgTextEllipseItem*>(item)) return OdgItem::TextEllipseType;
+    if (dynamic_cast<OdgEllipseItem*>(item)) return OdgItem::EllipseType;
+    if (dynamic_cast<OdgPathItem*>(item)) return OdgItem::PathType;
+    if (dynamic_cast<OdgRectItem*>(item)) return OdgItem::RectType;
+    if (dynamic_cast<OdgPolygonItem*>(item)) return OdgItem::PolygonType;
+    return OdgItem::GroupType;
+}
+
+// Compares items restored by an undo with copies of the originals; returns a description of the first difference.
+// Lengths go through the ODF format with eight significant digits, so they are compared with the same tolerance as
+// the round trip check.
+static QString compareRestoredItems(const QList<OdgItem*>& expected, const QList<OdgItem*>& actual)
+{
+    auto fuzzyEqual = [](double value1, double value2) {
+        return (qAbs(value1 - value2) <= 1E-6 * qMax(1.0, qMax(qAbs(value1), qAbs(value2))));
+    };
+
+    if (expected.size() != actual.size())
+        return QString("%1 items restored instead of %2").arg(actual.size()).arg(expected.size());
+
+    for(int i = 0; i < expected.size(); i++)
+    {
+        OdgItem* expectedItem = expected.at(i);
+        OdgItem* actualItem = actual.at(i);
+        const QString itemText = QString("item %1: ").arg(i);
+
+        if (expectedItem->type() != actualItem->type()) return itemText + "type differs";
+        if (expectedItem->rotation() != actualItem->rotation() || expectedItem->isFlipped() != actualItem->isFlipped())
+            return itemText + "rotation or flip differs";
+        if (expectedItem->type() == OdgItem::PathType &&
+            static_cast<OdgPathItem*>(expectedItem)->pathName() != static_cast<OdgPathItem*>(actualItem)->pathName())
+        {
+            return itemText + "path name differs";
+        }
+
+        const QRectF expectedRect = expectedItem->mapToScene(expectedItem->boundingRect());
+        const QRectF actualRect = actualItem->mapToScene(actualItem->boundingRect());
+        if (!fuzzyEqual(expectedRect.left(), actualRect.left()) || !fuzzyEqual(expectedRect.top(), actualRect.top()) ||
+            !fuzzyEqual(expectedRect.right(), actualRect.right()) ||
+            !fuzzyEqual(expectedRect.bottom(), actualRect.bottom()))
+        {
+            return itemText + "position or size differs";
+        }
+    }
+
+    return QString();
+}
+
+int main(int argc, char* argv[])
+{
+    // Benchmark without a display unless the caller asked for a specific platform plugin
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    QApplication::setApplicationName("jade-bench");
+    QApplication::setApplicationVersion(PROJECT_VERSION);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Measure the time and allocations of Jade's core editing, painting and file "
+                                     "operations on a generated drawing.");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument("files", "Drawings (.odg) to use for --render-check instead of a generated one.",
+                                 "[files...]");
+
+    const QCommandLineOption pagesOption("pages", "Number of generated pages (default: 1).", "count", "1");
+    const QCommandLineOption itemsOption("items", "Number of items per page (default: 1000).", "count", "1000");
+    const QCommandLineOption mixOption("mix", "Relative weights of symbols, polylines and text items "
+                                       "(default: 60:30:10).", "path:polyline:text", "60:30:10");
+    const QCommandLineOption connectionsOption("connections", "Fraction of polylines glued between two symbols "
+                                               "(default: 0.5).", "fraction", "0.5");
+    const QCommandLineOption wiresOption("wires", "Wires glued to the symbol in the connection stress test "
+                                         "(default: 500).", "count", "500");
+    const QCommandLineOption seedOption("seed", "Random seed for the generated drawing (default: 1).", "seed", "1");
+    const QCommandLineOption iterationsOption("iterations", "Minimum iterations per benchmark (default: 5).",
+                                              "count", "5");
+    const QCommandLineOption minTimeOption("min-time", "Minimum measured time per benchmark in milliseconds "
+                                           "(default: 500).", "ms", "500");
+    const QCommandLineOption filterOption("filter", "Only run benchmarks whose name contains this text.", "text");
+    const QCommandLineOption traceOption("trace", "Record the drawing profiler while benchmarking and write a Chrome "
+                                         "trace to this file.", "file");
+    parser.addOption(pagesOption);
+    parser.addOption(itemsOption);
+    parser.addOption(mixOption);
+    parser.addOption(connectionsOption);
+    parser.addOption(wiresOption);
+    parser.addOption(seedOption);
+    parser.addOption(iterationsOption);
+    parser.addOption(minTimeOption);
+    parser.addOption(filterOption);
+    parser.addOption(traceOption);
+
+    const QCommandLineOption renderCheckOption("render-check", "Instead of benchmarking, render every page through "
+                                               "the reference and optimized paint paths and compare the images.");
+    const QCommandLineOption roundTripOption("roundtrip", "Instead of benchmarking, write and read back this many "
+                                             "random drawings and compare them; --seed is the first case's seed and "
+                                             "--items the most items per page.", "cases");
+    const QCommandLineOption outputOption("output", "Directory for --render-check failure images or --roundtrip "
+                                          "failing files (default: render-check or roundtrip).", "dir");
+    const QCommandLineOption toleranceOption("tolerance", "Largest per-channel difference --render-check accepts "
+                                             "(default: 0).", "value", "0");
+    const QCommandLineOption scalabilityOption("scalability", "Instead of benchmarking, time whole-drawing operations "
+                                               "at increasing drawing sizes and fit each one's growth exponent.");
+    const QCommandLineOption sizesOption("sizes", "Comma-separated item counts for --scalability "
+                                         "(default: 1000,10000,100000).", "counts", "1000,10000,100000");
+    const QCommandLineOption reportOption("report", "Also write the --scalability report to this file.", "file");
+    const QCommandLineOption maxExponentOption("max-exponent", "Fail --scalability if any operation's growth "
+                                               "exponent exceeds this value (default: no limit).", "value", "0");
+    parser.addOption(renderCheckOption);
+    parser.addOption(roundTripOption);
+    parser.addOption(scalabilityOption);
+    parser.addOption(sizesOption);
+    parser.addOption(reportOption);
+    parser.addOption(maxExponentOption);
+    parser.addOption(outputOption);
+    parser.addOption(toleranceOption);
+    parser.process(app);
+
+    QTextStream err(stderr);
+
+    // Configure the generator from the command-line options
+    BenchGenerator generator;
+    generator.setPageCount(parser.value(pagesOption).toInt());
+    generator.setItemsPerPage(parser.value(itemsOption).toInt());
+    generator.setConnectionDensity(parser.value(connectionsOption).toDouble());
+    generator.setSeed(parser.value(seedOption).toUInt());
+
+    const QStringList mix = parser.value(mixOption).split(':');
+    if (mix.size() != 3)
+    {
+        err << "jade-bench: --mix expects three weights separated by ':'" << Qt::endl;
+        return 1;
+    }
+    generator.setMix(mix.at(0).toInt(), mix.at(1).toInt(), mix.at(2).toInt());
+
+    const int wireCount = qMax(parser.value(wiresOption).toInt(), 1);
+    const QString filter = parser.value(filterOption);
+
+    BenchRunner runner;
+    runner.setMinimumIterations(parser.value(iterationsOption).toInt());
+    runner.setMinimumTime(parser.value(minTimeOption).toDouble());
+
+    const QString traceFileName = parser.value(traceOption);
+    if (!traceFileName.isEmpty()) DrawingProfiler::setEnabled(true);
+
+    auto shouldRun = [&filter](const QString& name) { return filter.isEmpty() || name.contains(filter); };
+
+    // Round trip check: needs no drawing widget, since OdgWriter and OdgReader work on the model directly
+    if (parser.isSet(roundTripOption))
+    {
+        BenchRoundTrip roundTrip;
+        roundTrip.setMaximumItems(parser.value(itemsOption).toInt());
+        if (parser.isSet(outputOption)) roundTrip.setOutputDirectory(parser.value(outputOption));
+
+        const int caseCount = parser.value(roundTripOption).toInt();
+        const quint32 seed = parser.value(seedOption).toUInt();
+        for(int i = 0; i < caseCount; i++)
+            roundTrip.run(seed + i);
+
+        roundTrip.printSummary();
+        return (roundTrip.failureCount() == 0) ? 0 : 1;
+    }
+
+    // Set up a drawing the same way the editor does for File > New, then replace its page with the generated ones
+    DrawingWidget drawing;
+    drawing.resize(1600, 1200);
+    drawing.createNew();
+    drawing.clear();
+    drawing.show();
+
+    // Render regression check: every page of each drawing, or of the generated drawing if none were given
+    if (parser.isSet(renderCheckOption))
+    {
+        BenchRenderCheck renderCheck;
+        if (parser.isSet(outputOption)) renderCheck.setOutputDirectory(parser.value(outputOption));
+        renderCheck.setTolerance(parser.value(toleranceOption).toInt());
+
+        QTemporaryDir tempDir;
+        QStringList fileNames = parser.positionalArguments();
+        if (fileNames.isEmpty())
+        {
+            const QList<OdgPage*> pages = generator.createPages(&drawing);
+            for(auto& page : pages)
+                drawing.addPage(page);
+
+            const QString fileName = tempDir.filePath("generated.odg");
+            if (!tempDir.isValid() || !drawing.save(fileName))
+            {
+                err << "jade-bench: unable to write " << fileName << Qt::endl;
+                return 1;
+            }
+            fileNames.append(fileName);
+        }
+
+        renderCheck.printHeader();
+        for(auto& fileName : qAsConst(fileNames))
+            renderCheck.checkFile(&drawing, fileName);
+
+        QTextStream(stdout) << QString("# %1 view(s) checked, %2 failure(s)").arg(renderCheck.viewCount())
+                                                                           .arg(renderCheck.failureCount())
+                            << Qt::endl;
+        return (renderCheck.failureCount() == 0) ? 0 : 1;
+    }
+
+    // Scalability report: the same operations at each size, then a fitted growth exponent per operation
+    if (parser.isSet(scalabilityOption))
+    {
+        QList<int> sizes;
+        const QStringList sizeTexts = parser.value(sizesOption).split(',');
+        for(auto& sizeText : sizeTexts)
+            sizes.append(sizeText.trimmed().toInt());
+
+        BenchScalability scalability;
+        scalability.setSizes(sizes);
+        scalability.setMaximumExponent(parser.value(maxExponentOption).toDouble());
+
+        QTemporaryDir tempDir;
+        if (!tempDir.isValid() || !scalability.run(&drawing, &generator, tempDir.filePath("scalability.odg")))
+        {
+            err << "jade-bench: unable to run the scalability report" << Qt::endl;
+            return 1;
+        }
+
+        scalability.printReport();
+        const QString reportFileName = parser.value(reportOption);
+        if (!reportFileName.isEmpty() && !scalability.writeReport(reportFileName))
+        {
+            err << "jade-bench: unable to write " << reportFileName << Qt::endl;
+            return 1;
+        }
+        return (scalability.regressionCount() == 0) ? 0 : 1;
+    }
+
+    const int itemCount = generator.pageCount() * generator.itemsPerPage();
+    runner.printNote(QString("%1 page(s) x %2 items, mix %3:%4:%5, connection density %6, seed %7")
+                         .arg(generator.pageCount()).arg(generator.itemsPerPage())
+                         .arg(generator.pathWeight()).arg(generator.polylineWeight()).arg(generator.textWeight())
+                         .arg(generator.connectionDensity()).arg(generator.seed()));
+    runner.printHeader();
+
+    if (shouldRun("generate"))
+    {
+        runner.measure("generate", itemCount, "items", [&]() {
+            const QList<OdgPage*> pages = generator.createPages(&drawing);
+            qDeleteAll(pages);
+        });
+    }
+
+    const QList<OdgPage*> pages = generator.createPages(&drawing);
+    for(auto& page : pages)
+        drawing.addPage(page);
+    drawing.setCurrentPageIndex(0);
+    drawing.zoomFit();
+
+    // Estimated memory usage of the generated drawing, by category
+    const OdgMemoryUsage memoryUsage = drawing.memoryUsage();
+    const QList<OdgMemoryUsage::Category> memoryCategories = memoryUsage.categories();
+    for(auto& category : memoryCategories)
+    {
+        runner.printNote(QString("memory: %1 x %2: %3").arg(category.name).arg(category.count)
+                             .arg(OdgMemoryUsage::formatBytes(category.bytes)));
+    }
+    runner.printNote("memory: total " + OdgMemoryUsage::formatBytes(memoryUsage.totalBytes()));
+
+    OdgPage* page = drawing.currentPage();
+    const QList<OdgItem*> pageItems = page->items();
+    const QRectF contentRect = drawing.contentRect();
+
+    // Painting: the export path into an image covering the page, then the full widget paint event
+    if (shouldRun("paint"))
+    {
+        QImage image(1600, 1200, QImage::Format_ARGB32_Premultiplied);
+        const QRectF pageRect = drawing.pageRect();
+        const double scale = qMin(image.width() / pageRect.width(), image.height() / pageRect.height());
+
+        runner.measure("paint/export", pageItems.size(), "items", [&]() {
+            image.fill(Qt::transparent);
+            QPainter painter(&image);
+            painter.setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing);
+            painter.scale(scale, scale);
+            painter.translate(-pageRect.topLeft());
+            drawing.paint(painter, true);
+        });
+    }
+
+    if (shouldRun("paint"))
+    {
+        QImage image(drawing.viewport()->size(), QImage::Format_ARGB32_Premultiplied);
+        runner.measure("paint/viewport", pageItems.size(), "items", [&]() {
+            drawing.viewport()->render(&image);
+        });
+    }
+
+    // Hit testing at random points and over random rectangles
+    if (shouldRun("itemAt"))
+    {
+        QRandomGenerator random(generator.seed());
+        QList<QPointF> points;
+        for(int i = 0; i < 1000; i++)
+        {
+            points.append(QPointF(contentRect.left() + random.generateDouble() * contentRect.width(),
+                                  contentRect.top() + random.generateDouble() * contentRect.height()));
+        }
+
+        runner.measure("itemAt", points.size(), "queries", [&]() {
+            for(auto& point : qAsConst(points)) drawing.itemAt(point);
+        });
+    }
+
+    if (shouldRun("items(rect)"))
+    {
+        QRandomGenerator random(generator.seed());
+        QList<QRectF> rects;
+        for(int i = 0; i < 100; i++)
+        {
+            rects.append(QRectF(contentRect.left() + random.generateDouble() * contentRect.width() * 0.9,
+                                contentRect.top() + random.generateDouble() * contentRect.height() * 0.9,
+                                contentRect.width() / 10, contentRect.height() / 10));
+        }
+
+        runner.measure("items(rect)", rects.size(), "queries", [&]() {
+            for(auto& rect : qAsConst(rects)) drawing.items(rect);
+        });
+    }
+
+    // Finding each item's type, as the ODG and SVG writers do for every item they serialize: the old dynamic_cast
+    // chain against the type() tag.  The save and svg benchmarks give the resulting serialization throughput.
+    if (shouldRun("dispatch"))
+    {
+        // Accumulating into a volatile keeps the compiler from discarding the loops
+        volatile int typeSum = 0;
+        runner.measure("dispatch/dynamic_cast", pageItems.size(), "items", [&]() {
+            for(auto& item : pageItems) typeSum += dynamicCastItemType(item);
+        });
+        runner.measure("dispatch/type", pageItems.size(), "items", [&]() {
+            for(auto& item : pageItems) typeSum += item->type();
+        });
+    }
+
+    // Copy and paste of the whole page: through the ODF XML that other applications receive, and through the item
+    // copies that pastes within the same process use
+    if (shouldRun("clipboard"))
+    {
+        runner.measure("clipboard/xml", pageItems.size(), "items", [&]() {
+            DrawingMimeData mimeData(&drawing, "bench", pageItems);
+            OdgReader reader;
+            reader.readFromString(mimeData.toXml());
+            qDeleteAll(reader.takePages());
+        });
+        runner.measure("clipboard/items", pageItems.size(), "items", [&]() {
+            DrawingMimeData mimeData(&drawing, "bench", pageItems);
+            qDeleteAll(OdgItem::copyItems(DrawingMimeData::fromMimeData(&mimeData)->items()));
+        });
+    }
+
+    // Gluing new wires to the page's symbols, as happens when items are placed or dropped
+    if (shouldRun("placeItems"))
+    {
+        QList<QPointF> gluePositions;
+        for(auto& item : pageItems)
+        {
+            const QList<OdgGluePoint*> gluePoints = item->gluePoints();
+            for(auto& gluePoint : gluePoints)
+                gluePositions.append(item->mapToScene(gluePoint->position()));
+            if (gluePositions.size() >= 200) break;
+        }
+
+        const QList<OdgItem*> wires = generator.createWires(&drawing, gluePositions);
+        runner.measure("placeItems", wires.size(), "wires",
+                       [&]() { drawing.placeItems(wires); },
+                       [&]() { drawing.unplaceItems(wires); });
+        qDeleteAll(wires);
+    }
+
+    // File round trip through a temporary file; load includes replacing the drawing's existing pages
+    QTemporaryDir tempDir;
+    const QString fileName = tempDir.filePath("bench.odg");
+
+    // SVG export of the current page with each output profile, and with the items serialized in parallel chunks;
+    // the notes compare the resulting file sizes
+    if (shouldRun("svg"))
+    {
+        struct SvgProfile { QString name; SvgWriter::Profile profile; bool compressed; QString suffix; int threads; };
+        const QList<SvgProfile> svgProfiles = {
+            { "standard", SvgWriter::StandardProfile, false, "svg", 1 },
+            { "compact", SvgWriter::CompactProfile, false, "svg", 1 },
+            { "svgz", SvgWriter::CompactProfile, true, "svgz", 1 },
+            { "parallel", SvgWriter::StandardProfile, false, "svg", 0 }
+        };
+
+        const QRectF pageRect = drawing.pageRect();
+        for(auto& svgProfile : svgProfiles)
+        {
+            const QString svgFileName = tempDir.filePath("bench-" + svgProfile.name + "." + svgProfile.suffix);
+            SvgWriter svg(pageRect, 1.0);
+            svg.setProfile(svgProfile.profile);
+            svg.setCompressed(svgProfile.compressed);
+            svg.setThreadCount(svgProfile.threads);
+            if (svgProfile.threads != 1) svg.setChunkSize(512);
+
+            if (!tempDir.isValid() || !svg.write(svgFileName, drawing.backgroundColor(), pageItems))
+            {
+                err << "jade-bench: unable to write " << svgFileName << Qt::endl;
+                return 1;
+            }
+
+            runner.printNote(QString("svg/%1 is %2 kB").arg(svgProfile.name)
+                                 .arg(QFileInfo(svgFileName).size() / 1E3, 0, 'f', 1));
+            runner.measure("svg/" + svgProfile.name, pageItems.size(), "items", [&]() {
+                svg.write(svgFileName, drawing.backgroundColor(), pageItems);
+            });
+        }
+
+        // Serializing in parallel must not change the output: write each profile with one thread and with several
+        // threads over small chunks, and compare the files byte for byte
+        for(auto& profile : { SvgWriter::StandardProfile, SvgWriter::CompactProfile })
+        {
+            QByteArray svgData[2];
+            for(int i = 0; i < 2; i++)
+            {
+                const QString svgFileName = tempDir.filePath(QString("bench-threads%1.svg").arg(i));
+                SvgWriter svg(pageRect, 1.0);
+                svg.setProfile(profile);
+                svg.setThreadCount((i == 0) ? 1 : 4);
+                svg.setChunkSize(qMax(pageItems.size() / 7, 1));
+
+                QFile svgFile(svgFileName);
+                if (!svg.write(svgFileName, drawing.backgroundColor(), pageItems) || !svgFile.open(QFile::ReadOnly))
+                {
+                    err << "jade-bench: unable to write " << svgFileName << Qt::endl;
+                    return 1;
+                }
+                svgData[i] = svgFile.readAll();
+            }
+
+            if (svgData[0] != svgData[1])
+            {
+                err << "jade-bench: svg: " << ((profile == SvgWriter::CompactProfile) ? "compact" : "standard")
+                    << " output written with 4 threads differs from the single-threaded output" << Qt::endl;
+                return 1;
+            }
+        }
+    }
+
+    if (shouldRun("save") || shouldRun("load"))
+    {
+        if (!tempDir.isValid() || !drawing.save(fileName))
+        {
+            err << "jade-bench: unable to write " << fileName << Qt::endl;
+            return 1;
+        }
+
+        const double megabytes = QFileInfo(fileName).size() / 1E6;
+        runner.printNote(QString("saved drawing is %1 MB").arg(megabytes, 0, 'f', 3));
+
+        if (shouldRun("save"))
+            runner.measure("save", megabytes, "MB", [&]() { drawing.save(fileName); });
+        if (shouldRun("load"))
+            runner.measure("load", megabytes, "MB", [&]() { drawing.load(fileName); });
+    }
+
+    // jade-cli output names: the same drawing saved as a/x.odg and b/x.odg and exported into one output directory
+    // must give two distinct sets of files rather than both writing x.svg
+    if (shouldRun("cli"))
+    {
+        const QString fileName1 = tempDir.filePath("a/x.odg"), fileName2 = tempDir.filePath("b/x.odg");
+        if (!tempDir.isValid() || !QDir().mkpath(tempDir.filePath("a")) || !QDir().mkpath(tempDir.filePath("b")) ||
+            !drawing.save(fileName1) || !drawing.save(fileName2))
+        {
+            err << "jade-bench: unable to write " << fileName1 << " and " << fileName2 << Qt::endl;
+            return 1;
+        }
+
+        CliExporter exporter;
+        exporter.setFormats(CliExporter::SvgFormat);
+        exporter.setOutputDirectory(tempDir.filePath("out"));
+        exporter.setFileNames(QStringList() << fileName1 << fileName2);
+
+        QStringList outputFiles1, outputFiles2, unchangedFiles;
+        QString errorMessage;
+        if (!QDir().mkpath(exporter.outputDirectory()) ||
+            !exporter.exportFile(fileName1, outputFiles1, unchangedFiles, errorMessage) ||
+            !exporter.exportFile(fileName2, outputFiles2, unchangedFiles, errorMessage))
+        {
+            err << "jade-bench: cli: " << errorMessage << Qt::endl;
+            return 1;
+        }
+
+        QStringList outputFiles = outputFiles1 + outputFiles2;
+        const int outputCount = outputFiles.size();
+        if (outputFiles1.isEmpty() || outputFiles.removeDuplicates() > 0 ||
+            outputCount != 2 * drawing.pages().size())
+        {
+            err << "jade-bench: cli: a/x.odg and b/x.odg were exported to overlapping files: "
+                << outputFiles1.join(", ") << " and " << outputFiles2.join(", ") << Qt::endl;
+            return 1;
+        }
+        runner.printNote("cli: a/x.odg and b/x.odg exported to " + QFileInfo(outputFiles1.first()).fileName() +
+                         " and " + QFileInfo(outputFiles2.first()).fileName());
+    }
+
+    // Connection maintenance: move one symbol with many wires glued to it
+    if (shouldRun("moveItems"))
+    {
+        OdgItem* hub = nullptr;
+        OdgPage* stressPage = generator.createConnectionStressPage(&drawing, wireCount, hub);
+        drawing.addPage(stressPage);
+        drawing.setCurrentPageIndex(drawing.pages().indexOf(stressPage));
+
+        const QList<OdgItem*> hubItems = QList<OdgItem*>() << hub;
+        const QPointF startPosition = hub->position();
+        const QPointF offset(4 * drawing.grid(), 4 * drawing.grid());
+        bool moved = false;
+
+        runner.measure("moveItems/connected", wireCount, "wires", [&]() {
+            QHash<OdgItem*,QPointF> positions;
+            positions.insert(hub, moved ? startPosition : startPosition + offset);
+            drawing.moveItems(hubItems, positions, false);
+            moved = !moved;
+        });
+
+        // Timing alone would not catch a regression in how the move propagates, so check that every wire is still
+        // glued to the hub and that its glued end sits exactly on the hub's glue point
+        int connectedCount = 0, misplacedCount = 0;
+        const QList<OdgGluePoint*> hubGluePoints = hub->gluePoints();
+        for(auto& gluePoint : hubGluePoints)
+        {
+            const QPointF gluePosition = hub->mapToScene(gluePoint->position());
+            const QList<OdgControlPoint*> connections = gluePoint->connections();
+            for(auto& controlPoint : connections)
+            {
+                connectedCount++;
+                const QPointF endPosition = controlPoint->item()->mapToScene(controlPoint->position());
+                if ((endPosition - gluePosition).manhattanLength() > 1E-9) misplacedCount++;
+            }
+        }
+
+        if (connectedCount != wireCount || misplacedCount > 0)
+        {
+            err << "jade-bench: moveItems/connected: " << connectedCount << " of " << wireCount << " wires glued to "
+                << "the hub, " << misplacedCount << " not on their glue point" << Qt::endl;
+            return 1;
+        }
+    }
+
+    // Undoing a removal whose items were spilled to disk, as happens once the undo history exceeds its memory budget.
+    // The restored items are new objects, so compare them with copies of the originals.  This replaces the first
+    // page's items, so it runs last.
+    if (shouldRun("undo"))
+    {
+        OdgPage* spillPage = drawing.pages().first();
+        drawing.setCurrentPage(spillPage);
+        const QList<OdgItem*> originalItems = OdgItem::copyItems(spillPage->items());
+
+        QString difference;
+        runner.measure("undo/spilled", originalItems.size(), "items", [&]() {
+            DrawingRemoveItemsCommand command(&drawing, spillPage, spillPage->items());
+            command.redo();
+            command.spill();
+            if (!command.isSpilled()) difference = "items were not spilled";
+            command.undo();
+            if (difference.isEmpty()) difference = compareRestoredItems(originalItems, spillPage->items());
+        });
+        qDeleteAll(originalItems);
+
+        if (!difference.isEmpty())
+        {
+            err << "jade-bench: undo/spilled: " << difference << Qt::endl;
+            return 1;
+        }
+    }
+
+    if (!traceFileName.isEmpty() && !DrawingProfiler::exportChromeTrace(traceFileName))
+    {
+        err << "jade-bench: unable to write " << traceFileName << Qt::endl;
+        return 1;
+    }
+
+    return 0;
+}
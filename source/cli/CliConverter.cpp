@@ -0,0 +1,158 @@
+// File: CliConverter.cpp
+// Copyright (C) 2023  Jason Allen
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "CliConverter.h"
+#include "OdgPage.h"
+#include "OdgReader.h"
+#include "OdgStyle.h"
+#include "OdgWriter.h"
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+
+CliConverter::CliConverter() : mOutputDirectory(), mOverwrite(true), mOutputNames()
+{
+    // Nothing more to do here.
+}
+
+//======================================================================================================================
+
+void CliConverter::setOutputDirectory(const QString& path)
+{
+    mOutputDirectory = path;
+    mOutputNames.setOutputDirectory(path);
+}
+
+void CliConverter::setOverwrite(bool overwrite)
+{
+    mOverwrite = overwrite;
+}
+
+void CliConverter::setFileNames(const QStringList& fileNames)
+{
+    // Drawings with the same name from different directories are given distinct output names
+    mOutputNames.setFileNames(fileNames);
+}
+
+QString CliConverter::outputDirectory() const
+{
+    return mOutputDirectory;
+}
+
+bool CliConverter::shouldOverwrite() const
+{
+    return mOverwrite;
+}
+
+QStringList CliConverter::fileNames() const
+{
+    return mOutputNames.fileNames();
+}
+
+//======================================================================================================================
+
+bool CliConverter::convertFile(const QString& fileName, Result& result, QString& errorMessage) const
+{
+    // This function only uses local state so that several files can be converted at once from different threads.
+    // Everything read from the file is released before returning, so memory use is bounded by the number of files
+    // being converted at once rather than by the number of files in the batch.
+    result.outputFile = outputPath(fileName);
+    result.parseTime = 0;
+    result.writeTime = 0;
+    result.pageCount = 0;
+    result.itemCount = 0;
+    result.skippedElements.clear();
+
+    if (QFileInfo(result.outputFile) == QFileInfo(fileName))
+    {
+        errorMessage = "Converting " + fileName + " would overwrite it.";
+        return false;
+    }
+    if (!mOverwrite && QFileInfo::exists(result.outputFile))
+    {
+        errorMessage = result.outputFile + " already exists.";
+        return false;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    OdgReader reader(fileName);
+    if (!reader.open())
+    {
+        errorMessage = "Error opening " + fileName + " for reading.";
+        return false;
+    }
+
+    if (!reader.read())
+    {
+        errorMessage = "Error reading " + fileName + ".  File is invalid.";
+        return false;
+    }
+    reader.close();
+
+    result.parseTime = timer.nsecsElapsed();
+    result.skippedElements = reader.skippedElements();
+
+    OdgStyle* defaultStyle = reader.takeDefaultStyle();
+    if (!defaultStyle) defaultStyle = new OdgStyle(reader.units(), true);
+    const QList<OdgPage*> pages = reader.takePages();
+
+    result.pageCount = pages.size();
+    for(auto& page : pages)
+        result.itemCount += page->items().size();
+
+    timer.restart();
+
+    bool success = false;
+    {
+        OdgWriter writer(result.outputFile);
+        if (writer.open())
+        {
+            writer.setUnits(reader.units());
+            writer.setPageSize(reader.pageSize());
+            writer.setPageMargins(reader.pageMargins());
+            writer.setBackgroundColor(reader.backgroundColor());
+            writer.setGrid(reader.grid());
+            writer.setGridStyle(reader.gridStyle());
+            writer.setGridColor(reader.gridColor());
+            writer.setGridSpacingMajor(reader.gridSpacingMajor());
+            writer.setGridSpacingMinor(reader.gridSpacingMinor());
+
+            writer.setDefaultStyle(defaultStyle);
+            writer.setPages(pages);
+
+            success = writer.write();
+            if (!success) errorMessage = "Error writing " + result.outputFile + ".";
+        }
+        else errorMessage = "Error opening " + result.outputFile + " for writing.";
+    }
+
+    result.writeTime = timer.nsecsElapsed();
+
+    qDeleteAll(pages);
+    delete defaultStyle;
+    return success;
+}
+
+//======================================================================================================================
+
+QString CliConverter::outputPath(const QString& fileName) const
+{
+    const QFileInfo fileInfo(fileName);
+    const QDir outputDir(mOutputDirectory.isEmpty() ? fileInfo.absolutePath() : mOutputDirectory);
+    return outputDir.absoluteFilePath(mOutputNames.baseName(fileName) + ".odg");
+}
@@ -0,0 +1,60 @@
+// File: CliConverter.h
+// Copyright (C) 2023  Jason Allen
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef CLICONVERTER_H
+#define CLICONVERTER_H
+
+#include <QMap>
+#include <QString>
+#include "CliOutputNames.h"
+
+// Normalizes ODG files written by other applications (i.e. LibreOffice Draw) into Jade-native ODG by reading them
+// with OdgReader and writing them back out with OdgWriter.
+class CliConverter
+{
+public:
+    struct Result
+    {
+        QString outputFile;
+        qint64 parseTime;
+        qint64 writeTime;
+        int pageCount;
+        int itemCount;
+        QMap<QString,int> skippedElements;
+    };
+
+private:
+    QString mOutputDirectory;
+    bool mOverwrite;
+    CliOutputNames mOutputNames;
+
+public:
+    CliConverter();
+
+    void setOutputDirectory(const QString& path);
+    void setOverwrite(bool overwrite);
+    void setFileNames(const QStringList& fileNames);
+    QString outputDirectory() const;
+    bool shouldOverwrite() const;
+    QStringList fileNames() const;
+
+    bool convertFile(const QString& fileName, Result& result, QString& errorMessage) const;
+
+private:
+    QString outputPath(const QString& fileName) const;
+};
+
+#endif
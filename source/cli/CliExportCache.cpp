@@ -0,0 +1,104 @@
+// File: CliExportCache.cpp
+// Copyright (C) 2023  Jason Allen
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "CliExportCache.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QTextStream>
+
+CliExportCache::CliExportCache(const QString& fileName) : mFileName(fileName), mKeys(), mMutex()
+{
+    // Nothing more to do here.
+}
+
+//======================================================================================================================
+
+void CliExportCache::setFileName(const QString& fileName)
+{
+    QMutexLocker locker(&mMutex);
+    mFileName = fileName;
+}
+
+QString CliExportCache::fileName() const
+{
+    QMutexLocker locker(&mMutex);
+    return mFileName;
+}
+
+//======================================================================================================================
+
+bool CliExportCache::load()
+{
+    QMutexLocker locker(&mMutex);
+    mKeys.clear();
+
+    // A missing cache file just means that everything is exported the first time
+    QFile cacheFile(mFileName);
+    if (mFileName.isEmpty() || !cacheFile.exists()) return true;
+    if (!cacheFile.open(QFile::ReadOnly | QFile::Text)) return false;
+
+    // Each line holds a key and the absolute path of the file exported from it, separated by a tab
+    QTextStream in(&cacheFile);
+    QString line;
+    while (in.readLineInto(&line))
+    {
+        const int tabIndex = line.indexOf('\t');
+        if (tabIndex > 0) mKeys.insert(line.mid(tabIndex + 1), line.left(tabIndex).toLatin1());
+    }
+
+    return true;
+}
+
+bool CliExportCache::save() const
+{
+    QMutexLocker locker(&mMutex);
+    if (mFileName.isEmpty()) return true;
+
+    QSaveFile cacheFile(mFileName);
+    if (!cacheFile.open(QFile::WriteOnly | QFile::Text)) return false;
+
+    QTextStream out(&cacheFile);
+    for(auto keyIter = mKeys.cbegin(); keyIter != mKeys.cend(); keyIter++)
+        out << keyIter.value() << '\t' << keyIter.key() << '\n';
+    out.flush();
+
+    return cacheFile.commit();
+}
+
+//======================================================================================================================
+
+bool CliExportCache::isCurrent(const QString& outputPath, const QByteArray& key) const
+{
+    // An output file that was deleted since it was exported has to be written again
+    const QFileInfo outputInfo(outputPath);
+    QMutexLocker locker(&mMutex);
+    return (mKeys.value(outputInfo.absoluteFilePath()) == key && outputInfo.exists());
+}
+
+void CliExportCache::update(const QString& outputPath, const QByteArray& key)
+{
+    const QString absolutePath = QFileInfo(outputPath).absoluteFilePath();
+    QMutexLocker locker(&mMutex);
+    mKeys.insert(absolutePath, key);
+}
+
+void CliExportCache::remove(const QString& outputPath)
+{
+    const QString absolutePath = QFileInfo(outputPath).absoluteFilePath();
+    QMutexLocker locker(&mMutex);
+    mKeys.remove(absolutePath);
+}
@@ -0,0 +1,48 @@
+// File: CliExportCache.h
+// Copyright (C) 2023  Jason Allen
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef CLIEXPORTCACHE_H
+#define CLIEXPORTCACHE_H
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+// Remembers the content key each output file was last exported from, so that pages whose content and export
+// settings haven't changed since can be skipped.  The keys can be saved to a file to carry them from one run to the
+// next.  All functions may be called from several threads at once.
+class CliExportCache
+{
+private:
+    QString mFileName;
+    QHash<QString,QByteArray> mKeys;
+    mutable QMutex mMutex;
+
+public:
+    CliExportCache(const QString& fileName = QString());
+
+    void setFileName(const QString& fileName);
+    QString fileName() const;
+
+    bool load();
+    bool save() const;
+
+    bool isCurrent(const QString& outputPath, const QByteArray& key) const;
+    void update(const QString& outputPath, const QByteArray& key);
+    void remove(const QString& outputPath);
+};
+
+#endif
@@ -0,0 +1,475 @@
+// File: CliExporter.cpp
+// Copyright (C) 2023  Jason Allen
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "CliExporter.h"
+#include "CliExportCache.h"
+#include "MultiScalePngWriter.h"
+#include "OdgDrawing.h"
+#include "OdgItem.h"
+#include "OdgPage.h"
+#include "OdgReader.h"
+#include "OdgStyle.h"
+#include "OdgWriter.h"
+#include "PdfWriter.h"
+#include "PngWriter.h"
+#include "SvgWriter.h"
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFileInfo>
+#include <QPainter>
+#include <QRegularExpression>
+#include <QSet>
+
+CliExporter::CliExporter() : mOutputDirectory(), mFormats(PngFormat), mPixelsPerInch(600), mScale(0),
+    mExportItemsOnly(false), mOverwrite(true), mPngScales(), mCompactSvg(false), mSvgPrecision(0), mCompressSvg(false),
+    mCache(nullptr), mOutputNames()
+{
+    // Nothing more to do here.
+}
+
+//======================================================================================================================
+
+void CliExporter::setOutputDirectory(const QString& path)
+{
+    mOutputDirectory = path;
+    mOutputNames.setOutputDirectory(path);
+}
+
+void CliExporter::setFormats(int formats)
+{
+    mFormats = formats;
+}
+
+void CliExporter::setPixelsPerInch(double pixelsPerInch)
+{
+    if (pixelsPerInch > 0) mPixelsPerInch = pixelsPerInch;
+}
+
+void CliExporter::setScale(double scale)
+{
+    mScale = qMax(scale, 0.0);
+}
+
+void CliExporter::setExportItemsOnly(bool itemsOnly)
+{
+    mExportItemsOnly = itemsOnly;
+}
+
+void CliExporter::setOverwrite(bool overwrite)
+{
+    mOverwrite = overwrite;
+}
+
+void CliExporter::setPngScales(const QList<double>& factors)
+{
+    mPngScales = factors;
+}
+
+void CliExporter::setCompactSvg(bool compact)
+{
+    mCompactSvg = compact;
+}
+
+void CliExporter::setSvgPrecision(int digits)
+{
+    mSvgPrecision = qMax(digits, 0);
+}
+
+void CliExporter::setCompressSvg(bool compress)
+{
+    mCompressSvg = compress;
+}
+
+void CliExporter::setCache(CliExportCache* cache)
+{
+    mCache = cache;
+}
+
+void CliExporter::setFileNames(const QStringList& fileNames)
+{
+    // Drawings with the same name from different directories are given distinct output names
+    mOutputNames.setFileNames(fileNames);
+}
+
+QString CliExporter::outputDirectory() const
+{
+    return mOutputDirectory;
+}
+
+int CliExporter::formats() const
+{
+    return mFormats;
+}
+
+double CliExporter::pixelsPerInch() const
+{
+    return mPixelsPerInch;
+}
+
+double CliExporter::scale() const
+{
+    return mScale;
+}
+
+bool CliExporter::shouldExportItemsOnly() const
+{
+    return mExportItemsOnly;
+}
+
+bool CliExporter::shouldOverwrite() const
+{
+    return mOverwrite;
+}
+
+QList<double> CliExporter::pngScales() const
+{
+    return mPngScales;
+}
+
+bool CliExporter::isCompactSvg() const
+{
+    return mCompactSvg;
+}
+
+int CliExporter::svgPrecision() const
+{
+    return mSvgPrecision;
+}
+
+bool CliExporter::shouldCompressSvg() const
+{
+    return mCompressSvg;
+}
+
+CliExportCache* CliExporter::cache() const
+{
+    return mCache;
+}
+
+QStringList CliExporter::fileNames() const
+{
+    return mOutputNames.fileNames();
+}
+
+//======================================================================================================================
+
+bool CliExporter::exportFile(const QString& fileName, QStringList& outputFiles, QStringList& unchangedFiles,
+                             QString& errorMessage) const
+{
+    // This function only uses local state so that several files can be exported at once from different threads
+    OdgReader reader(fileName);
+    if (!reader.open())
+    {
+        errorMessage = "Error opening " + fileName + " for reading.";
+        return false;
+    }
+
+    if (!reader.read())
+    {
+        errorMessage = "Error reading " + fileName + ".  File is invalid.";
+        return false;
+    }
+
+    OdgDrawing drawing;
+    drawing.setUnits(reader.units());
+    drawing.setPageSize(reader.pageSize());
+    drawing.setPageMargins(reader.pageMargins());
+    drawing.setBackgroundColor(reader.backgroundColor());
+
+    const QList<OdgPage*> pages = reader.takePages();
+    for(auto& page : pages)
+        drawing.addPage(page);
+
+    // With a cache, each output file is only written if its page's content or the export settings changed since
+    // the last time it was exported
+    const double scale = exportScale(&drawing);
+    const QStringList pageNames = outputPageNames(pages);
+    for(int pageIndex = 0; pageIndex < pages.size(); pageIndex++)
+    {
+        OdgPage* page = pages.at(pageIndex);
+        const QRectF rect = exportRect(&drawing, page);
+        const QByteArray pageKey = (mCache) ? contentKey(&drawing, QList<OdgPage*>() << page) : QByteArray();
+
+        if (mFormats & PngFormat)
+        {
+            // With several scales, each goes to its own name@<factor>x.png; only the out-of-date ones are written
+            const QString path = outputPath(fileName, pageNames.at(pageIndex), "png");
+            const QList<double> factors = (mPngScales.isEmpty()) ? QList<double>() << 1.0 : mPngScales;
+            QStringList stalePaths;
+            QList<QByteArray> staleKeys;
+            QList<double> staleFactors;
+            for(auto& factor : factors)
+            {
+                const QString scaledPath = (mPngScales.isEmpty()) ? path :
+                                               MultiScalePngWriter::scaledPath(path, factor);
+                const QByteArray key = (mCache) ? outputKey(pageKey, "png", scale * factor) : QByteArray();
+                if (mCache && mCache->isCurrent(scaledPath, key))
+                    unchangedFiles.append(scaledPath);
+                else
+                {
+                    if (!mOverwrite && QFileInfo::exists(scaledPath))
+                    {
+                        errorMessage = scaledPath + " already exists.";
+                        return false;
+                    }
+                    stalePaths.append(scaledPath);
+                    staleKeys.append(key);
+                    staleFactors.append(factor);
+                }
+            }
+
+            if (!stalePaths.isEmpty())
+            {
+                if (!exportPng(stalePaths, staleFactors, rect, scale, drawing.pageRect(), drawing.backgroundColor(),
+                               page->items()))
+                {
+                    if (mCache)
+                    {
+                        for(auto& stalePath : qAsConst(stalePaths)) mCache->remove(stalePath);
+                    }
+                    errorMessage = "Error exporting " + fileName + " to " + stalePaths.join(", ") + ".";
+                    return false;
+                }
+                for(int staleIndex = 0; staleIndex < stalePaths.size(); staleIndex++)
+                {
+                    if (mCache) mCache->update(stalePaths.at(staleIndex), staleKeys.at(staleIndex));
+                }
+                outputFiles.append(stalePaths);
+            }
+        }
+
+        if (mFormats & SvgFormat)
+        {
+            const QString suffix = (mCompressSvg) ? "svgz" : "svg";
+            const QString path = outputPath(fileName, pageNames.at(pageIndex), suffix);
+            const QByteArray key = (mCache) ? outputKey(pageKey, suffix, scale) : QByteArray();
+            if (mCache && mCache->isCurrent(path, key))
+                unchangedFiles.append(path);
+            else
+            {
+                if (!mOverwrite && QFileInfo::exists(path))
+                {
+                    errorMessage = path + " already exists.";
+                    return false;
+                }
+                if (!exportSvg(path, rect, scale, drawing.backgroundColor(), page->items()))
+                {
+                    if (mCache) mCache->remove(path);
+                    errorMessage = "Error exporting " + fileName + " to " + path + ".";
+                    return false;
+                }
+                if (mCache) mCache->update(path, key);
+                outputFiles.append(path);
+            }
+        }
+    }
+
+    if (mFormats & PdfFormat)
+    {
+        // All pages go into a single PDF named after the drawing
+        const QString path = outputPath(fileName, QString(), "pdf");
+        const QByteArray key = (mCache) ? outputKey(contentKey(&drawing, pages), "pdf", scale) : QByteArray();
+        if (mCache && mCache->isCurrent(path, key))
+            unchangedFiles.append(path);
+        else
+        {
+            if (!mOverwrite && QFileInfo::exists(path))
+            {
+                errorMessage = path + " already exists.";
+                return false;
+            }
+            if (!exportPdf(path, &drawing, pages))
+            {
+                if (mCache) mCache->remove(path);
+                errorMessage = "Error exporting " + fileName + " to " + path + ".";
+                return false;
+            }
+            if (mCache) mCache->update(path, key);
+            outputFiles.append(path);
+        }
+    }
+
+    return true;
+}
+
+//======================================================================================================================
+
+QString CliExporter::outputPath(const QString& fileName, const QString& pageName, const QString& suffix) const
+{
+    const QFileInfo fileInfo(fileName);
+    const QDir outputDir(mOutputDirectory.isEmpty() ? fileInfo.absolutePath() : mOutputDirectory);
+
+    // Single-page drawings are named after the file; otherwise each page is named after the file and the page
+    QString baseName = mOutputNames.baseName(fileName);
+    if (!pageName.isEmpty()) baseName += "_" + pageName;
+
+    return outputDir.absoluteFilePath(baseName + "." + suffix);
+}
+
+QStringList CliExporter::outputPageNames(const QList<OdgPage*>& pages) const
+{
+    QStringList pageNames;
+    if (pages.size() < 2)
+    {
+        for(int pageIndex = 0; pageIndex < pages.size(); pageIndex++) pageNames.append(QString());
+        return pageNames;
+    }
+
+    static const QRegularExpression invalidCharacters(R"([\\/:*?"<>|])");
+    for(int pageIndex = 0; pageIndex < pages.size(); pageIndex++)
+    {
+        QString pageName = pages.at(pageIndex)->name();
+        pageName.replace(invalidCharacters, "_");
+        if (pageName.trimmed().isEmpty()) pageName = QString::number(pageIndex + 1);
+        pageNames.append(pageName);
+    }
+
+    // Pages that share a name (compared without case, for case-insensitive file systems) are told apart by their
+    // page number, so that no two pages are written to the same file
+    QHash<QString,int> nameCounts;
+    for(auto& pageName : qAsConst(pageNames)) nameCounts[pageName.toLower()]++;
+
+    QSet<QString> usedNames;
+    for(auto& pageName : qAsConst(pageNames))
+    {
+        if (nameCounts.value(pageName.toLower()) == 1) usedNames.insert(pageName.toLower());
+    }
+
+    for(int pageIndex = 0; pageIndex < pageNames.size(); pageIndex++)
+    {
+        if (nameCounts.value(pageNames.at(pageIndex).toLower()) > 1)
+        {
+            const QString pageName = pageNames.at(pageIndex);
+            int number = pageIndex + 1;
+            do pageNames[pageIndex] = pageName + "_" + QString::number(number++);
+            while (usedNames.contains(pageNames.at(pageIndex).toLower()));
+            usedNames.insert(pageNames.at(pageIndex).toLower());
+        }
+    }
+
+    return pageNames;
+}
+
+QRectF CliExporter::exportRect(OdgDrawing* drawing, OdgPage* page) const
+{
+    // Matches the page and items' rects offered by the GUI's export dialog
+    const QRectF pageRect = drawing->pageRect();
+    if (!mExportItemsOnly) return pageRect;
+
+    QRectF itemsRect = OdgItem::itemsBoundingRect(page->items());
+    if (itemsRect.width() != 0 && itemsRect.height() != 0)
+    {
+        const QMarginsF pageMargins = drawing->pageMargins();
+        itemsRect.adjust(-pageMargins.left(), -pageMargins.top(), pageMargins.right(), pageMargins.bottom());
+        return itemsRect;
+    }
+
+    return pageRect;
+}
+
+double CliExporter::exportScale(OdgDrawing* drawing) const
+{
+    if (mScale > 0) return mScale;
+    return (drawing->units() == Odg::UnitsInches) ? mPixelsPerInch : mPixelsPerInch * 25;
+}
+
+QByteArray CliExporter::contentKey(OdgDrawing* drawing, const QList<OdgPage*>& pages) const
+{
+    // Hash the pages as they would be saved, along with the drawing settings that affect how they are exported.
+    // Serializing is far cheaper than rendering, so checking an unchanged page costs little.
+    OdgStyle defaultStyle(drawing->units(), true);
+    OdgWriter writer;
+    writer.setUnits(drawing->units());
+    writer.setPageSize(drawing->pageSize());
+    writer.setPageMargins(drawing->pageMargins());
+    writer.setBackgroundColor(drawing->backgroundColor());
+    writer.setDefaultStyle(&defaultStyle);
+    writer.setPages(pages);
+
+    return QCryptographicHash::hash(writer.writeToString().toUtf8(), QCryptographicHash::Sha1);
+}
+
+QByteArray CliExporter::outputKey(const QByteArray& contentKey, const QString& suffix, double scale) const
+{
+    // Anything that changes the output file besides the page content is part of its key, including the version of
+    // the exporter itself
+    const QString settings = QString("%1|%2|%3|%4|%5|%6|%7").arg(QCoreApplication::applicationVersion(), suffix)
+                                 .arg(scale, 0, 'g', 17).arg(mExportItemsOnly).arg(mCompactSvg).arg(mSvgPrecision)
+                                 .arg(mCompressSvg);
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(contentKey);
+    hash.addData(settings.toUtf8());
+    return hash.result().toHex();
+}
+
+//======================================================================================================================
+
+bool CliExporter::exportPng(const QStringList& paths, const QList<double>& factors, const QRectF& rect, double scale,
+                            const QRectF& pageRect, const QColor& backgroundColor,
+                            const QList<OdgItem*>& items) const
+{
+    // Same output as DrawingWidget::paint when exporting: page background without border or grid, then items
+    auto paint = [&pageRect, &backgroundColor, &items](QPainter& painter, const QRectF& sceneRect)
+    {
+        painter.setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing, false);
+        painter.setBrush(QBrush(backgroundColor));
+        painter.setPen(QPen(Qt::NoPen));
+        painter.drawRect(pageRect);
+
+        // Each band only paints the items that reach into it
+        OdgItem::paintItems(painter, OdgItem::itemsInRect(items, sceneRect, 0));
+    };
+
+    // Files are already exported in parallel, so each file's bands are rendered on a single thread; banding still
+    // keeps large, high-resolution exports from needing the whole image in memory
+    if (paths.size() == 1 && factors.size() == 1)
+    {
+        PngWriter pngWriter(rect, scale * factors.first());
+        pngWriter.setThreadCount(1);
+        return pngWriter.write(paths.first(), paint);
+    }
+
+    // Several scales are written in one pass, each band painting only the items it covers
+    MultiScalePngWriter pngWriter(rect);
+    pngWriter.setThreadCount(1);
+    for(int pathIndex = 0; pathIndex < paths.size() && pathIndex < factors.size(); pathIndex++)
+        pngWriter.addOutput(scale * factors.at(pathIndex), paths.at(pathIndex));
+    return pngWriter.write(paint);
+}
+
+bool CliExporter::exportSvg(const QString& path, const QRectF& rect, double scale, const QColor& backgroundColor,
+                            const QList<OdgItem*>& items) const
+{
+    // As with PNG export, files are already exported in parallel, so each page is serialized on a single thread
+    SvgWriter svg(rect, scale);
+    svg.setThreadCount(1);
+    svg.setProfile(mCompactSvg ? SvgWriter::CompactProfile : SvgWriter::StandardProfile);
+    if (mSvgPrecision > 0) svg.setPrecision(mSvgPrecision);
+    svg.setCompressed(mCompressSvg);
+    return svg.write(path, backgroundColor, items);
+}
+
+bool CliExporter::exportPdf(const QString& path, OdgDrawing* drawing, const QList<OdgPage*>& pages) const
+{
+    PdfWriter pdfWriter(drawing->units());
+    pdfWriter.setTitle(QFileInfo(path).completeBaseName());
+    pdfWriter.setCreator("jade-cli");
+    for(auto& page : pages)
+        pdfWriter.addPage(exportRect(drawing, page), page->items());
+    return pdfWriter.write(path, drawing->backgroundColor());
+}
@@ -0,0 +1,96 @@
+// File: CliExporter.h
+// Copyright (C) 2023  Jason Allen
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef CLIEXPORTER_H
+#define CLIEXPORTER_H
+
+#include <QColor>
+#include <QList>
+#include <QRectF>
+#include <QStringList>
+#include "CliOutputNames.h"
+
+class CliExportCache;
+class OdgDrawing;
+class OdgItem;
+class OdgPage;
+
+class CliExporter
+{
+public:
+    enum Format { PngFormat = 0x01, SvgFormat = 0x02, PdfFormat = 0x04 };
+
+private:
+    QString mOutputDirectory;
+    int mFormats;
+    double mPixelsPerInch;
+    double mScale;
+    bool mExportItemsOnly;
+    bool mOverwrite;
+    QList<double> mPngScales;
+    bool mCompactSvg;
+    int mSvgPrecision;
+    bool mCompressSvg;
+    CliExportCache* mCache;
+    CliOutputNames mOutputNames;
+
+public:
+    CliExporter();
+
+    void setOutputDirectory(const QString& path);
+    void setFormats(int formats);
+    void setPixelsPerInch(double pixelsPerInch);
+    void setScale(double scale);
+    void setExportItemsOnly(bool itemsOnly);
+    void setOverwrite(bool overwrite);
+    void setPngScales(const QList<double>& factors);
+    void setCompactSvg(bool compact);
+    void setSvgPrecision(int digits);
+    void setCompressSvg(bool compress);
+    void setCache(CliExportCache* cache);
+    void setFileNames(const QStringList& fileNames);
+    QString outputDirectory() const;
+    int formats() const;
+    double pixelsPerInch() const;
+    double scale() const;
+    bool shouldExportItemsOnly() const;
+    bool shouldOverwrite() const;
+    QList<double> pngScales() const;
+    bool isCompactSvg() const;
+    int svgPrecision() const;
+    bool shouldCompressSvg() const;
+    CliExportCache* cache() const;
+    QStringList fileNames() const;
+
+    bool exportFile(const QString& fileName, QStringList& outputFiles, QStringList& unchangedFiles,
+                    QString& errorMessage) const;
+
+private:
+    QString outputPath(const QString& fileName, const QString& pageName, const QString& suffix) const;
+    QStringList outputPageNames(const QList<OdgPage*>& pages) const;
+    QRectF exportRect(OdgDrawing* drawing, OdgPage* page) const;
+    double exportScale(OdgDrawing* drawing) const;
+    QByteArray contentKey(OdgDrawing* drawing, const QList<OdgPage*>& pages) const;
+    QByteArray outputKey(const QByteArray& contentKey, const QString& suffix, double scale) const;
+
+    bool exportPng(const QStringList& paths, const QList<double>& factors, const QRectF& rect, double scale,
+                   const QRectF& pageRect, const QColor& backgroundColor, const QList<OdgItem*>& items) const;
+    bool exportSvg(const QString& path, const QRectF& rect, double scale, const QColor& backgroundColor,
+                   const QList<OdgItem*>& items) const;
+    bool exportPdf(const QString& path, OdgDrawing* drawing, const QList<OdgPage*>& pages) const;
+};
+
+#endif
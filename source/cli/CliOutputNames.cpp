@@ -0,0 +1,116 @@
+// File: CliOutputNames.cpp
+// Copyright (C) 2023  Jason Allen
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "CliOutputNames.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QSet>
+
+CliOutputNames::CliOutputNames() : mOutputDirectory(), mFileNames(), mBaseNames()
+{
+    // Nothing more to do here.
+}
+
+//======================================================================================================================
+
+void CliOutputNames::setOutputDirectory(const QString& path)
+{
+    mOutputDirectory = path;
+    updateBaseNames();
+}
+
+void CliOutputNames::setFileNames(const QStringList& fileNames)
+{
+    mFileNames = fileNames;
+    updateBaseNames();
+}
+
+QString CliOutputNames::outputDirectory() const
+{
+    return mOutputDirectory;
+}
+
+QStringList CliOutputNames::fileNames() const
+{
+    return mFileNames;
+}
+
+//======================================================================================================================
+
+QString CliOutputNames::baseName(const QString& fileName) const
+{
+    const QFileInfo fileInfo(fileName);
+    return mBaseNames.value(fileInfo.absoluteFilePath(), fileInfo.completeBaseName());
+}
+
+//======================================================================================================================
+
+void CliOutputNames::updateBaseNames()
+{
+    mBaseNames.clear();
+
+    // Group the drawings by the output file name they would normally get, in the order they were given
+    QStringList keys;
+    QHash<QString,QStringList> groups;
+    for(auto& fileName : qAsConst(mFileNames))
+    {
+        const QFileInfo fileInfo(fileName);
+        const QString key = outputKey(fileName, fileInfo.completeBaseName());
+
+        QStringList& group = groups[key];
+        if (group.isEmpty()) keys.append(key);
+        if (!group.contains(fileInfo.absoluteFilePath())) group.append(fileInfo.absoluteFilePath());
+    }
+
+    // Names that are already unique are kept, and the colliding ones are given a suffix that is not taken either
+    QSet<QString> usedKeys;
+    for(auto& key : qAsConst(keys))
+    {
+        if (groups.value(key).size() == 1) usedKeys.insert(key);
+    }
+
+    for(auto& key : qAsConst(keys))
+    {
+        const QStringList group = groups.value(key);
+        if (group.size() < 2) continue;
+
+        for(int index = 0; index < group.size(); index++)
+        {
+            const QString& fileName = group.at(index);
+            const QFileInfo fileInfo(fileName);
+            const QString directoryName = fileInfo.absoluteDir().dirName();
+
+            QString baseName = fileInfo.completeBaseName() + "_" + directoryName;
+            if (directoryName.isEmpty() || usedKeys.contains(outputKey(fileName, baseName)))
+            {
+                int number = index + 1;
+                do baseName = fileInfo.completeBaseName() + "_" + QString::number(number++);
+                while (usedKeys.contains(outputKey(fileName, baseName)));
+            }
+
+            usedKeys.insert(outputKey(fileName, baseName));
+            mBaseNames.insert(fileName, baseName);
+        }
+    }
+}
+
+QString CliOutputNames::outputKey(const QString& fileName, const QString& baseName) const
+{
+    // File names are compared without case, since the output may go to a case-insensitive file system
+    const QFileInfo fileInfo(fileName);
+    const QDir outputDir(mOutputDirectory.isEmpty() ? fileInfo.absolutePath() : mOutputDirectory);
+    return outputDir.absoluteFilePath(baseName).toLower();
+}
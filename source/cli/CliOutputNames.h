@@ -0,0 +1,49 @@
+// File: CliOutputNames.h
+// Copyright (C) 2023  Jason Allen
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef CLIOUTPUTNAMES_H
+#define CLIOUTPUTNAMES_H
+
+#include <QHash>
+#include <QStringList>
+
+// Assigns each input drawing the base name its output files are named after.  Normally this is the drawing's own
+// base name, but drawings that would write to the same output directory under the same name (i.e. a/x.odg and
+// b/x.odg exported into one --output directory) are told apart by their parent directory's name, or failing that by
+// a number, so that no two drawings processed in parallel write the same file.
+class CliOutputNames
+{
+private:
+    QString mOutputDirectory;
+    QStringList mFileNames;
+    QHash<QString,QString> mBaseNames;
+
+public:
+    CliOutputNames();
+
+    void setOutputDirectory(const QString& path);
+    void setFileNames(const QStringList& fileNames);
+    QString outputDirectory() const;
+    QStringList fileNames() const;
+
+    QString baseName(const QString& fileName) const;
+
+private:
+    void updateBaseNames();
+    QString outputKey(const QString& fileName, const QString& baseName) const;
+};
+
+#endif
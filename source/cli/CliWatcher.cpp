@@ -0,0 +1,108 @@
+// File: CliWatcher.cpp
+// Copyright (C) 2023  Jason Allen
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "CliWatcher.h"
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QTimer>
+
+CliWatcher::CliWatcher(const QStringList& fileNames, const ExportFunction& exportFunction, QObject* parent) :
+    QObject(parent), mFileNames(), mExportFunction(exportFunction), mWatcher(nullptr), mExportTimer(nullptr),
+    mChangedFileNames()
+{
+    for(auto& fileName : fileNames)
+        mFileNames.append(QFileInfo(fileName).absoluteFilePath());
+
+    mWatcher = new QFileSystemWatcher(this);
+    watchMissingFiles();
+    connect(mWatcher, SIGNAL(fileChanged(const QString&)), this, SLOT(addChangedFile(const QString&)));
+    connect(mWatcher, SIGNAL(directoryChanged(const QString&)), this, SLOT(addChangedDirectory(const QString&)));
+
+    mExportTimer = new QTimer(this);
+    mExportTimer->setSingleShot(true);
+    mExportTimer->setInterval(250);
+    connect(mExportTimer, SIGNAL(timeout()), this, SLOT(exportChangedFiles()));
+}
+
+//======================================================================================================================
+
+void CliWatcher::setDelay(int milliseconds)
+{
+    mExportTimer->setInterval(qMax(milliseconds, 0));
+}
+
+int CliWatcher::delay() const
+{
+    return mExportTimer->interval();
+}
+
+//======================================================================================================================
+
+void CliWatcher::addChangedFile(const QString& fileName)
+{
+    if (!mChangedFileNames.contains(fileName)) mChangedFileNames.append(fileName);
+    mExportTimer->start();
+}
+
+void CliWatcher::addChangedDirectory(const QString& path)
+{
+    // A drawing that was missing from the watcher has appeared again in this folder
+    const QStringList watchedFileNames = mWatcher->files();
+    for(auto& fileName : qAsConst(mFileNames))
+    {
+        if (QFileInfo(fileName).absolutePath() == path && !watchedFileNames.contains(fileName) &&
+            QFileInfo::exists(fileName))
+        {
+            mWatcher->addPath(fileName);
+            addChangedFile(fileName);
+        }
+    }
+}
+
+void CliWatcher::exportChangedFiles()
+{
+    // Editors that save by replacing the file cause it to drop out of the watcher, so watch it again
+    watchMissingFiles();
+
+    // Files that are missing right now (i.e. deleted by the editor but not yet written again) stay pending until
+    // they reappear in their folder
+    QStringList fileNames, missingFileNames;
+    for(auto& fileName : qAsConst(mChangedFileNames))
+    {
+        if (QFileInfo::exists(fileName))
+            fileNames.append(fileName);
+        else
+            missingFileNames.append(fileName);
+    }
+    mChangedFileNames = missingFileNames;
+
+    if (!fileNames.isEmpty()) mExportFunction(fileNames);
+}
+
+//======================================================================================================================
+
+void CliWatcher::watchMissingFiles()
+{
+    const QStringList watchedFileNames = mWatcher->files();
+    for(auto& fileName : qAsConst(mFileNames))
+    {
+        if (!watchedFileNames.contains(fileName) && QFileInfo::exists(fileName)) mWatcher->addPath(fileName);
+
+        const QString path = QFileInfo(fileName).absolutePath();
+        if (!mWatcher->directories().contains(path) && QFileInfo::exists(path))
+            mWatcher->addPath(path);
+    }
+}
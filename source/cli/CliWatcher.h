@@ -0,0 +1,61 @@
+// File: CliWatcher.h
+// Copyright (C) 2023  Jason Allen
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef CLIWATCHER_H
+#define CLIWATCHER_H
+
+#include <QObject>
+#include <QStringList>
+#include <functional>
+
+class QFileSystemWatcher;
+class QTimer;
+
+// Watches drawings for changes and passes the changed ones to the export function.  Changes that arrive close
+// together (i.e. an editor writing a file in several steps, or saving several files at once) are collected into a
+// single export.  The folders holding the drawings are watched as well, so that a drawing which is deleted and
+// written again (or does not exist yet) is picked up as soon as it appears.
+class CliWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    using ExportFunction = std::function<void(const QStringList& fileNames)>;
+
+private:
+    QStringList mFileNames;
+    ExportFunction mExportFunction;
+
+    QFileSystemWatcher* mWatcher;
+    QTimer* mExportTimer;
+    QStringList mChangedFileNames;
+
+public:
+    CliWatcher(const QStringList& fileNames, const ExportFunction& exportFunction, QObject* parent = nullptr);
+
+    void setDelay(int milliseconds);
+    int delay() const;
+
+private slots:
+    void addChangedFile(const QString& fileName);
+    void addChangedDirectory(const QString& path);
+    void exportChangedFiles();
+
+private:
+    void watchMissingFiles();
+};
+
+#endif
@@ -0,0 +1,383 @@
+// File: main.cpp
+// Copyright (C) 2023  Jason Allen
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QGuiApplication>
+#include <QMutex>
+#include <QTextStream>
+#include <QThreadPool>
+#include "CliConverter.h"
+#include "CliExportCache.h"
+#include "CliExporter.h"
+#include "CliWatcher.h"
+#include "MultiScalePngWriter.h"
+#include "version.h"
+
+static QString skippedElementsText(const QMap<QString,int>& skippedElements)
+{
+    QStringList elements;
+    for(auto elementIter = skippedElements.cbegin(); elementIter != skippedElements.cend(); elementIter++)
+        elements.append(QString("%1 x%2").arg(elementIter.key()).arg(elementIter.value()));
+    return elements.join(", ");
+}
+
+static int convertFiles(const CliConverter& converter, const QStringList& fileNames, QThreadPool& pool)
+{
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    // Each job holds at most one drawing in memory at a time and jobs only capture a file name while they are
+    // queued, so the pool's thread count bounds the memory used no matter how many files are converted
+    QElapsedTimer timer;
+    timer.start();
+
+    QMutex outputMutex;
+    int failureCount = 0;
+    qint64 totalParseTime = 0;
+    QMap<QString,int> totalSkippedElements;
+    for(auto& fileName : fileNames)
+    {
+        pool.start([&converter, &outputMutex, &out, &err, &failureCount, &totalParseTime, &totalSkippedElements,
+                    fileName]()
+        {
+            CliConverter::Result result;
+            QString errorMessage;
+            const bool success = converter.convertFile(fileName, result, errorMessage);
+
+            QMutexLocker locker(&outputMutex);
+            if (success)
+            {
+                out << fileName << " -> " << result.outputFile <<
+                       QString(" (parse %1 ms, write %2 ms, %3 pages, %4 items").arg(
+                           result.parseTime / 1E6, 0, 'f', 1).arg(result.writeTime / 1E6, 0, 'f', 1).arg(
+                           result.pageCount).arg(result.itemCount);
+                if (!result.skippedElements.isEmpty())
+                    out << ", skipped " << skippedElementsText(result.skippedElements);
+                out << ")" << Qt::endl;
+
+                totalParseTime += result.parseTime;
+                for(auto elementIter = result.skippedElements.cbegin();
+                    elementIter != result.skippedElements.cend(); elementIter++)
+                {
+                    totalSkippedElements[elementIter.key()] += elementIter.value();
+                }
+            }
+            else
+            {
+                err << "jade-cli: " << errorMessage << Qt::endl;
+                failureCount++;
+            }
+        });
+    }
+    pool.waitForDone();
+
+    out << QString("Converted %1 of %2 files in %3 s (%4 s parsing)").arg(fileNames.size() - failureCount).arg(
+               fileNames.size()).arg(timer.nsecsElapsed() / 1E9, 0, 'f', 2).arg(totalParseTime / 1E9, 0, 'f', 2) <<
+           Qt::endl;
+    if (!totalSkippedElements.isEmpty())
+        out << "Skipped elements: " << skippedElementsText(totalSkippedElements) << Qt::endl;
+
+    return (failureCount == 0) ? 0 : 1;
+}
+
+static int exportFiles(const CliExporter& exporter, const QStringList& fileNames, QThreadPool& pool)
+{
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QMutex outputMutex;
+    int failureCount = 0;
+    int unchangedCount = 0;
+    for(auto& fileName : fileNames)
+    {
+        pool.start([&exporter, &outputMutex, &out, &err, &failureCount, &unchangedCount, fileName]()
+        {
+            QStringList outputFiles, unchangedFiles;
+            QString errorMessage;
+            const bool success = exporter.exportFile(fileName, outputFiles, unchangedFiles, errorMessage);
+
+            QMutexLocker locker(&outputMutex);
+            for(auto& outputFile : qAsConst(outputFiles))
+                out << fileName << " -> " << outputFile << Qt::endl;
+            unchangedCount += unchangedFiles.size();
+            if (!success)
+            {
+                err << "jade-cli: " << errorMessage << Qt::endl;
+                failureCount++;
+            }
+        });
+    }
+    pool.waitForDone();
+
+    if (exporter.cache())
+    {
+        out << QString("%1 output file(s) unchanged; finished in %2 ms").arg(unchangedCount).arg(
+                   timer.nsecsElapsed() / 1E6, 0, 'f', 1) << Qt::endl;
+    }
+
+    return (failureCount == 0) ? 0 : 1;
+}
+
+//======================================================================================================================
+
+int main(int argc, char* argv[])
+{
+    // Render without a display unless the caller asked for a specific platform plugin
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QGuiApplication app(argc, argv);
+    QGuiApplication::setApplicationName("jade-cli");
+    QGuiApplication::setApplicationVersion(PROJECT_VERSION);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Export each page of one or more Jade drawings to PNG, SVG or PDF, or convert "
+                                     "drawings saved by other applications (i.e. LibreOffice Draw) to Jade-native "
+                                     "ODG.");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument("files", "Drawings (.odg) to export.", "files...");
+
+    const QCommandLineOption formatOption(QStringList() << "f" << "format",
+                                          "Output format: png, svg, pdf, or both (png and svg; default: png).",
+                                          "format", "png");
+    const QCommandLineOption outputOption(QStringList() << "o" << "output",
+                                          "Output directory (default: next to each drawing).", "dir");
+    const QCommandLineOption dpiOption(QStringList() << "d" << "dpi",
+                                       "Resolution in pixels per inch (default: 600).", "dpi", "600");
+    const QCommandLineOption scaleOption(QStringList() << "s" << "scale",
+                                         "Pixels per drawing unit; overrides --dpi.", "scale");
+    const QCommandLineOption scalesOption("scales",
+                                          "Write each PNG page at several scales in one pass, as "
+                                          "name@<factor>x.png (i.e. 1,2,0.25).", "factors");
+    const QCommandLineOption itemsOnlyOption(QStringList() << "i" << "items-only",
+                                             "Export only the area covered by the page's items.");
+    const QCommandLineOption noOverwriteOption("no-overwrite", "Fail instead of replacing existing output files.");
+    const QCommandLineOption svgProfileOption("svg-profile",
+                                              "SVG output profile: standard, or compact (unindented, 5 significant "
+                                              "digits, shared style classes; default: standard).",
+                                              "profile", "standard");
+    const QCommandLineOption svgPrecisionOption("svg-precision",
+                                                "Significant digits for SVG coordinates; overrides the profile's.",
+                                                "digits");
+    const QCommandLineOption svgzOption("svgz", "Write SVG output gzip-compressed, as .svgz files.");
+    const QCommandLineOption cacheOption("cache",
+                                         "Only export pages whose content or export settings changed since the last "
+                                         "run, keeping track of them in this file.", "file");
+    const QCommandLineOption watchOption(QStringList() << "w" << "watch",
+                                         "Keep running and re-export the changed pages of each drawing when it is "
+                                         "saved.");
+    const QCommandLineOption convertOption(QStringList() << "c" << "convert",
+                                           "Convert the drawings to Jade-native ODG instead of exporting them; "
+                                           "requires --output.");
+    const QCommandLineOption jobsOption(QStringList() << "j" << "jobs",
+                                        "Number of drawings to process in parallel (default: one per core).", "count");
+    parser.addOption(formatOption);
+    parser.addOption(outputOption);
+    parser.addOption(dpiOption);
+    parser.addOption(scaleOption);
+    parser.addOption(scalesOption);
+    parser.addOption(itemsOnlyOption);
+    parser.addOption(noOverwriteOption);
+    parser.addOption(svgProfileOption);
+    parser.addOption(svgPrecisionOption);
+    parser.addOption(svgzOption);
+    parser.addOption(cacheOption);
+    parser.addOption(watchOption);
+    parser.addOption(convertOption);
+    parser.addOption(jobsOption);
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    // A drawing given twice would otherwise be processed by two jobs writing the same output files at once
+    QStringList fileNames, absoluteFileNames;
+    const QStringList arguments = parser.positionalArguments();
+    for(auto& fileName : arguments)
+    {
+        const QString absoluteFileName = QFileInfo(fileName).absoluteFilePath();
+        if (!absoluteFileNames.contains(absoluteFileName))
+        {
+            absoluteFileNames.append(absoluteFileName);
+            fileNames.append(fileName);
+        }
+    }
+
+    if (fileNames.isEmpty())
+    {
+        err << "jade-cli: no input files" << Qt::endl;
+        parser.showHelp(1);
+    }
+
+    // Files are processed in parallel; each job reads and processes its own drawing
+    bool ok = false;
+    QThreadPool pool;
+    if (parser.isSet(jobsOption))
+    {
+        const int jobs = parser.value(jobsOption).toInt(&ok);
+        if (!ok || jobs <= 0)
+        {
+            err << "jade-cli: invalid job count '" << parser.value(jobsOption) << "'" << Qt::endl;
+            return 1;
+        }
+        pool.setMaxThreadCount(jobs);
+    }
+
+    if (parser.isSet(convertOption))
+    {
+        // Converted drawings keep their file name, so they must go somewhere other than next to the originals
+        if (!parser.isSet(outputOption))
+        {
+            err << "jade-cli: --convert requires --output" << Qt::endl;
+            return 1;
+        }
+
+        const QString outputDirectory = parser.value(outputOption);
+        if (!QDir().mkpath(outputDirectory))
+        {
+            err << "jade-cli: unable to create output directory " << outputDirectory << Qt::endl;
+            return 1;
+        }
+
+        CliConverter converter;
+        converter.setOutputDirectory(outputDirectory);
+        converter.setOverwrite(!parser.isSet(noOverwriteOption));
+        converter.setFileNames(fileNames);
+        return convertFiles(converter, fileNames, pool);
+    }
+
+    // Configure the exporter from the command-line options
+    CliExporter exporter;
+
+    const QString format = parser.value(formatOption).toLower();
+    if (format == "png")
+        exporter.setFormats(CliExporter::PngFormat);
+    else if (format == "svg")
+        exporter.setFormats(CliExporter::SvgFormat);
+    else if (format == "pdf")
+        exporter.setFormats(CliExporter::PdfFormat);
+    else if (format == "both")
+        exporter.setFormats(CliExporter::PngFormat | CliExporter::SvgFormat);
+    else
+    {
+        err << "jade-cli: unknown format '" << format << "'" << Qt::endl;
+        return 1;
+    }
+
+    if (parser.isSet(outputOption))
+    {
+        const QString outputDirectory = parser.value(outputOption);
+        if (!QDir().mkpath(outputDirectory))
+        {
+            err << "jade-cli: unable to create output directory " << outputDirectory << Qt::endl;
+            return 1;
+        }
+        exporter.setOutputDirectory(outputDirectory);
+    }
+
+    const double pixelsPerInch = parser.value(dpiOption).toDouble(&ok);
+    if (!ok || pixelsPerInch <= 0)
+    {
+        err << "jade-cli: invalid dpi '" << parser.value(dpiOption) << "'" << Qt::endl;
+        return 1;
+    }
+    exporter.setPixelsPerInch(pixelsPerInch);
+
+    if (parser.isSet(scaleOption))
+    {
+        const double scale = parser.value(scaleOption).toDouble(&ok);
+        if (!ok || scale <= 0)
+        {
+            err << "jade-cli: invalid scale '" << parser.value(scaleOption) << "'" << Qt::endl;
+            return 1;
+        }
+        exporter.setScale(scale);
+    }
+
+    const QString svgProfile = parser.value(svgProfileOption).toLower();
+    if (svgProfile != "standard" && svgProfile != "compact")
+    {
+        err << "jade-cli: unknown SVG profile '" << svgProfile << "'" << Qt::endl;
+        return 1;
+    }
+    exporter.setCompactSvg(svgProfile == "compact");
+
+    if (parser.isSet(svgPrecisionOption))
+    {
+        const int svgPrecision = parser.value(svgPrecisionOption).toInt(&ok);
+        if (!ok || svgPrecision < 1 || svgPrecision > 17)
+        {
+            err << "jade-cli: invalid SVG precision '" << parser.value(svgPrecisionOption) << "'" << Qt::endl;
+            return 1;
+        }
+        exporter.setSvgPrecision(svgPrecision);
+    }
+
+    exporter.setCompressSvg(parser.isSet(svgzOption));
+
+    // Watch mode always uses a cache so that only changed pages are re-exported; it is kept in memory unless a
+    // cache file was given
+    CliExportCache cache(parser.value(cacheOption));
+    if (!cache.load())
+    {
+        err << "jade-cli: unable to read cache file " << cache.fileName() << Qt::endl;
+        return 1;
+    }
+    if (parser.isSet(cacheOption) || parser.isSet(watchOption)) exporter.setCache(&cache);
+    if (parser.isSet(scalesOption))
+    {
+        const QList<double> factors = MultiScalePngWriter::parseFactors(parser.value(scalesOption), &ok);
+        if (!ok || factors.isEmpty())
+        {
+            err << "jade-cli: invalid scales '" << parser.value(scalesOption) << "'" << Qt::endl;
+            return 1;
+        }
+        exporter.setPngScales(factors);
+    }
+
+    exporter.setFileNames(fileNames);
+    exporter.setExportItemsOnly(parser.isSet(itemsOnlyOption));
+    exporter.setOverwrite(!parser.isSet(noOverwriteOption));
+
+    int result = exportFiles(exporter, fileNames, pool);
+    if (!cache.save())
+    {
+        err << "jade-cli: unable to write cache file " << cache.fileName() << Qt::endl;
+        result = 1;
+    }
+
+    if (parser.isSet(watchOption))
+    {
+        // Keep running and re-export drawings as they are saved; only their changed pages are written again
+        CliWatcher watcher(fileNames, [&exporter, &pool, &cache, &err](const QStringList& changedFileNames)
+        {
+            exportFiles(exporter, changedFileNames, pool);
+            if (!cache.save()) err << "jade-cli: unable to write cache file " << cache.fileName() << Qt::endl;
+        });
+
+        out << "Watching " << fileNames.size() << " file(s) for changes; press Ctrl+C to stop." << Qt::endl;
+        return app.exec();
+    }
+
+    return result;
+}
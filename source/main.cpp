@@ -14,19 +14,58 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <QAbstractScrollArea>
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
 #include "JadeWindow.h"
+#include "StartupTrace.h"
 
 int main(int argc, char* argv[])
 {
+    QElapsedTimer startupTimer;
+    startupTimer.start();
+
     QApplication app(argc, argv);
 
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addPositionalArgument("file", "Drawing to open.", "[file]");
+    parser.addOption(QCommandLineOption("startup-trace", "Report the time from cold start to the first frame."));
+    parser.addOption(QCommandLineOption("startup-trace-file",
+                                        "Write the startup trace to <file> in Chrome trace format.", "file"));
+    parser.addOption(QCommandLineOption("startup-budget", "Warn if startup takes longer than <ms> (default 1000).",
+                                        "ms", "1000"));
+    parser.addOption(QCommandLineOption("quit-after-startup",
+                                        "Exit once the first frame is drawn; the exit code is 1 if over budget."));
+    parser.process(app);
+
+    StartupTrace* startupTrace = nullptr;
+    if (parser.isSet("startup-trace") || parser.isSet("startup-trace-file") || parser.isSet("quit-after-startup"))
+    {
+        startupTrace = new StartupTrace(startupTimer.nsecsElapsed(), &app);
+        startupTrace->setBudget(parser.value("startup-budget").toDouble());
+        startupTrace->setTraceFileName(parser.value("startup-trace-file"));
+        startupTrace->setQuitWhenFinished(parser.isSet("quit-after-startup"));
+    }
+
     JadeWindow window;
-    if (app.arguments().size() > 1)
-        window.openDrawing(app.arguments().at(1));
+    if (startupTrace) startupTrace->endPhase("startup/JadeWindow");
+
+    if (!parser.positionalArguments().isEmpty())
+        window.openDrawing(parser.positionalArguments().first());
     else
         window.newDrawing();
+    if (startupTrace) startupTrace->endPhase("startup/openDrawing");
+
     window.show();
+    if (startupTrace)
+    {
+        startupTrace->endPhase("startup/show");
+
+        QAbstractScrollArea* drawingArea = qobject_cast<QAbstractScrollArea*>(window.centralWidget());
+        startupTrace->waitForFirstFrame(drawingArea ? drawingArea->viewport() : static_cast<QWidget*>(&window));
+    }
 
     return app.exec();
 }
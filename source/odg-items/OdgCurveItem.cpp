@@ -41,6 +41,11 @@ OdgItem* OdgCurveItem::copy() const
 	return curveItem;
 }
 
+OdgItem::Type OdgCurveItem::type() const
+{
+	return CurveType;
+}
+
 //======================================================================================================================
 
 void OdgCurveItem::setCurve(const OdgCurve& curve)
@@ -209,12 +214,25 @@ QPainterPath OdgCurveItem::shape() const
     return shape;
 }
 
+QRectF OdgCurveItem::paintBoundingRect() const
+{
+    QRectF rect = boundingRect();
+    if (shouldShowMarker(mStartMarker.size())) rect = rect.united(mStartMarker.boundingRect(mPen, mCurve.p1()));
+    if (shouldShowMarker(mEndMarker.size())) rect = rect.united(mEndMarker.boundingRect(mPen, mCurve.p2()));
+    return rect;
+}
+
 bool OdgCurveItem::isValid() const
 {
     QRectF boundingRect = mCurvePath.boundingRect();
     return (boundingRect.width() != 0 || boundingRect.height() != 0);
 }
 
+qint64 OdgCurveItem::memoryUsage() const
+{
+    return OdgItem::memoryUsage() + sizeof(OdgCurveItem) - sizeof(OdgItem) + pathMemoryUsage(mCurvePath);
+}
+
 //======================================================================================================================
 
 void OdgCurveItem::paint(QPainter& painter)
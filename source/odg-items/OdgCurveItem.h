@@ -41,6 +41,7 @@ public:
     OdgCurveItem();
 
 	OdgItem* copy() const override;
+	Type type() const override;
 
     void setCurve(const OdgCurve& curve);
     OdgCurve curve() const;
@@ -57,7 +58,9 @@ public:
 
     QRectF boundingRect() const override;
     QPainterPath shape() const override;
+    QRectF paintBoundingRect() const override;
     bool isValid() const override;
+    qint64 memoryUsage() const override;
 
     void paint(QPainter& painter) override;
 
@@ -36,6 +36,11 @@ OdgItem* OdgEllipseItem::copy() const
 	return ellipseItem;
 }
 
+OdgItem::Type OdgEllipseItem::type() const
+{
+	return EllipseType;
+}
+
 //======================================================================================================================
 
 void OdgEllipseItem::setEllipse(const QRectF& ellipse)
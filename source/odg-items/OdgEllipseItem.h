@@ -25,6 +25,7 @@ public:
     OdgEllipseItem();
 
 	virtual OdgItem* copy() const override;
+	virtual Type type() const override;
 
 	void setEllipse(const QRectF& ellipse);
 	QRectF ellipse() const;
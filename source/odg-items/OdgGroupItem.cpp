@@ -41,6 +41,11 @@ OdgItem* OdgGroupItem::copy() const
 	return groupItem;
 }
 
+OdgItem::Type OdgGroupItem::type() const
+{
+	return GroupType;
+}
+
 //======================================================================================================================
 
 void OdgGroupItem::setItems(const QList<OdgItem*>& items)
@@ -104,6 +109,15 @@ bool OdgGroupItem::isValid() const
     return (!mItems.isEmpty());
 }
 
+qint64 OdgGroupItem::memoryUsage() const
+{
+    // Includes the grouped items, which the group owns
+    qint64 usage = OdgItem::memoryUsage() + sizeof(OdgGroupItem) - sizeof(OdgItem);
+    usage += mItems.capacity() * sizeof(OdgItem*);
+    for(auto& item : mItems) usage += item->memoryUsage();
+    return usage;
+}
+
 //======================================================================================================================
 
 void OdgGroupItem::paint(QPainter& painter)
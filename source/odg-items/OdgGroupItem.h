@@ -34,6 +34,7 @@ public:
     ~OdgGroupItem();
 
 	OdgItem* copy() const override;
+	Type type() const override;
 
     void setItems(const QList<OdgItem*>& items);
     QList<OdgItem*> items() const;
@@ -44,6 +45,7 @@ public:
     QRectF boundingRect() const override;
     QPainterPath shape() const override;
 	bool isValid() const override;
+	qint64 memoryUsage() const override;
 
 	void paint(QPainter& painter) override;
 
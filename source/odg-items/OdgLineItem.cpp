@@ -38,6 +38,11 @@ OdgItem* OdgLineItem::copy() const
 	return lineItem;
 }
 
+OdgItem::Type OdgLineItem::type() const
+{
+	return LineType;
+}
+
 //======================================================================================================================
 
 void OdgLineItem::setLine(const QLineF& line)
@@ -202,11 +207,24 @@ QPainterPath OdgLineItem::shape() const
     return shape;
 }
 
+QRectF OdgLineItem::paintBoundingRect() const
+{
+    QRectF rect = boundingRect();
+    if (shouldShowMarker(mStartMarker.size())) rect = rect.united(mStartMarker.boundingRect(mPen, mLine.p1()));
+    if (shouldShowMarker(mEndMarker.size())) rect = rect.united(mEndMarker.boundingRect(mPen, mLine.p2()));
+    return rect;
+}
+
 bool OdgLineItem::isValid() const
 {
     return (mLine.x1() != mLine.x2() || mLine.y1() != mLine.y2());
 }
 
+qint64 OdgLineItem::memoryUsage() const
+{
+    return OdgItem::memoryUsage() + sizeof(OdgLineItem) - sizeof(OdgItem);
+}
+
 //======================================================================================================================
 
 void OdgLineItem::paint(QPainter& painter)
@@ -37,6 +37,7 @@ public:
     OdgLineItem();
 
 	OdgItem* copy() const override;
+	Type type() const override;
 
     void setLine(const QLineF& line);
     QLineF line() const;
@@ -53,7 +54,9 @@ public:
 
     QRectF boundingRect() const override;
     QPainterPath shape() const override;
+    QRectF paintBoundingRect() const override;
     bool isValid() const override;
+    qint64 memoryUsage() const override;
 
     void paint(QPainter& painter) override;
 
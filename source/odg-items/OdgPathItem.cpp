@@ -17,7 +17,7 @@
 #include "OdgPathItem.h"
 #include <QPainter>
 
-OdgPathItem::OdgPathItem() : OdgRectItem(), mPathName(), mPath(), mPathRect(), mTransformedPath()
+OdgPathItem::OdgPathItem() : OdgRectItem(), mData(new OdgPathItemData())
 {
     // Nothing more to do here.
 }
@@ -32,50 +32,56 @@ OdgItem* OdgPathItem::copy() const
     pathItem->setFlipped(mFlipped);
 	pathItem->setBrush(mBrush);
     pathItem->setPen(mPen);
-    pathItem->setPathName(mPathName);
-    pathItem->setPath(mPath, mPathRect);
+    pathItem->mData = mData;
     pathItem->setRect(mRect);
 	return pathItem;
 }
 
+OdgItem::Type OdgPathItem::type() const
+{
+	return PathType;
+}
+
 //======================================================================================================================
 
 void OdgPathItem::setRect(const QRectF& rect)
 {
     OdgRectItem::setRect(rect);
-	updateTransformedPath();
+
+    // Only recompute (and detach) the transformed path if the rect actually changed
+    if (mData.constData()->transformedRect != mRect) updateTransformedPath();
 }
 
 //======================================================================================================================
 
 void OdgPathItem::setPathName(const QString& name)
 {
-    mPathName = name;
+    if (mData.constData()->pathName != name) mData->pathName = name;
 }
 
 void OdgPathItem::setPath(const QPainterPath& path, const QRectF& pathRect)
 {
     if (pathRect.width() != 0 && pathRect.height() != 0)
 	{
-		mPath = path;
-		mPathRect = pathRect;
+		mData->path = path;
+		mData->pathRect = pathRect;
 		updateTransformedPath();
 	}
 }
 
 QString OdgPathItem::pathName() const
 {
-    return mPathName;
+    return mData->pathName;
 }
 
 QPainterPath OdgPathItem::path() const
 {
-    return mPath;
+    return mData->path;
 }
 
 QRectF OdgPathItem::pathRect() const
 {
-    return mPathRect;
+    return mData->pathRect;
 }
 
 //======================================================================================================================
@@ -89,7 +95,17 @@ QPainterPath OdgPathItem::shape() const
 
 bool OdgPathItem::isValid() const
 {
-	return (OdgRectItem::isValid() && !mPath.isEmpty() && mPathRect.width() != 0 && mPathRect.height() != 0);
+	return (OdgRectItem::isValid() && !mData->path.isEmpty() && mData->pathRect.width() != 0 &&
+            mData->pathRect.height() != 0);
+}
+
+qint64 OdgPathItem::memoryUsage() const
+{
+    // The path data is shared with this item's copies, so each of them is charged an equal part of it
+    const qint64 dataUsage = sizeof(OdgPathItemData) + stringMemoryUsage(mData->pathName) +
+                             pathMemoryUsage(mData->path) + pathMemoryUsage(mData->transformedPath);
+    return OdgRectItem::memoryUsage() + sizeof(OdgPathItem) - sizeof(OdgRectItem) +
+           dataUsage / qMax(mData->ref.loadRelaxed(), 1);
 }
 
 //======================================================================================================================
@@ -98,7 +114,7 @@ void OdgPathItem::paint(QPainter& painter)
 {
     painter.setBrush(brush());
     painter.setPen(pen());
-	painter.drawPath(mTransformedPath);
+	painter.drawPath(mData.constData()->transformedPath);
 }
 
 //======================================================================================================================
@@ -107,20 +123,23 @@ void OdgPathItem::placeCreateEvent(const QRectF& contentRect, double grid)
 {
     double size = grid;
     if (size <= 0) size = contentRect.width() / 320;
-	setRect(QRectF(mPathRect.left() * size, mPathRect.top() * size,
-				   mPathRect.width() * size, mPathRect.height() * size));
+
+    const QRectF pathRect = mData.constData()->pathRect;
+	setRect(QRectF(pathRect.left() * size, pathRect.top() * size, pathRect.width() * size, pathRect.height() * size));
 }
 
 //======================================================================================================================
 
 void OdgPathItem::updateTransformedPath()
 {
-    const double xScale = mRect.width() / mPathRect.width(), yScale = mRect.height() / mPathRect.height();
+    OdgPathItemData* data = mData.data();
+    const double xScale = mRect.width() / data->pathRect.width(), yScale = mRect.height() / data->pathRect.height();
 
     QTransform transform;
-    transform.translate(-mPathRect.left() * xScale, -mPathRect.top() * yScale);
+    transform.translate(-data->pathRect.left() * xScale, -data->pathRect.top() * yScale);
     transform.translate(mRect.left(), mRect.top());
     transform.scale(xScale, yScale);
 
-    mTransformedPath = transform.map(mPath);
+    data->transformedRect = mRect;
+    data->transformedPath = transform.map(data->path);
 }
@@ -19,20 +19,33 @@
 
 #include "OdgRectItem.h"
 #include <QPen>
+#include <QSharedData>
+
+// Path geometry is implicitly shared between an OdgPathItem and its copies (undo snapshots, clipboard, duplicated
+// symbols) and is only detached when one of them changes its path or rect.
+class OdgPathItemData : public QSharedData
+{
+public:
+    QString pathName;
+    QPainterPath path;
+    QRectF pathRect;
+
+    QRectF transformedRect;
+    QPainterPath transformedPath;
+};
+
+//======================================================================================================================
 
 class OdgPathItem : public OdgRectItem
 {
 private:
-    QString mPathName;
-    QPainterPath mPath;
-    QRectF mPathRect;
-
-	QPainterPath mTransformedPath;
+    QSharedDataPointer<OdgPathItemData> mData;
 
 public:
     OdgPathItem();
 
 	OdgItem* copy() const override;
+	Type type() const override;
 
 	void setRect(const QRectF& rect) override;
 
@@ -44,6 +57,7 @@ public:
 
     QPainterPath shape() const override;
     bool isValid() const override;
+    qint64 memoryUsage() const override;
 
     void paint(QPainter& painter) override;
 
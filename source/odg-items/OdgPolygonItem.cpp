@@ -37,6 +37,11 @@ OdgItem* OdgPolygonItem::copy() const
 	return polygonItem;
 }
 
+OdgItem::Type OdgPolygonItem::type() const
+{
+	return PolygonType;
+}
+
 //======================================================================================================================
 
 void OdgPolygonItem::setPolygon(const QPolygonF& polygon)
@@ -190,6 +195,11 @@ bool OdgPolygonItem::isValid() const
     return (boundingRect.width() != 0 || boundingRect.height() != 0);
 }
 
+qint64 OdgPolygonItem::memoryUsage() const
+{
+    return OdgItem::memoryUsage() + sizeof(OdgPolygonItem) - sizeof(OdgItem) + mPolygon.capacity() * sizeof(QPointF);
+}
+
 //======================================================================================================================
 
 void OdgPolygonItem::paint(QPainter& painter)
@@ -32,6 +32,7 @@ public:
     OdgPolygonItem();
 
 	OdgItem* copy() const override;
+	Type type() const override;
 
     void setPolygon(const QPolygonF& polygon);
     QPolygonF polygon() const;
@@ -47,6 +48,7 @@ public:
     QRectF boundingRect() const override;
     QPainterPath shape() const override;
     bool isValid() const override;
+    qint64 memoryUsage() const override;
 
 	void paint(QPainter& painter) override;
 
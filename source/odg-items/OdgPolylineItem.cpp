@@ -38,6 +38,11 @@ OdgItem* OdgPolylineItem::copy() const
 	return polylineItem;
 }
 
+OdgItem::Type OdgPolylineItem::type() const
+{
+	return PolylineType;
+}
+
 //======================================================================================================================
 
 void OdgPolylineItem::setPolyline(const QPolygonF& polyline)
@@ -227,12 +232,25 @@ QPainterPath OdgPolylineItem::shape() const
     return shape;
 }
 
+QRectF OdgPolylineItem::paintBoundingRect() const
+{
+    QRectF rect = boundingRect();
+    if (shouldShowStartMarker()) rect = rect.united(mStartMarker.boundingRect(mPen, mPolyline.first()));
+    if (shouldShowEndMarker()) rect = rect.united(mEndMarker.boundingRect(mPen, mPolyline.last()));
+    return rect;
+}
+
 bool OdgPolylineItem::isValid() const
 {
     QRectF boundingRect = mPolyline.boundingRect();
     return (boundingRect.width() != 0 || boundingRect.height() != 0);
 }
 
+qint64 OdgPolylineItem::memoryUsage() const
+{
+    return OdgItem::memoryUsage() + sizeof(OdgPolylineItem) - sizeof(OdgItem) + mPolyline.capacity() * sizeof(QPointF);
+}
+
 //======================================================================================================================
 
 void OdgPolylineItem::paint(QPainter& painter)
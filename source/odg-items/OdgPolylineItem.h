@@ -34,6 +34,7 @@ public:
     OdgPolylineItem();
 
 	OdgItem* copy() const override;
+	Type type() const override;
 
     void setPolyline(const QPolygonF& polyline);
     QPolygonF polyline() const;
@@ -50,7 +51,9 @@ public:
 
     QRectF boundingRect() const override;
     QPainterPath shape() const override;
+    QRectF paintBoundingRect() const override;
     bool isValid() const override;
+    qint64 memoryUsage() const override;
 
     void paint(QPainter& painter) override;
 
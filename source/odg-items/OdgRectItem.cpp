@@ -39,6 +39,11 @@ OdgItem* OdgRectItem::copy() const
 	return rectItem;
 }
 
+OdgItem::Type OdgRectItem::type() const
+{
+	return RectType;
+}
+
 //======================================================================================================================
 
 void OdgRectItem::setRect(const QRectF& rect)
@@ -195,6 +200,11 @@ bool OdgRectItem::isValid() const
     return (mRect.width() > 0 || mRect.height() > 0);
 }
 
+qint64 OdgRectItem::memoryUsage() const
+{
+    return OdgItem::memoryUsage() + sizeof(OdgRectItem) - sizeof(OdgItem);
+}
+
 //======================================================================================================================
 
 void OdgRectItem::paint(QPainter& painter)
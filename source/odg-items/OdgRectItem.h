@@ -38,6 +38,7 @@ public:
     OdgRectItem();
 
 	virtual OdgItem* copy() const override;
+	virtual Type type() const override;
 
 	virtual void setRect(const QRectF& rect);
     QRectF rect() const;
@@ -53,6 +54,7 @@ public:
     virtual QRectF boundingRect() const override;
     virtual QPainterPath shape() const override;
     virtual bool isValid() const override;
+    virtual qint64 memoryUsage() const override;
 
     virtual void paint(QPainter& painter) override;
 
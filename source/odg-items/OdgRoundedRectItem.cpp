@@ -37,6 +37,11 @@ OdgItem* OdgRoundedRectItem::copy() const
 	return rectItem;
 }
 
+OdgItem::Type OdgRoundedRectItem::type() const
+{
+	return RoundedRectType;
+}
+
 //======================================================================================================================
 
 void OdgRoundedRectItem::setCornerRadius(double radius)
@@ -91,6 +96,11 @@ QPainterPath OdgRoundedRectItem::shape() const
     return shape;
 }
 
+qint64 OdgRoundedRectItem::memoryUsage() const
+{
+    return OdgRectItem::memoryUsage() + sizeof(OdgRoundedRectItem) - sizeof(OdgRectItem);
+}
+
 //======================================================================================================================
 
 void OdgRoundedRectItem::paint(QPainter& painter)
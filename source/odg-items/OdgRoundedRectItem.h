@@ -28,6 +28,7 @@ public:
     OdgRoundedRectItem();
 
 	virtual OdgItem* copy() const override;
+	virtual Type type() const override;
 
     void setCornerRadius(double radius);
     double cornerRadius() const;
@@ -36,6 +37,7 @@ public:
 	virtual QVariant property(const QString &name) const override;
 
 	virtual QPainterPath shape() const override;
+	virtual qint64 memoryUsage() const override;
 
 	virtual void paint(QPainter& painter) override;
 
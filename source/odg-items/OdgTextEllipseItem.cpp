@@ -43,6 +43,11 @@ OdgItem* OdgTextEllipseItem::copy() const
 	return textEllipseItem;
 }
 
+OdgItem::Type OdgTextEllipseItem::type() const
+{
+	return TextEllipseType;
+}
+
 //======================================================================================================================
 
 void OdgTextEllipseItem::setCaption(const QString& caption)
@@ -205,6 +210,12 @@ bool OdgTextEllipseItem::isValid() const
     return (OdgEllipseItem::isValid() || !mCaption.isEmpty());
 }
 
+qint64 OdgTextEllipseItem::memoryUsage() const
+{
+    return OdgEllipseItem::memoryUsage() + sizeof(OdgTextEllipseItem) - sizeof(OdgEllipseItem) +
+           stringMemoryUsage(mCaption) + fontMemoryUsage(mFont);
+}
+
 //======================================================================================================================
 
 void OdgTextEllipseItem::paint(QPainter& painter)
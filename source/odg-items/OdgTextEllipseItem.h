@@ -36,6 +36,7 @@ public:
     OdgTextEllipseItem();
 
 	OdgItem* copy() const override;
+	Type type() const override;
 
     void setCaption(const QString& caption);
     QString caption() const;
@@ -55,6 +56,7 @@ public:
     QRectF boundingRect() const override;
     QPainterPath shape() const override;
     bool isValid() const override;
+    qint64 memoryUsage() const override;
 
     void paint(QPainter& painter) override;
 
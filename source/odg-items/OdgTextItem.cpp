@@ -41,6 +41,11 @@ OdgItem* OdgTextItem::copy() const
 	return textItem;
 }
 
+OdgItem::Type OdgTextItem::type() const
+{
+	return TextType;
+}
+
 //======================================================================================================================
 
 void OdgTextItem::setCaption(const QString& caption)
@@ -194,6 +199,12 @@ bool OdgTextItem::isValid() const
     return (!mCaption.isEmpty());
 }
 
+qint64 OdgTextItem::memoryUsage() const
+{
+    return OdgItem::memoryUsage() + sizeof(OdgTextItem) - sizeof(OdgItem) +
+           stringMemoryUsage(mCaption) + fontMemoryUsage(mFont);
+}
+
 //======================================================================================================================
 
 void OdgTextItem::paint(QPainter& painter)
@@ -37,6 +37,7 @@ public:
     OdgTextItem();
 
 	OdgItem* copy() const override;
+	Type type() const override;
 
     void setCaption(const QString& caption);
     QString caption() const;
@@ -56,6 +57,7 @@ public:
     QRectF boundingRect() const override;
     QPainterPath shape() const override;
     bool isValid() const override;
+    qint64 memoryUsage() const override;
 
     void paint(QPainter& painter) override;
 
@@ -44,6 +44,11 @@ OdgItem* OdgTextRoundedRectItem::copy() const
 	return textRectItem;
 }
 
+OdgItem::Type OdgTextRoundedRectItem::type() const
+{
+	return TextRoundedRectType;
+}
+
 //======================================================================================================================
 
 void OdgTextRoundedRectItem::setCaption(const QString& caption)
@@ -206,6 +211,12 @@ bool OdgTextRoundedRectItem::isValid() const
     return (OdgRoundedRectItem::isValid() || !mCaption.isEmpty());
 }
 
+qint64 OdgTextRoundedRectItem::memoryUsage() const
+{
+    return OdgRoundedRectItem::memoryUsage() + sizeof(OdgTextRoundedRectItem) - sizeof(OdgRoundedRectItem) +
+           stringMemoryUsage(mCaption) + fontMemoryUsage(mFont);
+}
+
 //======================================================================================================================
 
 void OdgTextRoundedRectItem::paint(QPainter& painter)
@@ -0,0 +1,189 @@
+// File: OdgConnectionGraph.cpp
+// Copyright (C) 2023  Jason Allen
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "OdgConnectionGraph.h"
+#include "OdgControlPoint.h"
+#include "OdgGluePoint.h"
+#include "OdgItem.h"
+#include <QSet>
+
+OdgConnectionGraph::OdgConnectionGraph() : mDependents(), mConnectionCount(0), mRevision(0), mValid(false)
+{
+    // Nothing more to do here.
+}
+
+//======================================================================================================================
+
+void OdgConnectionGraph::build(const QList<OdgItem*>& items)
+{
+    mDependents.clear();
+    mConnectionCount = 0;
+
+    QList<OdgControlPoint*> controlPoints;
+    OdgGluePoint* gluePoint = nullptr;
+
+    for(auto& item : items)
+    {
+        controlPoints = item->controlPoints();
+        for(auto& controlPoint : qAsConst(controlPoints))
+        {
+            gluePoint = controlPoint->gluePoint();
+            if (gluePoint && gluePoint->item()) addEdge(gluePoint->item(), item);
+        }
+    }
+
+    mRevision = OdgControlPoint::connectionRevision();
+    mValid = true;
+}
+
+void OdgConnectionGraph::clear()
+{
+    mDependents.clear();
+    mConnectionCount = 0;
+    mValid = false;
+}
+
+bool OdgConnectionGraph::isValid() const
+{
+    // Any connection change made outside of this graph invalidates it
+    return (mValid && mRevision == OdgControlPoint::connectionRevision());
+}
+
+//======================================================================================================================
+
+void OdgConnectionGraph::connect(OdgControlPoint* controlPoint, OdgGluePoint* gluePoint)
+{
+    if (controlPoint && gluePoint)
+    {
+        // A control point can only be glued to one glue point at a time
+        if (controlPoint->gluePoint()) disconnect(controlPoint);
+
+        const bool valid = isValid();
+
+        controlPoint->connect(gluePoint);
+
+        if (valid)
+        {
+            if (gluePoint->item() && controlPoint->item()) addEdge(gluePoint->item(), controlPoint->item());
+            mRevision = OdgControlPoint::connectionRevision();
+        }
+    }
+}
+
+void OdgConnectionGraph::disconnect(OdgControlPoint* controlPoint)
+{
+    OdgGluePoint* gluePoint = (controlPoint) ? controlPoint->gluePoint() : nullptr;
+    if (gluePoint)
+    {
+        const bool valid = isValid();
+
+        controlPoint->disconnect();
+
+        if (valid)
+        {
+            if (gluePoint->item() && controlPoint->item()) removeEdge(gluePoint->item(), controlPoint->item());
+            mRevision = OdgControlPoint::connectionRevision();
+        }
+    }
+}
+
+//======================================================================================================================
+
+QList<OdgItem*> OdgConnectionGraph::dependents(OdgItem* item) const
+{
+    return mDependents.value(item);
+}
+
+QList<OdgItem*> OdgConnectionGraph::propagationOrder(const QList<OdgItem*>& items) const
+{
+    // Returns items followed by every item reachable from them, ordered so that each item comes after all of the
+    // reachable items it is glued to.  Each item appears exactly once.  Items that are part of a cycle are appended
+    // at the end in the order they were discovered.
+    const QSet<OdgItem*> sources(items.cbegin(), items.cend());
+
+    // Find all reachable items and count the connections into each one from within the reachable set
+    QList<OdgItem*> reachable = items;
+    QSet<OdgItem*> visited = sources;
+    QHash<OdgItem*,int> inDegree;
+    for(int index = 0; index < reachable.size(); index++)
+    {
+        const auto dependentsIter = mDependents.constFind(reachable.at(index));
+        if (dependentsIter == mDependents.constEnd()) continue;
+
+        for(auto& dependent : dependentsIter.value())
+        {
+            if (sources.contains(dependent)) continue;
+
+            inDegree[dependent]++;
+            if (!visited.contains(dependent))
+            {
+                visited.insert(dependent);
+                reachable.append(dependent);
+            }
+        }
+    }
+
+    // Nothing connected to items; skip the ordering pass entirely
+    if (reachable.size() == items.size()) return items;
+
+    // Topological sort of the reachable items, starting from the source items
+    QList<OdgItem*> order = items;
+    order.reserve(reachable.size());
+    for(int index = 0; index < order.size(); index++)
+    {
+        const auto dependentsIter = mDependents.constFind(order.at(index));
+        if (dependentsIter == mDependents.constEnd()) continue;
+
+        for(auto& dependent : dependentsIter.value())
+        {
+            if (!sources.contains(dependent) && --inDegree[dependent] == 0) order.append(dependent);
+        }
+    }
+
+    // Append any items that are part of a cycle
+    if (order.size() < reachable.size())
+    {
+        for(auto& item : qAsConst(reachable))
+        {
+            if (inDegree.value(item) > 0) order.append(item);
+        }
+    }
+
+    return order;
+}
+
+int OdgConnectionGraph::connectionCount() const
+{
+    return mConnectionCount;
+}
+
+//======================================================================================================================
+
+void OdgConnectionGraph::addEdge(OdgItem* glueItem, OdgItem* controlItem)
+{
+    mDependents[glueItem].append(controlItem);
+    mConnectionCount++;
+}
+
+void OdgConnectionGraph::removeEdge(OdgItem* glueItem, OdgItem* controlItem)
+{
+    auto dependentsIter = mDependents.find(glueItem);
+    if (dependentsIter != mDependents.end() && dependentsIter.value().removeOne(controlItem))
+    {
+        if (dependentsIter.value().isEmpty()) mDependents.erase(dependentsIter);
+        mConnectionCount--;
+    }
+}
@@ -0,0 +1,57 @@
+// File: OdgConnectionGraph.h
+// Copyright (C) 2023  Jason Allen
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef ODGCONNECTIONGRAPH_H
+#define ODGCONNECTIONGRAPH_H
+
+#include <QHash>
+#include <QList>
+
+class OdgControlPoint;
+class OdgGluePoint;
+class OdgItem;
+
+class OdgConnectionGraph
+{
+private:
+    // For each item, the items that have a control point glued to one of its glue points.  An item appears once
+    // per connection, so a wire glued to the same item at both ends is listed twice.
+    QHash<OdgItem*,QList<OdgItem*>> mDependents;
+    int mConnectionCount;
+
+    quint64 mRevision;
+    bool mValid;
+
+public:
+    OdgConnectionGraph();
+
+    void build(const QList<OdgItem*>& items);
+    void clear();
+    bool isValid() const;
+
+    void connect(OdgControlPoint* controlPoint, OdgGluePoint* gluePoint);
+    void disconnect(OdgControlPoint* controlPoint);
+
+    QList<OdgItem*> dependents(OdgItem* item) const;
+    QList<OdgItem*> propagationOrder(const QList<OdgItem*>& items) const;
+    int connectionCount() const;
+
+private:
+    void addEdge(OdgItem* glueItem, OdgItem* controlItem);
+    void removeEdge(OdgItem* glueItem, OdgItem* controlItem);
+};
+
+#endif
@@ -17,6 +17,8 @@
 #include "OdgControlPoint.h"
 #include "OdgGluePoint.h"
 
+QAtomicInteger<quint64> OdgControlPoint::sConnectionRevision(0);
+
 OdgControlPoint::OdgControlPoint(const QPointF& position, bool connectable) :
     mItem(nullptr), mPosition(position), mConnectable(connectable), mGluePoint(nullptr)
 {
@@ -25,6 +27,7 @@ OdgControlPoint::OdgControlPoint(const QPointF& position, bool connectable) :
 
 OdgControlPoint::~OdgControlPoint()
 {
+    if (mGluePoint) sConnectionRevision.fetchAndAddRelaxed(1);
     mGluePoint = nullptr;
 }
 
@@ -67,6 +70,7 @@ void OdgControlPoint::connect(OdgGluePoint* point)
     {
         mGluePoint = point;
         mGluePoint->mConnections.append(this);
+        sConnectionRevision.fetchAndAddRelaxed(1);
     }
 }
 
@@ -76,6 +80,7 @@ void OdgControlPoint::disconnect()
     {
         mGluePoint->mConnections.removeAll(this);
         mGluePoint = nullptr;
+        sConnectionRevision.fetchAndAddRelaxed(1);
     }
 }
 
@@ -83,3 +88,12 @@ OdgGluePoint* OdgControlPoint::gluePoint() const
 {
     return mGluePoint;
 }
+
+//======================================================================================================================
+
+quint64 OdgControlPoint::connectionRevision()
+{
+    // Incremented whenever any control point is connected to or disconnected from a glue point so that cached
+    // connection graphs can tell when they need to be rebuilt
+    return sConnectionRevision.loadRelaxed();
+}
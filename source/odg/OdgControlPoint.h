@@ -17,6 +17,7 @@
 #ifndef ODGCONTROLPOINT_H
 #define ODGCONTROLPOINT_H
 
+#include <QAtomicInteger>
 #include <QPointF>
 
 class OdgGluePoint;
@@ -34,6 +35,8 @@ private:
 
     OdgGluePoint* mGluePoint;
 
+    static QAtomicInteger<quint64> sConnectionRevision;
+
 public:
     OdgControlPoint(const QPointF& position = QPointF(), bool connectable = false);
     ~OdgControlPoint();
@@ -49,6 +52,8 @@ public:
     void connect(OdgGluePoint* point);
     void disconnect();
     OdgGluePoint* gluePoint() const;
+
+    static quint64 connectionRevision();
 };
 
 #endif
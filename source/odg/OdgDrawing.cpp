@@ -241,3 +241,24 @@ QList<OdgPage*> OdgDrawing::pages() const
 {
     return mPages;
 }
+
+//======================================================================================================================
+
+OdgMemoryUsage OdgDrawing::memoryUsage() const
+{
+    OdgMemoryUsage usage;
+    usage.add("Drawing", sizeof(OdgDrawing) + mPages.capacity() * sizeof(OdgPage*));
+
+    for(auto& page : mPages)
+    {
+        const QList<OdgItem*> items = page->items();
+
+        qint64 itemsBytes = 0;
+        for(auto& item : items) itemsBytes += item->memoryUsage();
+
+        usage.add("Pages", page->memoryUsage() - itemsBytes);
+        usage.addItems(items);
+    }
+
+    return usage;
+}
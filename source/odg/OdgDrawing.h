@@ -23,6 +23,7 @@
 #include <QObject>
 #include <QRectF>
 #include "OdgGlobal.h"
+#include "OdgMemoryUsage.h"
 
 class QPainter;
 class OdgPage;
@@ -79,6 +80,8 @@ public:
     virtual void removePage(OdgPage* page);
     void clearPages();
     QList<OdgPage*> pages() const;
+
+    virtual OdgMemoryUsage memoryUsage() const;
 };
 
 #endif
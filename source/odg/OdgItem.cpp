@@ -17,7 +17,7 @@
 #include "OdgItem.h"
 #include "OdgControlPoint.h"
 #include "OdgGluePoint.h"
-#include <QApplication>
+#include <QGuiApplication>
 #include <QPainter>
 
 OdgItem::OdgItem() :
@@ -224,11 +224,33 @@ QVariant OdgItem::property(const QString& name) const
 
 //======================================================================================================================
 
+QRectF OdgItem::paintBoundingRect() const
+{
+    // Everything the item paints, in item coordinates; only differs from boundingRect() for items with markers
+    return boundingRect();
+}
+
 bool OdgItem::isValid() const
 {
     return true;
 }
 
+qint64 OdgItem::memoryUsage() const
+{
+    // Estimate of the memory owned by the item:  the object itself plus its control and glue points.  Derived
+    // classes add the size of their own members and anything those members allocate.
+    qint64 usage = sizeof(OdgItem);
+
+    usage += mControlPoints.capacity() * sizeof(OdgControlPoint*);
+    usage += mControlPoints.size() * sizeof(OdgControlPoint);
+
+    usage += mGluePoints.capacity() * sizeof(OdgGluePoint*);
+    for(auto& gluePoint : mGluePoints)
+        usage += sizeof(OdgGluePoint) + gluePoint->mConnections.capacity() * sizeof(OdgControlPoint*);
+
+    return usage;
+}
+
 //======================================================================================================================
 
 void OdgItem::resize(OdgControlPoint* point, const QPointF& position, bool snapTo45Degrees)
@@ -554,6 +576,24 @@ double OdgItem::calculateTextScaleFactor(const QFont& font) const
 
 //======================================================================================================================
 
+qint64 OdgItem::stringMemoryUsage(const QString& string)
+{
+    return string.capacity() * sizeof(QChar);
+}
+
+qint64 OdgItem::pathMemoryUsage(const QPainterPath& path)
+{
+    return path.elementCount() * sizeof(QPainterPath::Element);
+}
+
+qint64 OdgItem::fontMemoryUsage(const QFont& font)
+{
+    // The font's private data is implicitly shared between copies, so only the family name is counted
+    return stringMemoryUsage(font.family());
+}
+
+//======================================================================================================================
+
 QList<OdgItem*> OdgItem::copyItems(const QList<OdgItem*>& items)
 {
     QList<OdgItem*> copiedItems;
@@ -611,3 +651,40 @@ QList<OdgItem*> OdgItem::copyItems(const QList<OdgItem*>& items)
 
     return copiedItems;
 }
+
+void OdgItem::paintItems(QPainter& painter, const QList<OdgItem*>& items)
+{
+    painter.setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing, true);
+
+    for(auto& item : items)
+    {
+        painter.setTransform(item->transform(), true);
+        item->paint(painter);
+        painter.setTransform(item->transformInverse(), true);
+    }
+}
+
+QRectF OdgItem::itemsBoundingRect(const QList<OdgItem*>& items)
+{
+    QRectF rect;
+    for(auto& item : items)
+        rect = rect.united(item->mapToScene(item->boundingRect()).normalized());
+    return rect;
+}
+
+QList<OdgItem*> OdgItem::itemsInRect(const QList<OdgItem*>& items, const QRectF& rect, double margin)
+{
+    // Used to cull items before painting, so each item is tested against everything it paints (i.e. including its
+    // markers) plus the given margin.  The items keep their order.
+    QList<OdgItem*> itemsInRect;
+    itemsInRect.reserve(items.size());
+    for(auto& item : items)
+    {
+        if (item->mapToScene(item->paintBoundingRect()).normalized().adjusted(-margin, -margin, margin, margin)
+                .intersects(rect))
+        {
+            itemsInRect.append(item);
+        }
+    }
+    return itemsInRect;
+}
@@ -28,6 +28,12 @@ class OdgGluePoint;
 
 class OdgItem
 {
+public:
+    // Each concrete item class reports its own type so that writers can dispatch with a switch instead of trying
+    // dynamic_casts in turn.  Derived types (i.e. PathType, a kind of rect item) are distinct values.
+    enum Type { LineType, CurveType, PolylineType, RectType, RoundedRectType, EllipseType, PolygonType, PathType,
+                TextType, TextRoundedRectType, TextEllipseType, GroupType };
+
 protected:
     QPointF mPosition;
     bool mFlipped;
@@ -44,6 +50,7 @@ public:
     virtual ~OdgItem();
 
     virtual OdgItem* copy() const = 0;
+    virtual Type type() const = 0;
 
     void setPosition(const QPointF& position);
     void setFlipped(bool flipped);
@@ -82,7 +89,9 @@ public:
 
     virtual QRectF boundingRect() const = 0;
     virtual QPainterPath shape() const = 0;
+    virtual QRectF paintBoundingRect() const;
     virtual bool isValid() const;
+    virtual qint64 memoryUsage() const;
 
     virtual void paint(QPainter& painter) = 0;
 
@@ -127,8 +136,15 @@ protected:
                            QRectF& scaledTextRect, double& scaleFactor) const;
     double calculateTextScaleFactor(const QFont& font) const;
 
+    static qint64 stringMemoryUsage(const QString& string);
+    static qint64 pathMemoryUsage(const QPainterPath& path);
+    static qint64 fontMemoryUsage(const QFont& font);
+
 public:
     static QList<OdgItem*> copyItems(const QList<OdgItem*>& items);
+    static void paintItems(QPainter& painter, const QList<OdgItem*>& items);
+    static QRectF itemsBoundingRect(const QList<OdgItem*>& items);
+    static QList<OdgItem*> itemsInRect(const QList<OdgItem*>& items, const QRectF& rect, double margin);
 };
 
 #endif
@@ -78,6 +78,23 @@ QPainterPath OdgMarker::shape(const QPen& pen, const QPointF& position, double a
     return shape;
 }
 
+QRectF OdgMarker::boundingRect(const QPen& pen, const QPointF& position) const
+{
+    QRectF rect;
+
+    if (mStyle != Odg::NoMarker && mSize > 0)
+    {
+        // Large enough to contain the marker at any angle, so that this is cheap compared to shape()
+        const QRectF pathRect = mPath.boundingRect();
+        const double dx = qMax(qAbs(pathRect.left()), qAbs(pathRect.right()));
+        const double dy = qMax(qAbs(pathRect.top()), qAbs(pathRect.bottom()));
+        const double radius = qSqrt(dx * dx + dy * dy) + pen.widthF() / 2;
+        rect = QRectF(position.x() - radius, position.y() - radius, 2 * radius, 2 * radius);
+    }
+
+    return rect;
+}
+
 //======================================================================================================================
 
 void OdgMarker::paint(QPainter& painter, const QPen& pen, const QPointF& position, double angle)
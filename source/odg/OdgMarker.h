@@ -40,6 +40,7 @@ public:
     double size() const;
 
     QPainterPath shape(const QPen& pen, const QPointF& position, double angle) const;
+    QRectF boundingRect(const QPen& pen, const QPointF& position) const;
 
     void paint(QPainter& painter, const QPen& pen, const QPointF& position, double angle);
 
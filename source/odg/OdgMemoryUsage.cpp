@@ -0,0 +1,117 @@
+// File: OdgMemoryUsage.cpp
+// Copyright (C) 2023  Jason Allen
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "OdgMemoryUsage.h"
+#include "OdgGroupItem.h"
+
+OdgMemoryUsage::OdgMemoryUsage() : mCategories()
+{
+    // Nothing more to do here.
+}
+
+//======================================================================================================================
+
+void OdgMemoryUsage::add(const QString& name, qint64 bytes, int count)
+{
+    for(auto& category : mCategories)
+    {
+        if (category.name == name)
+        {
+            category.count += count;
+            category.bytes += bytes;
+            return;
+        }
+    }
+
+    Category category;
+    category.name = name;
+    category.count = count;
+    category.bytes = bytes;
+    mCategories.append(category);
+}
+
+void OdgMemoryUsage::addItems(const QList<OdgItem*>& items)
+{
+    for(auto& item : items)
+    {
+        if (item->type() == OdgItem::GroupType)
+        {
+            // Charge the group only for itself; its grouped items are counted under their own types
+            const QList<OdgItem*> groupItems = static_cast<OdgGroupItem*>(item)->items();
+            qint64 groupItemsBytes = 0;
+            for(auto& groupedItem : groupItems) groupItemsBytes += groupedItem->memoryUsage();
+
+            add(itemTypeName(item), item->memoryUsage() - groupItemsBytes);
+            addItems(groupItems);
+        }
+        else add(itemTypeName(item), item->memoryUsage());
+    }
+}
+
+//======================================================================================================================
+
+QList<OdgMemoryUsage::Category> OdgMemoryUsage::categories() const
+{
+    return mCategories;
+}
+
+qint64 OdgMemoryUsage::totalBytes() const
+{
+    qint64 bytes = 0;
+    for(auto& category : mCategories) bytes += category.bytes;
+    return bytes;
+}
+
+//======================================================================================================================
+
+QString OdgMemoryUsage::itemTypeName(OdgItem* item)
+{
+    switch (item->type())
+    {
+    case OdgItem::LineType:
+        return "Line";
+    case OdgItem::CurveType:
+        return "Curve";
+    case OdgItem::PolylineType:
+        return "Polyline";
+    case OdgItem::RectType:
+        return "Rect";
+    case OdgItem::RoundedRectType:
+        return "Rounded Rect";
+    case OdgItem::EllipseType:
+        return "Ellipse";
+    case OdgItem::PolygonType:
+        return "Polygon";
+    case OdgItem::PathType:
+        return "Path";
+    case OdgItem::TextType:
+        return "Text";
+    case OdgItem::TextRoundedRectType:
+        return "Text Rounded Rect";
+    case OdgItem::TextEllipseType:
+        return "Text Ellipse";
+    case OdgItem::GroupType:
+        return "Group";
+    }
+    return "Item";
+}
+
+QString OdgMemoryUsage::formatBytes(qint64 bytes)
+{
+    if (bytes >= 1024 * 1024) return QString::number(bytes / (1024.0 * 1024.0), 'f', 2) + " MB";
+    if (bytes >= 1024) return QString::number(bytes / 1024.0, 'f', 1) + " kB";
+    return QString::number(bytes) + " B";
+}
@@ -0,0 +1,52 @@
+// File: OdgMemoryUsage.h
+// Copyright (C) 2023  Jason Allen
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef ODGMEMORYUSAGE_H
+#define ODGMEMORYUSAGE_H
+
+#include <QList>
+#include <QString>
+
+class OdgItem;
+
+// Estimated memory usage of a drawing, broken down into named categories such as one per item type
+class OdgMemoryUsage
+{
+public:
+    struct Category
+    {
+        QString name;
+        int count;
+        qint64 bytes;
+    };
+
+private:
+    QList<Category> mCategories;
+
+public:
+    OdgMemoryUsage();
+
+    void add(const QString& name, qint64 bytes, int count = 1);
+    void addItems(const QList<OdgItem*>& items);
+
+    QList<Category> categories() const;
+    qint64 totalBytes() const;
+
+    static QString itemTypeName(OdgItem* item);
+    static QString formatBytes(qint64 bytes);
+};
+
+#endif
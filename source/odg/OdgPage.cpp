@@ -79,3 +79,12 @@ QList<OdgItem*> OdgPage::items() const
 {
     return mItems;
 }
+
+//======================================================================================================================
+
+qint64 OdgPage::memoryUsage() const
+{
+    qint64 usage = sizeof(OdgPage) + mName.capacity() * sizeof(QChar) + mItems.capacity() * sizeof(OdgItem*);
+    for(auto& item : mItems) usage += item->memoryUsage();
+    return usage;
+}
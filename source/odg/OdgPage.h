@@ -45,6 +45,8 @@ public:
     void removeItem(OdgItem* item);
     void clearItems();
     QList<OdgItem*> items() const;
+
+    qint64 memoryUsage() const;
 };
 
 #endif
@@ -15,8 +15,8 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "OdgReader.h"
-#include <QApplication>
 #include <QClipboard>
+#include <QGuiApplication>
 #include <QRegularExpression>
 #include <QRegularExpression>
 #include <QXmlStreamReader>
@@ -39,7 +39,7 @@
 OdgReader::OdgReader(const QString& fileName) :
     mUnits(Odg::UnitsInches), mPageSize(8.2, 6.2), mPageMargins(0.1, 0.1, 0.1, 0.1), mBackgroundColor(255, 255, 255),
     mGrid(0.05), mGridStyle(Odg::GridLines), mGridColor(77, 153, 153), mGridSpacingMajor(8), mGridSpacingMinor(2),
-    mPages(), mFile(fileName)
+    mPages(), mSkippedElements(), mFile(fileName)
 {
     // Nothing more to do here.
 }
@@ -127,6 +127,11 @@ QList<OdgPage*> OdgReader::takePages()
     return pages;
 }
 
+QMap<QString,int> OdgReader::skippedElements() const
+{
+    return mSkippedElements;
+}
+
 //======================================================================================================================
 
 bool OdgReader::open()
@@ -181,11 +186,14 @@ bool OdgReader::read()
 
 void OdgReader::readFromClipboard()
 {
-    QString clipboardText = QApplication::clipboard()->text();
+    readFromString(QGuiApplication::clipboard()->text());
+}
 
-    if (!clipboardText.isEmpty())
+void OdgReader::readFromString(const QString& text)
+{
+    if (!text.isEmpty())
     {
-        QXmlStreamReader xml(clipboardText);
+        QXmlStreamReader xml(text);
         if (!xml.readNextStartElement() || xml.qualifiedName() == QStringLiteral("office:document"))
         {
             // No attributes for <office:document> element
@@ -834,7 +842,12 @@ QList<OdgItem*> OdgReader::readItems(QXmlStreamReader& xml)
         else
             xml.skipCurrentElement();
 
-        if (item) items.append(item);
+        // The reader is now positioned at the element's end tag, so its name is still available here.  Elements
+        // that are unsupported or that didn't produce a valid item are counted so that conversions can report them.
+        if (item)
+            items.append(item);
+        else
+            mSkippedElements[xml.qualifiedName().toString()]++;
     }
 
     return items;
@@ -20,6 +20,7 @@
 #include <QColor>
 #include <QFile>
 #include <QList>
+#include <QMap>
 #include <QMarginsF>
 #include <QPainterPath>
 #include <QRectF>
@@ -49,6 +50,7 @@ private:
 
     QList<OdgStyle*> mStyles;
     QList<OdgPage*> mPages;
+    QMap<QString,int> mSkippedElements;
 
     QFile mFile;
 
@@ -73,11 +75,14 @@ public:
     OdgStyle* takeDefaultStyle();
     QList<OdgPage*> takePages();
 
+    QMap<QString,int> skippedElements() const;
+
     bool open();
     void close();
 
     bool read();
     void readFromClipboard();
+    void readFromString(const QString& text);
 
 private:
     void readDocumentSettings(QXmlStreamReader& xml);
@@ -69,6 +69,11 @@ OdgStyle* OdgStyle::parent() const
     return mParent;
 }
 
+qint64 OdgStyle::memoryUsage() const
+{
+    return sizeof(OdgStyle) + (mName.capacity() + mFontFamily.capacity()) * sizeof(QChar);
+}
+
 //======================================================================================================================
 
 void OdgStyle::setPenStyle(Qt::PenStyle style)
@@ -81,6 +81,8 @@ public:
     QString name() const;
     OdgStyle* parent() const;
 
+    qint64 memoryUsage() const;
+
     void setPenStyle(Qt::PenStyle style);
     void setPenWidth(double width);
     void setPenColor(const QColor& color);
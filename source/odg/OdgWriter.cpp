@@ -28,8 +28,8 @@
 #include "OdgTextItem.h"
 #include "OdgTextEllipseItem.h"
 #include "OdgTextRoundedRectItem.h"
-#include <QApplication>
 #include <QClipboard>
+#include <QGuiApplication>
 #include <QPainter>
 #include <QXmlStreamWriter>
 #include <quazip.h>
@@ -199,6 +199,11 @@ bool OdgWriter::write()
 }
 
 void OdgWriter::writeToClipboard()
+{
+    QGuiApplication::clipboard()->setText(writeToString());
+}
+
+QString OdgWriter::writeToString()
 {
     QString clipboardText;
 
@@ -234,7 +239,7 @@ void OdgWriter::writeToClipboard()
     xml.writeEndElement();
     xml.writeEndDocument();
 
-    QApplication::clipboard()->setText(clipboardText);
+    return clipboardText;
 }
 
 //======================================================================================================================
@@ -257,10 +262,9 @@ void OdgWriter::analyzeItemForStyles(OdgItem* item)
 {
     mItemStyles.insert(item, findOrCreateStyle(item));
 
-    OdgGroupItem* groupItem = dynamic_cast<OdgGroupItem*>(item);
-    if (groupItem)
+    if (item->type() == OdgItem::GroupType)
     {
-        const QList<OdgItem*> items = groupItem->items();
+        const QList<OdgItem*> items = static_cast<OdgGroupItem*>(item)->items();
         for(auto& item : items) analyzeItemForStyles(item);
     }
 }
@@ -314,8 +318,7 @@ OdgStyle* OdgWriter::findOrCreateStyle(OdgItem* item)
     if (hasTextPadding) newStyle->setTextPaddingIfNeeded(textPadding);
     if (hasTextColor) newStyle->setTextColorIfNeeded(textColor);
 
-    OdgTextItem* textItem = dynamic_cast<OdgTextItem*>(item);
-    if (textItem)
+    if (item->type() == OdgItem::TextType)
     {
         newStyle->setPenStyleIfNeeded(Qt::NoPen);
         newStyle->setBrushColorIfNeeded(QColor(mBackgroundColor.red(), mBackgroundColor.green(),
@@ -1160,106 +1163,49 @@ void OdgWriter::writeItems(QXmlStreamWriter& xml, const QList<OdgItem*>& items)
     OdgStyle* style = nullptr;
     QString styleName;
 
-    OdgCurveItem* curveItem = nullptr;
-    OdgEllipseItem* ellipseItem = nullptr;
-    OdgGroupItem* groupItem = nullptr;
-    OdgLineItem* lineItem = nullptr;
-    OdgPathItem* pathItem = nullptr;
-    OdgPolygonItem* polygonItem = nullptr;
-    OdgPolylineItem* polylineItem = nullptr;
-    OdgRectItem* rectItem = nullptr;
-    OdgRoundedRectItem* roundedRectItem = nullptr;
-    OdgTextEllipseItem* textEllipseItem = nullptr;
-    OdgTextItem* textItem = nullptr;
-    OdgTextRoundedRectItem* textRoundedRectItem = nullptr;
-
     for(auto& item : items)
     {
         style = mItemStyles.value(item);
         styleName = (style) ? style->name() : "";
 
-        lineItem = dynamic_cast<OdgLineItem*>(item);
-        if (lineItem)
-        {
-            writeLineItem(xml, lineItem, styleName);
-            continue;
-        }
-
-        curveItem = dynamic_cast<OdgCurveItem*>(item);
-        if (curveItem)
-        {
-            writeCurveItem(xml, curveItem, styleName);
-            continue;
-        }
-
-        polylineItem = dynamic_cast<OdgPolylineItem*>(item);
-        if (polylineItem)
-        {
-            writePolylineItem(xml, polylineItem, styleName);
-            continue;
-        }
-
-        textItem = dynamic_cast<OdgTextItem*>(item);
-        if (textItem)
-        {
-            writeTextItem(xml, textItem, styleName);
-            continue;
-        }
-
-        textRoundedRectItem = dynamic_cast<OdgTextRoundedRectItem*>(item);
-        if (textRoundedRectItem)
-        {
-            writeTextRoundedRectItem(xml, textRoundedRectItem, styleName);
-            continue;
-        }
-
-        roundedRectItem = dynamic_cast<OdgRoundedRectItem*>(item);
-        if (roundedRectItem)
-        {
-            writeRoundedRectItem(xml, roundedRectItem, styleName);
-            continue;
-        }
-
-        textEllipseItem = dynamic_cast<OdgTextEllipseItem*>(item);
-        if (textEllipseItem)
-        {
-            writeTextEllipseItem(xml, textEllipseItem, styleName);
-            continue;
-        }
-
-        ellipseItem = dynamic_cast<OdgEllipseItem*>(item);
-        if (ellipseItem)
+        switch (item->type())
         {
-            writeEllipseItem(xml, ellipseItem, styleName);
-            continue;
-        }
-
-        pathItem = dynamic_cast<OdgPathItem*>(item);
-        if (pathItem)
-        {
-            writePathItem(xml, pathItem, styleName);
-            continue;
-        }
-
-        rectItem = dynamic_cast<OdgRectItem*>(item);
-        if (rectItem)
-        {
-            writeRectItem(xml, rectItem, styleName);
-            continue;
-        }
-
-        polygonItem = dynamic_cast<OdgPolygonItem*>(item);
-        if (polygonItem)
-        {
-            writePolygonItem(xml, polygonItem, styleName);
-            continue;
-        }
-
-        groupItem = dynamic_cast<OdgGroupItem*>(item);
-        if (groupItem)
-        {
-            writeGroupItem(xml, groupItem, styleName);
-            continue;
+        case OdgItem::LineType:
+            writeLineItem(xml, static_cast<OdgLineItem*>(item), styleName);
+            break;
+        case OdgItem::CurveType:
+            writeCurveItem(xml, static_cast<OdgCurveItem*>(item), styleName);
+            break;
+        case OdgItem::PolylineType:
+            writePolylineItem(xml, static_cast<OdgPolylineItem*>(item), styleName);
+            break;
+        case OdgItem::RectType:
+            writeRectItem(xml, static_cast<OdgRectItem*>(item), styleName);
+            break;
+        case OdgItem::RoundedRectType:
+            writeRoundedRectItem(xml, static_cast<OdgRoundedRectItem*>(item), styleName);
+            break;
+        case OdgItem::EllipseType:
+            writeEllipseItem(xml, static_cast<OdgEllipseItem*>(item), styleName);
+            break;
+        case OdgItem::PolygonType:
+            writePolygonItem(xml, static_cast<OdgPolygonItem*>(item), styleName);
+            break;
+        case OdgItem::PathType:
+            writePathItem(xml, static_cast<OdgPathItem*>(item), styleName);
+            break;
+        case OdgItem::TextType:
+            writeTextItem(xml, static_cast<OdgTextItem*>(item), styleName);
+            break;
+        case OdgItem::TextRoundedRectType:
+            writeTextRoundedRectItem(xml, static_cast<OdgTextRoundedRectItem*>(item), styleName);
+            break;
+        case OdgItem::TextEllipseType:
+            writeTextEllipseItem(xml, static_cast<OdgTextEllipseItem*>(item), styleName);
+            break;
+        case OdgItem::GroupType:
+            writeGroupItem(xml, static_cast<OdgGroupItem*>(item), styleName);
+            break;
         }
     }
 }
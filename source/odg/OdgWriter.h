@@ -91,6 +91,7 @@ public:
 
     bool write();
     void writeToClipboard();
+    QString writeToString();
 
 private:
     void analyzeDrawingForStyles();
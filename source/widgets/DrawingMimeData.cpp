@@ -0,0 +1,178 @@
+// File: DrawingMimeData.cpp
+// Copyright (C) 2023  Jason Allen
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "DrawingMimeData.h"
+#include "DrawingWidget.h"
+#include "OdgItem.h"
+#include "OdgPage.h"
+#include "OdgStyle.h"
+#include "OdgWriter.h"
+#include "version.h"
+#include <QAtomicInteger>
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QMutex>
+#include <QRandomGenerator>
+
+const QString DrawingMimeData::MimeType = "application/x-jade-copy-token";
+
+static const quint32 sTokenMagic = 0x4A414445;      // "JADE"
+static const quint16 sTokenVersion = 2;
+
+// Copies may be made from any thread, so the serial is atomic and the current copy is only touched under the mutex
+static QAtomicInteger<quint64> sNextSerial(1);
+static DrawingMimeData* sCurrentData = nullptr;
+static QMutex sCurrentDataMutex;
+
+static quint64 processKey()
+{
+    // Process ids are reused, so each process also stamps its tokens with a random key of its own
+    static const quint64 key = QRandomGenerator::system()->generate64();
+    return key;
+}
+
+//======================================================================================================================
+
+DrawingMimeData::DrawingMimeData(const DrawingWidget* drawing, const QString& pageName, const QList<OdgItem*>& items) :
+    QMimeData(), mSerial(sNextSerial.fetchAndAddRelaxed(1)), mUnits(drawing->units()), mPageSize(drawing->pageSize()),
+    mPageMargins(drawing->pageMargins()), mBackgroundColor(drawing->backgroundColor()), mGrid(drawing->grid()),
+    mGridStyle(drawing->gridStyle()), mGridColor(drawing->gridColor()),
+    mGridSpacingMajor(drawing->gridSpacingMajor()), mGridSpacingMinor(drawing->gridSpacingMinor()),
+    mDefaultStyle(drawing->defaultStyle() ? new OdgStyle(*drawing->defaultStyle()) : new OdgStyle(mUnits, true)),
+    mPageName(pageName), mItems(OdgItem::copyItems(items)), mXmlText()
+{
+    QMutexLocker locker(&sCurrentDataMutex);
+    sCurrentData = this;
+}
+
+DrawingMimeData::~DrawingMimeData()
+{
+    {
+        QMutexLocker locker(&sCurrentDataMutex);
+        if (sCurrentData == this) sCurrentData = nullptr;
+    }
+
+    qDeleteAll(mItems);
+    delete mDefaultStyle;
+}
+
+//======================================================================================================================
+
+Odg::Units DrawingMimeData::units() const
+{
+    return mUnits;
+}
+
+QList<OdgItem*> DrawingMimeData::items() const
+{
+    return mItems;
+}
+
+//======================================================================================================================
+
+QStringList DrawingMimeData::formats() const
+{
+    return QStringList({MimeType, "text/plain"});
+}
+
+//======================================================================================================================
+
+QByteArray DrawingMimeData::toToken() const
+{
+    QByteArray data;
+
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << sTokenMagic << sTokenVersion << QString(PROJECT_VERSION);
+    stream << QCoreApplication::applicationPid() << processKey() << mSerial;
+
+    return data;
+}
+
+QString DrawingMimeData::toXml() const
+{
+    if (mXmlText.isEmpty() && !mItems.isEmpty())
+    {
+        OdgWriter writer;
+        writer.setUnits(mUnits);
+        writer.setPageSize(mPageSize);
+        writer.setPageMargins(mPageMargins);
+        writer.setBackgroundColor(mBackgroundColor);
+        writer.setGrid(mGrid);
+        writer.setGridStyle(mGridStyle);
+        writer.setGridColor(mGridColor);
+        writer.setGridSpacingMajor(mGridSpacingMajor);
+        writer.setGridSpacingMinor(mGridSpacingMinor);
+
+        writer.setDefaultStyle(mDefaultStyle);
+
+        // The page only borrows the items for the duration of the write
+        OdgPage page(mPageName);
+        for(auto& item : qAsConst(mItems)) page.addItem(item);
+        writer.setPages(QList<OdgPage*>(1, &page));
+        mXmlText = writer.writeToString();
+        for(auto& item : qAsConst(mItems)) page.removeItem(item);
+    }
+
+    return mXmlText;
+}
+
+//======================================================================================================================
+
+QVariant DrawingMimeData::retrieveData(const QString& mimeType, QMetaType type) const
+{
+    if (mimeType == MimeType) return toToken();
+    if (mimeType == QStringLiteral("text/plain")) return toXml();
+    return QMimeData::retrieveData(mimeType, type);
+}
+
+//======================================================================================================================
+
+const DrawingMimeData* DrawingMimeData::fromMimeData(const QMimeData* mimeData)
+{
+    if (!mimeData) return nullptr;
+
+    // Usually the clipboard hands back the same object that this process put there
+    const DrawingMimeData* drawingData = qobject_cast<const DrawingMimeData*>(mimeData);
+    if (drawingData) return drawingData;
+
+    // Otherwise check whether the token refers to the copy that this process is still holding.  Tokens written by
+    // any other process never match, and the caller falls back to the XML for those.
+    if (mimeData->hasFormat(MimeType))
+    {
+        QDataStream stream(mimeData->data(MimeType));
+        stream.setVersion(QDataStream::Qt_6_0);
+
+        quint32 magic = 0;
+        quint16 version = 0;
+        QString applicationVersion;
+        qint64 processId = 0;
+        quint64 key = 0;
+        quint64 serial = 0;
+        stream >> magic >> version >> applicationVersion >> processId >> key >> serial;
+
+        if (stream.status() == QDataStream::Ok && stream.atEnd() && magic == sTokenMagic &&
+            version == sTokenVersion && applicationVersion == PROJECT_VERSION &&
+            processId == QCoreApplication::applicationPid() && key == processKey())
+        {
+            QMutexLocker locker(&sCurrentDataMutex);
+            if (sCurrentData && serial == sCurrentData->mSerial) return sCurrentData;
+        }
+    }
+
+    return nullptr;
+}
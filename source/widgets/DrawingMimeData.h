@@ -0,0 +1,82 @@
+// File: DrawingMimeData.h
+// Copyright (C) 2023  Jason Allen
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef DRAWINGMIMEDATA_H
+#define DRAWINGMIMEDATA_H
+
+#include <QColor>
+#include <QMarginsF>
+#include <QMimeData>
+#include "OdgGlobal.h"
+
+class DrawingWidget;
+class OdgItem;
+class OdgStyle;
+
+// Clipboard data for copied items.  The items are held as copies so that pastes within this process are a
+// OdgItem::copyItems() away, with no serialization at all.  The ODF XML needed by other applications is only written
+// if one of them actually asks for it.  The items themselves are never serialized in any other format: MimeType only
+// carries a token (application version, process id and key, and serial number) that lets this process find its own
+// copy on platforms that hand the clipboard back as a copy.  Tokens from other processes are rejected, so pastes from
+// them always go through the XML.
+class DrawingMimeData : public QMimeData
+{
+    Q_OBJECT
+
+public:
+    static const QString MimeType;
+
+private:
+    quint64 mSerial;
+
+    Odg::Units mUnits;
+    QSizeF mPageSize;
+    QMarginsF mPageMargins;
+    QColor mBackgroundColor;
+
+    double mGrid;
+    Odg::GridStyle mGridStyle;
+    QColor mGridColor;
+    int mGridSpacingMajor;
+    int mGridSpacingMinor;
+
+    OdgStyle* mDefaultStyle;
+    QString mPageName;
+    QList<OdgItem*> mItems;
+
+    mutable QString mXmlText;
+
+public:
+    DrawingMimeData(const DrawingWidget* drawing, const QString& pageName, const QList<OdgItem*>& items);
+    ~DrawingMimeData();
+
+    Odg::Units units() const;
+    QList<OdgItem*> items() const;
+
+    QStringList formats() const override;
+
+    QByteArray toToken() const;
+    QString toXml() const;
+
+protected:
+    QVariant retrieveData(const QString& mimeType, QMetaType type) const override;
+
+public:
+    static const DrawingMimeData* fromMimeData(const QMimeData* mimeData);
+};
+
+#endif
@@ -0,0 +1,197 @@
+// File: DrawingProfiler.cpp
+// Copyright (C) 2023  Jason Allen
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "DrawingProfiler.h"
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+#include <atomic>
+
+DrawingProfiler::Slot DrawingProfiler::sSlots[DrawingProfiler::sCapacity];
+QAtomicInteger<quint64> DrawingProfiler::sWriteIndex = 0;
+QAtomicInt DrawingProfiler::sEnabled = 0;
+
+// Started once during static initialization, so that threads recording events never race to start it
+static QElapsedTimer startedClock()
+{
+    QElapsedTimer clock;
+    clock.start();
+    return clock;
+}
+
+static const QElapsedTimer sClock = startedClock();
+
+//======================================================================================================================
+
+void DrawingProfiler::setEnabled(bool enabled)
+{
+    sEnabled.storeRelease(enabled ? 1 : 0);
+}
+
+bool DrawingProfiler::isEnabled()
+{
+    return (sEnabled.loadRelaxed() != 0);
+}
+
+void DrawingProfiler::clear()
+{
+    for(int i = 0; i < sCapacity; i++)
+        sSlots[i].sequence.storeRelaxed(0);
+    sWriteIndex.storeRelease(0);
+}
+
+//======================================================================================================================
+
+qint64 DrawingProfiler::now()
+{
+    return sClock.nsecsElapsed();
+}
+
+void DrawingProfiler::addDuration(const char* name, qint64 start, qint64 duration)
+{
+    if (isEnabled())
+    {
+        const Event event = { name, DurationEvent, start, duration, 0,
+                              reinterpret_cast<quintptr>(QThread::currentThreadId()) };
+        addEvent(event);
+    }
+}
+
+void DrawingProfiler::addCounter(const char* name, qint64 value)
+{
+    if (isEnabled())
+    {
+        const Event event = { name, CounterEvent, now(), 0, value,
+                              reinterpret_cast<quintptr>(QThread::currentThreadId()) };
+        addEvent(event);
+    }
+}
+
+//======================================================================================================================
+
+QList<DrawingProfiler::Event> DrawingProfiler::events()
+{
+    QList<Event> events;
+
+    // Walk the most recent sCapacity slots in order.  A slot whose sequence doesn't match the index being read was
+    // either overwritten or is still being written by another thread, so it is skipped rather than read torn.
+    const quint64 end = sWriteIndex.loadAcquire();
+    const quint64 begin = (end > sCapacity) ? end - sCapacity : 0;
+    events.reserve(static_cast<int>(end - begin));
+
+    for(quint64 index = begin; index < end; index++)
+    {
+        const Slot& slot = sSlots[index % sCapacity];
+        if (slot.sequence.loadAcquire() != index + 1) continue;
+
+        const Event event = { slot.name.loadRelaxed(), static_cast<EventType>(slot.type.loadRelaxed()),
+                              slot.start.loadRelaxed(), slot.duration.loadRelaxed(), slot.value.loadRelaxed(),
+                              slot.thread.loadRelaxed() };
+
+        // Order the field reads before the second sequence check, so that a writer that started meanwhile is seen
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.loadRelaxed() == index + 1) events.append(event);
+    }
+
+    return events;
+}
+
+bool DrawingProfiler::exportChromeTrace(const QString& fileName)
+{
+    const QList<Event> recordedEvents = events();
+
+    // Chrome's trace format wants small integer thread ids
+    QHash<quintptr,int> threadIds;
+    QJsonArray traceEvents;
+    for(auto& event : recordedEvents)
+    {
+        if (!threadIds.contains(event.thread)) threadIds.insert(event.thread, threadIds.size() + 1);
+
+        QJsonObject traceEvent;
+        traceEvent.insert("name", QString::fromLatin1(event.name));
+        traceEvent.insert("cat", "jade");
+        traceEvent.insert("pid", 1);
+        traceEvent.insert("tid", threadIds.value(event.thread));
+        traceEvent.insert("ts", event.start / 1000.0);
+
+        if (event.type == DurationEvent)
+        {
+            traceEvent.insert("ph", "X");
+            traceEvent.insert("dur", event.duration / 1000.0);
+        }
+        else
+        {
+            QJsonObject args;
+            args.insert("value", event.value);
+            traceEvent.insert("ph", "C");
+            traceEvent.insert("args", args);
+        }
+
+        traceEvents.append(traceEvent);
+    }
+
+    QJsonObject trace;
+    trace.insert("traceEvents", traceEvents);
+    trace.insert("displayTimeUnit", "ms");
+
+    QFile file(fileName);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate)) return false;
+    return (file.write(QJsonDocument(trace).toJson(QJsonDocument::Compact)) >= 0);
+}
+
+//======================================================================================================================
+
+void DrawingProfiler::addEvent(const Event& event)
+{
+    // Claim a slot, invalidate it while writing, then publish it with the claimed index
+    const quint64 index = sWriteIndex.fetchAndAddAcquire(1);
+    Slot& slot = sSlots[index % sCapacity];
+    slot.sequence.storeRelaxed(0);
+
+    // Order the invalidation before the field writes, so that a reader that sees any new field also sees it
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.storeRelaxed(event.name);
+    slot.type.storeRelaxed(event.type);
+    slot.start.storeRelaxed(event.start);
+    slot.duration.storeRelaxed(event.duration);
+    slot.value.storeRelaxed(event.value);
+    slot.thread.storeRelaxed(event.thread);
+    slot.sequence.storeRelease(index + 1);
+}
+
+//======================================================================================================================
+//======================================================================================================================
+//======================================================================================================================
+
+DrawingProfileScope::DrawingProfileScope(const char* name) :
+    mName(name), mStart(DrawingProfiler::isEnabled() ? DrawingProfiler::now() : -1)
+{
+    // Nothing more to do here.
+}
+
+DrawingProfileScope::~DrawingProfileScope()
+{
+    if (mStart >= 0) DrawingProfiler::addDuration(mName, mStart, DrawingProfiler::now() - mStart);
+}
+
+qint64 DrawingProfileScope::elapsed() const
+{
+    return (mStart >= 0) ? DrawingProfiler::now() - mStart : 0;
+}
@@ -0,0 +1,93 @@
+// File: DrawingProfiler.h
+// Copyright (C) 2023  Jason Allen
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef DRAWINGPROFILER_H
+#define DRAWINGPROFILER_H
+
+#include <QAtomicInteger>
+#include <QAtomicPointer>
+#include <QList>
+#include <QString>
+
+// Opt-in instrumentation for DrawingWidget.  While enabled, scoped timers and counters are recorded into a fixed-size
+// lock-free ring buffer; the most recent events can be read back for the on-screen overlay or exported as a Chrome
+// trace (chrome://tracing, Perfetto).  When disabled, each DrawingProfileScope costs a single atomic load.
+class DrawingProfiler
+{
+public:
+    enum EventType { DurationEvent, CounterEvent };
+
+    struct Event
+    {
+        const char* name;
+        EventType type;
+        qint64 start;
+        qint64 duration;
+        qint64 value;
+        quintptr thread;
+    };
+
+private:
+    // A seqlock: the sequence is zero while the slot is being written and the claimed index + 1 once it is
+    // published.  The event fields are relaxed atomics so that a reader racing with a writer never reads them torn.
+    struct Slot
+    {
+        QAtomicInteger<quint64> sequence;
+        QAtomicPointer<const char> name;
+        QAtomicInt type;
+        QAtomicInteger<qint64> start;
+        QAtomicInteger<qint64> duration;
+        QAtomicInteger<qint64> value;
+        QAtomicInteger<quintptr> thread;
+    };
+
+    static const int sCapacity = 65536;
+    static Slot sSlots[sCapacity];
+    static QAtomicInteger<quint64> sWriteIndex;
+    static QAtomicInt sEnabled;
+
+public:
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+    static void clear();
+
+    static qint64 now();
+    static void addDuration(const char* name, qint64 start, qint64 duration);
+    static void addCounter(const char* name, qint64 value);
+
+    static QList<Event> events();
+    static bool exportChromeTrace(const QString& fileName);
+
+private:
+    static void addEvent(const Event& event);
+};
+
+//======================================================================================================================
+
+class DrawingProfileScope
+{
+private:
+    const char* mName;
+    qint64 mStart;
+
+public:
+    DrawingProfileScope(const char* name);
+    ~DrawingProfileScope();
+
+    qint64 elapsed() const;
+};
+
+#endif
@@ -19,6 +19,11 @@
 #include "OdgControlPoint.h"
 #include "OdgGroupItem.h"
 #include "OdgPage.h"
+#include "OdgPathItem.h"
+#include "OdgReader.h"
+#include "OdgWriter.h"
+#include <QDataStream>
+#include <QTemporaryFile>
 
 DrawingUndoCommand::DrawingUndoCommand(const QString& text) : QUndoCommand(text), mPage(nullptr), mViewRect()
 {
@@ -41,12 +46,311 @@ void DrawingUndoCommand::restoreView(DrawingWidget* drawing)
     drawing->ensureVisible(mViewRect);
 }
 
+//======================================================================================================================
+
+qint64 DrawingUndoCommand::footprint() const
+{
+    return sizeof(DrawingUndoCommand) + text().size() * sizeof(QChar);
+}
+
+bool DrawingUndoCommand::references(const QSet<OdgItem*>& items) const
+{
+    Q_UNUSED(items);
+    return false;
+}
+
+//======================================================================================================================
+
+bool DrawingUndoCommand::canSpill() const
+{
+    return false;
+}
+
+bool DrawingUndoCommand::isSpilled() const
+{
+    return false;
+}
+
+QList<OdgItem*> DrawingUndoCommand::spillItems() const
+{
+    return QList<OdgItem*>();
+}
+
+void DrawingUndoCommand::spill()
+{
+    // Nothing to do here.
+}
+
+//======================================================================================================================
+
+qint64 DrawingUndoCommand::itemsFootprint(const QList<OdgItem*>& items)
+{
+    // Memory owned by the items themselves; a group's usage includes its grouped items
+    qint64 footprint = items.size() * sizeof(OdgItem*);
+    for(auto& item : items) footprint += item->memoryUsage();
+    return footprint;
+}
+
+qint64 DrawingUndoCommand::variantFootprint(const QVariant& value)
+{
+    qint64 footprint = sizeof(QVariant);
+    if (value.typeId() == QMetaType::QString) footprint += value.toString().size() * sizeof(QChar);
+    return footprint;
+}
+
+bool DrawingUndoCommand::containsAny(const QList<OdgItem*>& list, const QSet<OdgItem*>& items)
+{
+    for(auto& item : list)
+    {
+        if (items.contains(item)) return true;
+    }
+    return false;
+}
+
+//======================================================================================================================
+//======================================================================================================================
+//======================================================================================================================
+
+DrawingUndoStack::DrawingUndoStack() : QObject(), mCommands(), mIndex(0), mCleanIndex(0), mFootprints(),
+    mMemoryUsage(0), mUndoLimit(0), mMemoryBudget(0), mSpillEnabled(false)
+{
+    // Nothing more to do here.
+}
+
+DrawingUndoStack::~DrawingUndoStack()
+{
+    qDeleteAll(mCommands);
+}
+
+//======================================================================================================================
+
+void DrawingUndoStack::setUndoLimit(int limit)
+{
+    mUndoLimit = limit;
+    enforceLimits();
+}
+
+void DrawingUndoStack::setMemoryBudget(qint64 bytes)
+{
+    mMemoryBudget = bytes;
+    enforceLimits();
+}
+
+void DrawingUndoStack::setSpillEnabled(bool enabled)
+{
+    mSpillEnabled = enabled;
+    enforceLimits();
+}
+
+int DrawingUndoStack::undoLimit() const
+{
+    return mUndoLimit;
+}
+
+qint64 DrawingUndoStack::memoryBudget() const
+{
+    return mMemoryBudget;
+}
+
+bool DrawingUndoStack::isSpillEnabled() const
+{
+    return mSpillEnabled;
+}
+
+//======================================================================================================================
+
+void DrawingUndoStack::push(DrawingUndoCommand* command)
+{
+    if (command)
+    {
+        const bool wasClean = isClean();
+
+        command->redo();
+
+        // Discard any commands that were undone
+        while (mCommands.size() > mIndex)
+            deleteCommand(mCommands.takeLast());
+        if (mCleanIndex > mIndex) mCleanIndex = -1;
+
+        // Try to merge the new command with the previous one; never merge across the clean state
+        DrawingUndoCommand* previousCommand = (mIndex > 0) ? mCommands.at(mIndex - 1) : nullptr;
+        if (previousCommand && command->id() != -1 && command->id() == previousCommand->id() &&
+            mCleanIndex != mIndex && previousCommand->mergeWith(command))
+        {
+            delete command;
+            updateFootprint(previousCommand);
+        }
+        else
+        {
+            mCommands.append(command);
+            mIndex++;
+            updateFootprint(command);
+        }
+
+        enforceLimits();
+
+        if (wasClean != isClean()) emit cleanChanged(isClean());
+    }
+}
+
+void DrawingUndoStack::clear()
+{
+    const bool wasClean = isClean();
+
+    qDeleteAll(mCommands);
+    mCommands.clear();
+    mIndex = 0;
+    mCleanIndex = 0;
+    mFootprints.clear();
+    mMemoryUsage = 0;
+
+    if (!wasClean) emit cleanChanged(true);
+}
+
+//======================================================================================================================
+
+void DrawingUndoStack::setClean()
+{
+    const bool wasClean = isClean();
+    mCleanIndex = mIndex;
+    if (!wasClean) emit cleanChanged(true);
+}
+
+bool DrawingUndoStack::isClean() const
+{
+    return (mCleanIndex == mIndex);
+}
+
+//======================================================================================================================
+
+bool DrawingUndoStack::canUndo() const
+{
+    return (mIndex > 0);
+}
+
+bool DrawingUndoStack::canRedo() const
+{
+    return (mIndex < mCommands.size());
+}
+
+int DrawingUndoStack::count() const
+{
+    return mCommands.size();
+}
+
+int DrawingUndoStack::index() const
+{
+    return mIndex;
+}
+
+//======================================================================================================================
+
+qint64 DrawingUndoStack::memoryUsage() const
+{
+    return mMemoryUsage;
+}
+
+//======================================================================================================================
+
+void DrawingUndoStack::undo()
+{
+    if (canUndo())
+    {
+        const bool wasClean = isClean();
+
+        mIndex--;
+        mCommands.at(mIndex)->undo();
+        updateFootprint(mCommands.at(mIndex));
+
+        if (wasClean != isClean()) emit cleanChanged(isClean());
+    }
+}
+
+void DrawingUndoStack::redo()
+{
+    if (canRedo())
+    {
+        const bool wasClean = isClean();
+
+        mCommands.at(mIndex)->redo();
+        updateFootprint(mCommands.at(mIndex));
+        mIndex++;
+
+        if (wasClean != isClean()) emit cleanChanged(isClean());
+    }
+}
+
+//======================================================================================================================
+
+void DrawingUndoStack::enforceLimits()
+{
+    // Drop the oldest commands beyond the undo limit
+    while (mUndoLimit > 0 && mCommands.size() > mUndoLimit && mIndex > 0)
+        dropOldestCommand();
+
+    if (mMemoryBudget <= 0) return;
+
+    // Move the payload of the oldest commands to disk first.  A command that releases items when spilled may only do
+    // so if none of the older commands still refer to those items; newer commands never do, because they were pushed
+    // after the items were removed from the drawing.
+    if (mSpillEnabled)
+    {
+        DrawingUndoCommand* command = nullptr;
+        for(int index = 0; index < mIndex && mMemoryUsage > mMemoryBudget; index++)
+        {
+            command = mCommands.at(index);
+            if (command->canSpill())
+            {
+                const QList<OdgItem*> items = command->spillItems();
+                const QSet<OdgItem*> itemsSet(items.cbegin(), items.cend());
+
+                bool referenced = false;
+                for(int olderIndex = 0; olderIndex < index && !itemsSet.isEmpty() && !referenced; olderIndex++)
+                    referenced = mCommands.at(olderIndex)->references(itemsSet);
+
+                if (!referenced)
+                {
+                    command->spill();
+                    updateFootprint(command);
+                }
+            }
+        }
+    }
+
+    // Then drop the oldest commands until the stack fits within its budget.  The most recent command is always kept.
+    while (mMemoryUsage > mMemoryBudget && mIndex > 1)
+        dropOldestCommand();
+}
+
+void DrawingUndoStack::dropOldestCommand()
+{
+    if (!mCommands.isEmpty())
+    {
+        deleteCommand(mCommands.takeFirst());
+        mIndex--;
+        mCleanIndex = (mCleanIndex > 0) ? mCleanIndex - 1 : -1;
+    }
+}
+
+void DrawingUndoStack::deleteCommand(DrawingUndoCommand* command)
+{
+    mMemoryUsage -= mFootprints.take(command);
+    delete command;
+}
+
+void DrawingUndoStack::updateFootprint(DrawingUndoCommand* command)
+{
+    const qint64 footprint = command->footprint();
+    mMemoryUsage += footprint - mFootprints.value(command, 0);
+    mFootprints.insert(command, footprint);
+}
+
 //======================================================================================================================
 //======================================================================================================================
 //======================================================================================================================
 
 DrawingSetPropertyCommand::DrawingSetPropertyCommand(
-    DrawingWidget* drawing, const QString& name, const QVariant& value) : QUndoCommand("Set Property"),
+    DrawingWidget* drawing, const QString& name, const QVariant& value) : DrawingUndoCommand("Set Property"),
     mDrawing(drawing), mName(name), mNewValue(value), mOldValue()
 {
     Q_ASSERT(mDrawing != nullptr);
@@ -70,7 +374,7 @@ void DrawingSetPropertyCommand::undo()
 //======================================================================================================================
 
 DrawingInsertPageCommand::DrawingInsertPageCommand(DrawingWidget* drawing, OdgPage* page, int index) :
-    QUndoCommand("Insert Page"), mDrawing(drawing), mPage(page), mIndex(index), mUndone(true)
+    DrawingUndoCommand("Insert Page"), mDrawing(drawing), mPage(page), mIndex(index), mUndone(true)
 {
     Q_ASSERT(mDrawing != nullptr);
     Q_ASSERT(mPage != nullptr);
@@ -95,12 +399,21 @@ void DrawingInsertPageCommand::undo()
     mUndone = true;
 }
 
+//======================================================================================================================
+
+qint64 DrawingInsertPageCommand::footprint() const
+{
+    qint64 footprint = sizeof(DrawingInsertPageCommand);
+    if (mUndone) footprint += itemsFootprint(mPage->items());
+    return footprint;
+}
+
 //======================================================================================================================
 //======================================================================================================================
 //======================================================================================================================
 
-DrawingRemovePageCommand::DrawingRemovePageCommand(DrawingWidget* drawing, OdgPage* page) : QUndoCommand("Remove Page"),
-    mDrawing(drawing), mPage(page), mIndex(-1), mUndone(true)
+DrawingRemovePageCommand::DrawingRemovePageCommand(DrawingWidget* drawing, OdgPage* page) :
+    DrawingUndoCommand("Remove Page"), mDrawing(drawing), mPage(page), mIndex(-1), mUndone(true)
 {
     Q_ASSERT(mDrawing != nullptr);
     Q_ASSERT(mPage != nullptr);
@@ -126,12 +439,21 @@ void DrawingRemovePageCommand::undo()
     mUndone = true;
 }
 
+//======================================================================================================================
+
+qint64 DrawingRemovePageCommand::footprint() const
+{
+    qint64 footprint = sizeof(DrawingRemovePageCommand);
+    if (!mUndone) footprint += itemsFootprint(mPage->items());
+    return footprint;
+}
+
 //======================================================================================================================
 //======================================================================================================================
 //======================================================================================================================
 
 DrawingMovePageCommand::DrawingMovePageCommand(DrawingWidget* drawing, OdgPage* page, int newIndex) :
-    QUndoCommand("Move Page"), mDrawing(drawing), mPage(page), mNewIndex(newIndex), mOldIndex(-1)
+    DrawingUndoCommand("Move Page"), mDrawing(drawing), mPage(page), mNewIndex(newIndex), mOldIndex(-1)
 {
     Q_ASSERT(mDrawing != nullptr);
     Q_ASSERT(mPage != nullptr);
@@ -158,7 +480,7 @@ void DrawingMovePageCommand::undo()
 
 DrawingSetPagePropertyCommand::DrawingSetPagePropertyCommand(
     DrawingWidget* drawing, OdgPage* page, const QString& name, const QVariant& value) :
-    QUndoCommand("Set Page Property"), mDrawing(drawing), mPage(page), mName(name), mNewValue(value), mOldValue()
+    DrawingUndoCommand("Set Page Property"), mDrawing(drawing), mPage(page), mName(name), mNewValue(value), mOldValue()
 {
     Q_ASSERT(mDrawing != nullptr);
     Q_ASSERT(mPage != nullptr);
@@ -210,13 +532,28 @@ void DrawingAddItemsCommand::undo()
     mUndone = true;
 }
 
+//======================================================================================================================
+
+qint64 DrawingAddItemsCommand::footprint() const
+{
+    qint64 footprint = sizeof(DrawingAddItemsCommand) + mItems.size() * sizeof(OdgItem*);
+    if (mUndone) footprint += itemsFootprint(mItems);
+    return footprint;
+}
+
+bool DrawingAddItemsCommand::references(const QSet<OdgItem*>& items) const
+{
+    return containsAny(mItems, items);
+}
+
 //======================================================================================================================
 //======================================================================================================================
 //======================================================================================================================
 
 DrawingRemoveItemsCommand::DrawingRemoveItemsCommand(DrawingWidget* drawing, OdgPage* page,
                                                      const QList<OdgItem*>& items) :
-    DrawingUndoCommand("Remove Items"), mDrawing(drawing), mPage(page), mItems(items), mIndices(), mUndone(true)
+    DrawingUndoCommand("Remove Items"), mDrawing(drawing), mPage(page), mItems(items), mIndices(), mUndone(true),
+    mSpillFile(nullptr), mSpilledIndices(), mSpilledPathNames()
 {
     Q_ASSERT(mDrawing != nullptr);
     storeView(mDrawing);
@@ -237,6 +574,7 @@ DrawingRemoveItemsCommand::DrawingRemoveItemsCommand(DrawingWidget* drawing, Odg
 DrawingRemoveItemsCommand::~DrawingRemoveItemsCommand()
 {
     if (!mUndone) qDeleteAll(mItems);
+    delete mSpillFile;
 }
 
 //======================================================================================================================
@@ -250,11 +588,141 @@ void DrawingRemoveItemsCommand::redo()
 
 void DrawingRemoveItemsCommand::undo()
 {
+    restoreSpilledItems();
     restoreView(mDrawing);
     mDrawing->insertItems(mPage, mItems, mIndices, true);
     mUndone = true;
 }
 
+//======================================================================================================================
+
+qint64 DrawingRemoveItemsCommand::footprint() const
+{
+    qint64 footprint = sizeof(DrawingRemoveItemsCommand) + mItems.size() * sizeof(OdgItem*) +
+                       mIndices.size() * (sizeof(OdgItem*) + sizeof(int)) + mSpilledIndices.size() * sizeof(int);
+    for(auto& pathName : mSpilledPathNames) footprint += sizeof(int) + variantFootprint(pathName);
+    if (!mUndone) footprint += itemsFootprint(mItems);
+    return footprint;
+}
+
+bool DrawingRemoveItemsCommand::references(const QSet<OdgItem*>& items) const
+{
+    return containsAny(mItems, items);
+}
+
+//======================================================================================================================
+
+bool DrawingRemoveItemsCommand::canSpill() const
+{
+    // The removed items are only owned by this command (and can therefore be released) while it has not been undone
+    return (!mUndone && !mSpillFile && mPage && !mItems.isEmpty());
+}
+
+bool DrawingRemoveItemsCommand::isSpilled() const
+{
+    return (mSpillFile != nullptr);
+}
+
+QList<OdgItem*> DrawingRemoveItemsCommand::spillItems() const
+{
+    return mItems;
+}
+
+void DrawingRemoveItemsCommand::spill()
+{
+    if (canSpill())
+    {
+        // Write the removed items to a temporary file using the same format as the clipboard
+        OdgWriter writer;
+        writer.setUnits(mDrawing->units());
+        writer.setDefaultStyle(mDrawing->defaultStyle());
+
+        OdgPage page;
+        for(auto& item : qAsConst(mItems)) page.addItem(item);
+        writer.setPages(QList<OdgPage*>(1, &page));
+        const QByteArray data = writer.writeToString().toUtf8();
+        for(auto& item : qAsConst(mItems)) page.removeItem(item);
+
+        mSpillFile = new QTemporaryFile();
+        if (mSpillFile->open() && mSpillFile->write(data) == data.size() && mSpillFile->flush())
+        {
+            for(auto& item : qAsConst(mItems)) mSpilledIndices.append(mIndices.value(item));
+
+            // The ODF format has no place for the path names, so keep them aside to restore onto the read items
+            int index = 0;
+            storePathNames(mItems, mSpilledPathNames, index);
+
+            qDeleteAll(mItems);
+            mItems.clear();
+            mIndices.clear();
+        }
+        else
+        {
+            delete mSpillFile;
+            mSpillFile = nullptr;
+        }
+    }
+}
+
+void DrawingRemoveItemsCommand::restoreSpilledItems()
+{
+    if (mSpillFile)
+    {
+        mSpillFile->seek(0);
+
+        OdgReader reader;
+        reader.readFromString(QString::fromUtf8(mSpillFile->readAll()));
+
+        const QList<OdgPage*> pages = reader.takePages();
+        if (!pages.isEmpty())
+        {
+            OdgPage* page = pages.first();
+            mItems = page->items();
+            for(auto& item : qAsConst(mItems)) page->removeItem(item);
+
+            for(int i = 0; i < mItems.size() && i < mSpilledIndices.size(); i++)
+                mIndices.insert(mItems.at(i), mSpilledIndices.at(i));
+
+            int index = 0;
+            restorePathNames(mItems, mSpilledPathNames, index);
+        }
+        qDeleteAll(pages);
+
+        delete mSpillFile;
+        mSpillFile = nullptr;
+        mSpilledIndices.clear();
+        mSpilledPathNames.clear();
+    }
+}
+
+void DrawingRemoveItemsCommand::storePathNames(const QList<OdgItem*>& items, QHash<int,QString>& pathNames, int& index)
+{
+    // Items are numbered depth-first, including the items within groups, in the same order they are written
+    for(auto& item : items)
+    {
+        if (item->type() == OdgItem::PathType)
+            pathNames.insert(index, static_cast<OdgPathItem*>(item)->pathName());
+        index++;
+
+        if (item->type() == OdgItem::GroupType)
+            storePathNames(static_cast<OdgGroupItem*>(item)->items(), pathNames, index);
+    }
+}
+
+void DrawingRemoveItemsCommand::restorePathNames(const QList<OdgItem*>& items, const QHash<int,QString>& pathNames,
+                                                 int& index)
+{
+    for(auto& item : items)
+    {
+        if (item->type() == OdgItem::PathType && pathNames.contains(index))
+            static_cast<OdgPathItem*>(item)->setPathName(pathNames.value(index));
+        index++;
+
+        if (item->type() == OdgItem::GroupType)
+            restorePathNames(static_cast<OdgGroupItem*>(item)->items(), pathNames, index);
+    }
+}
+
 //======================================================================================================================
 //======================================================================================================================
 //======================================================================================================================
@@ -287,6 +755,20 @@ void DrawingReorderItemsCommand::undo()
     mDrawing->setSelectedItems(mSelectedItems);
 }
 
+//======================================================================================================================
+
+qint64 DrawingReorderItemsCommand::footprint() const
+{
+    return sizeof(DrawingReorderItemsCommand) +
+           (mItemsOrdered.size() + mOriginalItemsOrdered.size() + mSelectedItems.size()) * sizeof(OdgItem*);
+}
+
+bool DrawingReorderItemsCommand::references(const QSet<OdgItem*>& items) const
+{
+    return (containsAny(mItemsOrdered, items) || containsAny(mOriginalItemsOrdered, items) ||
+            containsAny(mSelectedItems, items));
+}
+
 //======================================================================================================================
 //======================================================================================================================
 //======================================================================================================================
@@ -302,6 +784,16 @@ DrawingMoveItemsCommand::DrawingMoveItemsCommand(DrawingWidget* drawing, const Q
     for(auto& item : items) mOriginalPositions.insert(item, item->position());
 }
 
+DrawingMoveItemsCommand::DrawingMoveItemsCommand(DrawingWidget* drawing, const QList<OdgItem*>& items,
+                                                 const QHash<OdgItem*,QPointF>& positions,
+                                                 const QHash<OdgItem*,QPointF>& originalPositions, bool place) :
+    DrawingUndoCommand("Move Items"),
+    mDrawing(drawing), mItems(items), mPositions(positions), mOriginalPositions(originalPositions), mPlace(place)
+{
+    Q_ASSERT(mDrawing != nullptr);
+    storeView(mDrawing);
+}
+
 //======================================================================================================================
 
 int DrawingMoveItemsCommand::id() const
@@ -341,6 +833,19 @@ void DrawingMoveItemsCommand::undo()
     mDrawing->moveItems(mItems, mOriginalPositions, mPlace);
 }
 
+//======================================================================================================================
+
+qint64 DrawingMoveItemsCommand::footprint() const
+{
+    return sizeof(DrawingMoveItemsCommand) + mItems.size() * sizeof(OdgItem*) +
+           (mPositions.size() + mOriginalPositions.size()) * (sizeof(OdgItem*) + sizeof(QPointF));
+}
+
+bool DrawingMoveItemsCommand::references(const QSet<OdgItem*>& items) const
+{
+    return containsAny(mItems, items);
+}
+
 //======================================================================================================================
 //======================================================================================================================
 //======================================================================================================================
@@ -357,6 +862,17 @@ DrawingResizeItemCommand::DrawingResizeItemCommand(DrawingWidget* drawing, OdgCo
     if (point && point->item()) mOriginalPosition = point->item()->mapToScene(point->position());
 }
 
+DrawingResizeItemCommand::DrawingResizeItemCommand(DrawingWidget* drawing, OdgControlPoint* point,
+                                                   const QPointF& position, const QPointF& originalPosition,
+                                                   bool snapTo45Degrees, bool place) :
+    DrawingUndoCommand("Resize Item"),
+    mDrawing(drawing), mControlPoint(point), mPosition(position), mOriginalPosition(originalPosition),
+    mSnapTo45Degrees(snapTo45Degrees), mPlace(place)
+{
+    Q_ASSERT(mDrawing != nullptr);
+    storeView(mDrawing);
+}
+
 //======================================================================================================================
 
 int DrawingResizeItemCommand::id() const
@@ -404,6 +920,13 @@ void DrawingResizeItemCommand::undo()
     }
 }
 
+//======================================================================================================================
+
+bool DrawingResizeItemCommand::references(const QSet<OdgItem*>& items) const
+{
+    return (mControlPoint && items.contains(mControlPoint->item()));
+}
+
 //======================================================================================================================
 //======================================================================================================================
 //======================================================================================================================
@@ -443,6 +966,14 @@ void DrawingResizeItem2Command::undo()
     }
 }
 
+//======================================================================================================================
+
+bool DrawingResizeItem2Command::references(const QSet<OdgItem*>& items) const
+{
+    return ((mControlPoint1 && items.contains(mControlPoint1->item())) ||
+            (mControlPoint2 && items.contains(mControlPoint2->item())));
+}
+
 //======================================================================================================================
 //======================================================================================================================
 //======================================================================================================================
@@ -471,6 +1002,13 @@ void DrawingRotateItemsCommand::undo()
     mDrawing->rotateBackItems(mItems, mPosition);
 }
 
+//======================================================================================================================
+
+bool DrawingRotateItemsCommand::references(const QSet<OdgItem*>& items) const
+{
+    return containsAny(mItems, items);
+}
+
 //======================================================================================================================
 //======================================================================================================================
 //======================================================================================================================
@@ -499,6 +1037,13 @@ void DrawingRotateBackItemsCommand::undo()
     mDrawing->rotateItems(mItems, mPosition);
 }
 
+//======================================================================================================================
+
+bool DrawingRotateBackItemsCommand::references(const QSet<OdgItem*>& items) const
+{
+    return containsAny(mItems, items);
+}
+
 //======================================================================================================================
 //======================================================================================================================
 //======================================================================================================================
@@ -527,6 +1072,13 @@ void DrawingFlipItemsHorizontalCommand::undo()
     mDrawing->flipItemsHorizontal(mItems, mPosition);
 }
 
+//======================================================================================================================
+
+bool DrawingFlipItemsHorizontalCommand::references(const QSet<OdgItem*>& items) const
+{
+    return containsAny(mItems, items);
+}
+
 //======================================================================================================================
 //======================================================================================================================
 //======================================================================================================================
@@ -555,6 +1107,13 @@ void DrawingFlipItemsVerticalCommand::undo()
     mDrawing->flipItemsVertical(mItems, mPosition);
 }
 
+//======================================================================================================================
+
+bool DrawingFlipItemsVerticalCommand::references(const QSet<OdgItem*>& items) const
+{
+    return containsAny(mItems, items);
+}
+
 //======================================================================================================================
 //======================================================================================================================
 //======================================================================================================================
@@ -609,6 +1168,21 @@ void DrawingGroupItemsCommand::undo()
     mUndone = true;
 }
 
+//======================================================================================================================
+
+qint64 DrawingGroupItemsCommand::footprint() const
+{
+    qint64 footprint = sizeof(DrawingGroupItemsCommand) +
+                       (mItemsToRemove.size() + mItemsToAdd.size()) * sizeof(OdgItem*);
+    footprint += itemsFootprint(mUndone ? mItemsToAdd : mItemsToRemove);
+    return footprint;
+}
+
+bool DrawingGroupItemsCommand::references(const QSet<OdgItem*>& items) const
+{
+    return (containsAny(mItemsToRemove, items) || containsAny(mItemsToAdd, items));
+}
+
 //======================================================================================================================
 //======================================================================================================================
 //======================================================================================================================
@@ -659,6 +1233,21 @@ void DrawingUngroupItemsCommand::undo()
     mUndone = true;
 }
 
+//======================================================================================================================
+
+qint64 DrawingUngroupItemsCommand::footprint() const
+{
+    qint64 footprint = sizeof(DrawingUngroupItemsCommand) +
+                       (mItemsToRemove.size() + mItemsToAdd.size()) * sizeof(OdgItem*);
+    footprint += itemsFootprint(mUndone ? mItemsToAdd : mItemsToRemove);
+    return footprint;
+}
+
+bool DrawingUngroupItemsCommand::references(const QSet<OdgItem*>& items) const
+{
+    return (containsAny(mItemsToRemove, items) || containsAny(mItemsToAdd, items));
+}
+
 //======================================================================================================================
 //======================================================================================================================
 //======================================================================================================================
@@ -694,6 +1283,13 @@ void DrawingInsertPointCommand::undo()
     mUndone = true;
 }
 
+//======================================================================================================================
+
+bool DrawingInsertPointCommand::references(const QSet<OdgItem*>& items) const
+{
+    return items.contains(mItem);
+}
+
 //======================================================================================================================
 //======================================================================================================================
 //======================================================================================================================
@@ -730,6 +1326,13 @@ void DrawingRemovePointCommand::undo()
     mUndone = true;
 }
 
+//======================================================================================================================
+
+bool DrawingRemovePointCommand::references(const QSet<OdgItem*>& items) const
+{
+    return items.contains(mItem);
+}
+
 //======================================================================================================================
 //======================================================================================================================
 //======================================================================================================================
@@ -737,7 +1340,7 @@ void DrawingRemovePointCommand::undo()
 DrawingSetItemsPropertyCommand::DrawingSetItemsPropertyCommand(DrawingWidget* drawing, const QList<OdgItem*>& items,
                                                                const QString& name, const QVariant& value) :
     DrawingUndoCommand("Set Items' Property"),
-    mDrawing(drawing), mItems(items), mName(name), mNewValue(value), mOldValues()
+    mDrawing(drawing), mItems(items), mName(name), mNewValue(value), mOldValues(), mSpillFile(nullptr)
 {
     Q_ASSERT(mDrawing != nullptr);
     storeView(mDrawing);
@@ -745,6 +1348,11 @@ DrawingSetItemsPropertyCommand::DrawingSetItemsPropertyCommand(DrawingWidget* dr
     for(auto& item : items) mOldValues.insert(item, item->property(name));
 }
 
+DrawingSetItemsPropertyCommand::~DrawingSetItemsPropertyCommand()
+{
+    delete mSpillFile;
+}
+
 //======================================================================================================================
 
 int DrawingSetItemsPropertyCommand::id() const
@@ -782,7 +1390,170 @@ void DrawingSetItemsPropertyCommand::redo()
 
 void DrawingSetItemsPropertyCommand::undo()
 {
+    restoreSpilledValues();
     restoreView(mDrawing);
     mDrawing->setSelectedItems(mItems);
     mDrawing->setItemsProperty(mItems, mName, mOldValues);
 }
+
+//======================================================================================================================
+
+qint64 DrawingSetItemsPropertyCommand::footprint() const
+{
+    qint64 footprint = sizeof(DrawingSetItemsPropertyCommand) + mItems.size() * sizeof(OdgItem*) +
+                       mName.size() * sizeof(QChar) + variantFootprint(mNewValue);
+    for(auto valueIter = mOldValues.cbegin(); valueIter != mOldValues.cend(); valueIter++)
+        footprint += sizeof(OdgItem*) + variantFootprint(valueIter.value());
+    return footprint;
+}
+
+bool DrawingSetItemsPropertyCommand::references(const QSet<OdgItem*>& items) const
+{
+    return containsAny(mItems, items);
+}
+
+//======================================================================================================================
+
+bool DrawingSetItemsPropertyCommand::canSpill() const
+{
+    if (mSpillFile || mOldValues.isEmpty()) return false;
+
+    // Only values that QDataStream knows how to serialize can be moved to disk
+    for(auto valueIter = mOldValues.cbegin(); valueIter != mOldValues.cend(); valueIter++)
+    {
+        if (valueIter.value().isValid() && !valueIter.value().metaType().hasRegisteredDataStreamOperators())
+            return false;
+    }
+
+    return true;
+}
+
+bool DrawingSetItemsPropertyCommand::isSpilled() const
+{
+    return (mSpillFile != nullptr);
+}
+
+void DrawingSetItemsPropertyCommand::spill()
+{
+    if (canSpill())
+    {
+        // Only the old values are written to disk; the items themselves are not owned by this command
+        mSpillFile = new QTemporaryFile();
+        if (mSpillFile->open())
+        {
+            QDataStream stream(mSpillFile);
+            for(auto& item : qAsConst(mItems)) stream << mOldValues.value(item);
+
+            if (stream.status() == QDataStream::Ok && mSpillFile->flush())
+            {
+                mOldValues.clear();
+                return;
+            }
+        }
+
+        delete mSpillFile;
+        mSpillFile = nullptr;
+    }
+}
+
+void DrawingSetItemsPropertyCommand::restoreSpilledValues()
+{
+    if (mSpillFile)
+    {
+        mSpillFile->seek(0);
+
+        QDataStream stream(mSpillFile);
+        QVariant value;
+        for(auto& item : qAsConst(mItems))
+        {
+            stream >> value;
+            mOldValues.insert(item, value);
+        }
+
+        delete mSpillFile;
+        mSpillFile = nullptr;
+    }
+}
+
+//======================================================================================================================
+//======================================================================================================================
+//======================================================================================================================
+
+DrawingBatchCommand::DrawingBatchCommand(DrawingWidget* drawing) :
+    DrawingUndoCommand("Edit Items"), mDrawing(drawing), mCommands(), mApplied(true)
+{
+    // Nothing more to do here.
+}
+
+DrawingBatchCommand::~DrawingBatchCommand()
+{
+    qDeleteAll(mCommands);
+}
+
+//======================================================================================================================
+
+void DrawingBatchCommand::addCommand(DrawingUndoCommand* command)
+{
+    if (command)
+    {
+        // Commands are applied as soon as they are added to the batch so that later edits within the same batch see
+        // the results of earlier ones
+        command->redo();
+
+        DrawingUndoCommand* previousCommand = (!mCommands.isEmpty()) ? mCommands.last() : nullptr;
+        if (previousCommand && command->id() != -1 && command->id() == previousCommand->id() &&
+            previousCommand->mergeWith(command))
+        {
+            delete command;
+        }
+        else mCommands.append(command);
+    }
+}
+
+int DrawingBatchCommand::commandCount() const
+{
+    return mCommands.size();
+}
+
+//======================================================================================================================
+
+void DrawingBatchCommand::redo()
+{
+    // The first redo happens when the batch is pushed onto the undo stack, after all of its commands have already
+    // been applied by addCommand
+    if (mApplied)
+    {
+        mApplied = false;
+        return;
+    }
+
+    mDrawing->beginBatch();
+    for(auto& command : mCommands) command->redo();
+    mDrawing->commitBatch();
+}
+
+void DrawingBatchCommand::undo()
+{
+    mDrawing->beginBatch();
+    for(auto commandIter = mCommands.rbegin(); commandIter != mCommands.rend(); commandIter++)
+        (*commandIter)->undo();
+    mDrawing->commitBatch();
+}
+
+//======================================================================================================================
+
+qint64 DrawingBatchCommand::footprint() const
+{
+    qint64 footprint = DrawingUndoCommand::footprint();
+    for(auto& command : mCommands) footprint += command->footprint();
+    return footprint;
+}
+
+bool DrawingBatchCommand::references(const QSet<OdgItem*>& items) const
+{
+    for(auto& command : mCommands)
+    {
+        if (command->references(items)) return true;
+    }
+    return false;
+}
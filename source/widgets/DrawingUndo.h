@@ -19,10 +19,13 @@
 
 #include <QHash>
 #include <QList>
+#include <QObject>
+#include <QSet>
 #include <QUndoCommand>
 #include <QRectF>
 #include <QVariant>
 
+class QTemporaryFile;
 class DrawingWidget;
 class OdgControlPoint;
 class OdgGroupItem;
@@ -43,13 +46,83 @@ public:
 
     void storeView(DrawingWidget* drawing);
     void restoreView(DrawingWidget* drawing);
+
+    virtual qint64 footprint() const;
+    virtual bool references(const QSet<OdgItem*>& items) const;
+
+    virtual bool canSpill() const;
+    virtual bool isSpilled() const;
+    virtual QList<OdgItem*> spillItems() const;
+    virtual void spill();
+
+protected:
+    static qint64 itemsFootprint(const QList<OdgItem*>& items);
+    static qint64 variantFootprint(const QVariant& value);
+    static bool containsAny(const QList<OdgItem*>& list, const QSet<OdgItem*>& items);
+};
+
+//======================================================================================================================
+
+class DrawingUndoStack : public QObject
+{
+    Q_OBJECT
+
+private:
+    QList<DrawingUndoCommand*> mCommands;
+    int mIndex;
+    int mCleanIndex;
+
+    // Footprints are cached when a command changes so that enforcing the budget doesn't walk the whole history
+    QHash<DrawingUndoCommand*,qint64> mFootprints;
+    qint64 mMemoryUsage;
+
+    int mUndoLimit;
+    qint64 mMemoryBudget;
+    bool mSpillEnabled;
+
+public:
+    DrawingUndoStack();
+    ~DrawingUndoStack();
+
+    void setUndoLimit(int limit);
+    void setMemoryBudget(qint64 bytes);
+    void setSpillEnabled(bool enabled);
+    int undoLimit() const;
+    qint64 memoryBudget() const;
+    bool isSpillEnabled() const;
+
+    void push(DrawingUndoCommand* command);
+    void clear();
+
+    void setClean();
+    bool isClean() const;
+
+    bool canUndo() const;
+    bool canRedo() const;
+    int count() const;
+    int index() const;
+
+    qint64 memoryUsage() const;
+
+public slots:
+    void undo();
+    void redo();
+
+signals:
+    void cleanChanged(bool clean);
+
+private:
+    void enforceLimits();
+    void dropOldestCommand();
+    void deleteCommand(DrawingUndoCommand* command);
+    void updateFootprint(DrawingUndoCommand* command);
 };
 
 //======================================================================================================================
 //======================================================================================================================
 //======================================================================================================================
 
-class DrawingSetPropertyCommand : public QUndoCommand
+class DrawingSetPropertyCommand : public DrawingUndoCommand
 {
 private:
     DrawingWidget* mDrawing;
@@ -68,7 +141,7 @@ public:
 //======================================================================================================================
 //======================================================================================================================
 
-class DrawingInsertPageCommand : public QUndoCommand
+class DrawingInsertPageCommand : public DrawingUndoCommand
 {
 private:
     DrawingWidget* mDrawing;
@@ -82,11 +155,13 @@ public:
 
     void redo() override;
     void undo() override;
+
+    qint64 footprint() const override;
 };
 
 //======================================================================================================================
 
-class DrawingRemovePageCommand : public QUndoCommand
+class DrawingRemovePageCommand : public DrawingUndoCommand
 {
 private:
     DrawingWidget* mDrawing;
@@ -100,11 +175,13 @@ public:
 
     void redo() override;
     void undo() override;
+
+    qint64 footprint() const override;
 };
 
 //======================================================================================================================
 
-class DrawingMovePageCommand : public QUndoCommand
+class DrawingMovePageCommand : public DrawingUndoCommand
 {
 private:
     DrawingWidget* mDrawing;
@@ -121,7 +198,7 @@ public:
 
 //======================================================================================================================
 
-class DrawingSetPagePropertyCommand : public QUndoCommand
+class DrawingSetPagePropertyCommand : public DrawingUndoCommand
 {
 private:
     DrawingWidget* mDrawing;
@@ -156,6 +233,9 @@ public:
 
     void redo() override;
     void undo() override;
+
+    qint64 footprint() const override;
+    bool references(const QSet<OdgItem*>& items) const override;
 };
 
 //======================================================================================================================
@@ -169,12 +249,30 @@ private:
     QHash<OdgItem*,int> mIndices;
     bool mUndone;
 
+    QTemporaryFile* mSpillFile;
+    QList<int> mSpilledIndices;
+    QHash<int,QString> mSpilledPathNames;
+
 public:
     DrawingRemoveItemsCommand(DrawingWidget* drawing, OdgPage* page, const QList<OdgItem*>& items);
     ~DrawingRemoveItemsCommand();
 
     void redo() override;
     void undo() override;
+
+    qint64 footprint() const override;
+    bool references(const QSet<OdgItem*>& items) const override;
+
+    bool canSpill() const override;
+    bool isSpilled() const override;
+    QList<OdgItem*> spillItems() const override;
+    void spill() override;
+
+private:
+    void restoreSpilledItems();
+
+    static void storePathNames(const QList<OdgItem*>& items, QHash<int,QString>& pathNames, int& index);
+    static void restorePathNames(const QList<OdgItem*>& items, const QHash<int,QString>& pathNames, int& index);
 };
 
 //======================================================================================================================
@@ -193,6 +291,9 @@ public:
 
     void redo() override;
     void undo() override;
+
+    qint64 footprint() const override;
+    bool references(const QSet<OdgItem*>& items) const override;
 };
 
 //======================================================================================================================
@@ -211,12 +312,18 @@ private:
 public:
     DrawingMoveItemsCommand(DrawingWidget* drawing, const QList<OdgItem*>& items,
                             const QHash<OdgItem*,QPointF>& positions, bool place);
+    DrawingMoveItemsCommand(DrawingWidget* drawing, const QList<OdgItem*>& items,
+                            const QHash<OdgItem*,QPointF>& positions,
+                            const QHash<OdgItem*,QPointF>& originalPositions, bool place);
 
     int id() const override;
     bool mergeWith(const QUndoCommand* command) override;
 
     void redo() override;
     void undo() override;
+
+    qint64 footprint() const override;
+    bool references(const QSet<OdgItem*>& items) const override;
 };
 
 //======================================================================================================================
@@ -234,12 +341,16 @@ private:
 public:
     DrawingResizeItemCommand(DrawingWidget* drawing, OdgControlPoint* point, const QPointF& position,
                              bool snapTo45Degrees, bool place);
+    DrawingResizeItemCommand(DrawingWidget* drawing, OdgControlPoint* point, const QPointF& position,
+                             const QPointF& originalPosition, bool snapTo45Degrees, bool place);
 
     int id() const override;
     bool mergeWith(const QUndoCommand* command) override;
 
     void redo() override;
     void undo() override;
+
+    bool references(const QSet<OdgItem*>& items) const override;
 };
 
 //======================================================================================================================
@@ -262,6 +373,8 @@ public:
 
     void redo() override;
     void undo() override;
+
+    bool references(const QSet<OdgItem*>& items) const override;
 };
 
 //======================================================================================================================
@@ -280,6 +393,8 @@ public:
 
     void redo() override;
     void undo() override;
+
+    bool references(const QSet<OdgItem*>& items) const override;
 };
 
 //======================================================================================================================
@@ -296,6 +411,8 @@ public:
 
     void redo() override;
     void undo() override;
+
+    bool references(const QSet<OdgItem*>& items) const override;
 };
 
 //======================================================================================================================
@@ -312,6 +429,8 @@ public:
 
     void redo() override;
     void undo() override;
+
+    bool references(const QSet<OdgItem*>& items) const override;
 };
 
 //======================================================================================================================
@@ -328,6 +447,8 @@ public:
 
     void redo() override;
     void undo() override;
+
+    bool references(const QSet<OdgItem*>& items) const override;
 };
 
 //======================================================================================================================
@@ -349,6 +470,9 @@ public:
 
     void redo() override;
     void undo() override;
+
+    qint64 footprint() const override;
+    bool references(const QSet<OdgItem*>& items) const override;
 };
 
 //======================================================================================================================
@@ -368,6 +492,9 @@ public:
 
     void redo() override;
     void undo() override;
+
+    qint64 footprint() const override;
+    bool references(const QSet<OdgItem*>& items) const override;
 };
 
 //======================================================================================================================
@@ -389,6 +516,8 @@ public:
 
     void redo() override;
     void undo() override;
+
+    bool references(const QSet<OdgItem*>& items) const override;
 };
 
 //======================================================================================================================
@@ -408,6 +537,8 @@ public:
 
     void redo() override;
     void undo() override;
+
+    bool references(const QSet<OdgItem*>& items) const override;
 };
 
 //======================================================================================================================
@@ -423,15 +554,53 @@ private:
     QVariant mNewValue;
     QHash<OdgItem*,QVariant> mOldValues;
 
+    QTemporaryFile* mSpillFile;
+
 public:
     DrawingSetItemsPropertyCommand(DrawingWidget* drawing, const QList<OdgItem*>& items, const QString& name,
                                    const QVariant& value);
+    ~DrawingSetItemsPropertyCommand();
 
     int id() const override;
     bool mergeWith(const QUndoCommand* command) override;
 
     void redo() override;
     void undo() override;
+
+    qint64 footprint() const override;
+    bool references(const QSet<OdgItem*>& items) const override;
+
+    bool canSpill() const override;
+    bool isSpilled() const override;
+    void spill() override;
+
+private:
+    void restoreSpilledValues();
+};
+
+//======================================================================================================================
+//======================================================================================================================
+//======================================================================================================================
+
+class DrawingBatchCommand : public DrawingUndoCommand
+{
+private:
+    DrawingWidget* mDrawing;
+    QList<DrawingUndoCommand*> mCommands;
+    bool mApplied;
+
+public:
+    DrawingBatchCommand(DrawingWidget* drawing);
+    ~DrawingBatchCommand();
+
+    void addCommand(DrawingUndoCommand* command);
+    int commandCount() const;
+
+    void redo() override;
+    void undo() override;
+
+    qint64 footprint() const override;
+    bool references(const QSet<OdgItem*>& items) const override;
 };
 
 #endif
@@ -15,7 +15,9 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "DrawingWidget.h"
+#include "DrawingMimeData.h"
 #include "DrawingUndo.h"
+#include "DrawingProfiler.h"
 #include "ElectricItems.h"
 #include "LogicItems.h"
 #include "OdgControlPoint.h"
@@ -38,6 +40,7 @@
 #include "OdgTextRoundedRectItem.h"
 #include <QActionGroup>
 #include <QApplication>
+#include <QClipboard>
 #include <QContextMenuEvent>
 #include <QMenu>
 #include <QMessageBox>
@@ -52,13 +55,17 @@ DrawingWidget::DrawingWidget() : QAbstractScrollArea(), OdgDrawing(),
     mDrawingTemplate(nullptr), mStyleTemplate(nullptr), mDefaultStyle(nullptr),
     mCurrentPage(nullptr), mNewPageCount(0),
     mTransform(), mTransformInverse(), mMode(Odg::SelectMode), mUndoStack(),
+    mBatchDepth(0), mBatchCommand(nullptr), mBatchDirtyRect(), mBatchFullUpdate(false), mBatchItemsChanged(false),
+    mBatchGeometryChanged(false), mBatchPropertyChanged(false),
     mMouseState(MouseIdle), mMouseButtonDownPosition(), mMouseButtonDownScenePosition(),
     mMouseDragged(false), mSelectMouseState(SelectMouseIdle), mSelectedItems(), mSelectedItemsCenter(),
     mSelectMouseDownItem(nullptr), mSelectMouseDownPoint(nullptr), mSelectFocusItem(nullptr),
     mSelectMoveItemsInitialPositions(), mSelectMoveItemsPreviousDeltaPosition(),
     mSelectResizeItemInitialPosition(), mSelectResizeItemPreviousPosition(), mSelectRubberBandRect(),
     mScrollInitialHorizontalValue(0), mScrollInitialVerticalValue(0), mZoomRubberBandRect(),
-    mPlaceItems(), mPlaceByMousePressAndRelease(false),
+    mPlaceItems(), mPlaceByMousePressAndRelease(false), mConnectionGraph(), mCullingEnabled(true),
+    mProfilerOverlayVisible(false), mProfilePaintTime(0), mProfileCommandTime(0), mProfileItemsDrawn(0),
+    mProfileItemsCulled(0), mProfileHitTestCandidates(0),
     mPanOriginalCursor(Qt::ArrowCursor), mPanStartPosition(), mPanCurrentPosition(), mPanTimer(),
     mModeActionGroup(nullptr), mNoItemContextMenu(nullptr), mSingleItemContextMenu(nullptr),
     mSinglePolyItemContextMenu(nullptr), mSingleGroupItemContextMenu(nullptr), mMultipleItemContextMenu(nullptr)
@@ -90,6 +97,7 @@ DrawingWidget::~DrawingWidget()
     setDrawingTemplate(nullptr);
 
     qDeleteAll(mPathItems);
+    delete mBatchCommand;
 }
 
 //======================================================================================================================
@@ -120,8 +128,8 @@ void DrawingWidget::createActions()
     addModeAction("Place Text", ":/icons/oxygen/draw-text.png");
     addModeAction("Place Text Rectangle", ":/icons/items/text-rectangle.png");
     addModeAction("Place Text Ellipse", ":/icons/items/text-ellipse.png");
-    addPathItems("Electric Items", ElectricItems::items(), ElectricItems::icons());
-    addPathItems("Logic Items", LogicItems::items(), LogicItems::icons());
+    addPathItems("Electric Items", &ElectricItems::items, ElectricItems::icons());
+    addPathItems("Logic Items", &LogicItems::items, LogicItems::icons());
 
     addNormalAction("Rotate", this, SLOT(rotate()), ":/icons/oxygen/object-rotate-right.png", "R");
     addNormalAction("Rotate Back", this, SLOT(rotateBack()), ":/icons/oxygen/object-rotate-left.png", "Shift+R");
@@ -267,19 +275,16 @@ void DrawingWidget::addModeAction(const QString& text, const QString& iconPath,
         action->setChecked(true);
 }
 
-void DrawingWidget::addPathItems(const QString& name, const QList<OdgPathItem*>& items, const QStringList& icons)
+void DrawingWidget::addPathItems(const QString& name, QList<OdgPathItem*> (*createItems)(), const QStringList& icons)
 {
+    // Building the path items is deferred until the menu is first shown; see populatePathItemsMenu
     QMenu* menu = new QMenu(name);
-    QAction* menuAction;
+    connect(menu, SIGNAL(aboutToShow()), this, SLOT(populatePathItemsMenu()));
 
-    mPathItems.append(items);
-    for(int i = 0; i < items.size() && i < icons.size(); i++)
-    {
-        QAction* menuAction = new QAction("Place " + items[i]->pathName(), mModeActionGroup);
-        menuAction->setIcon(QIcon(icons[i]));
-        menuAction->setCheckable(true);
-        menu->addAction(menuAction);
-    }
+    PathItemsPalette palette;
+    palette.createItems = createItems;
+    palette.icons = icons;
+    mPathItemsPalettes.insert(menu, palette);
 
     QAction* action = new QAction(QIcon(icons.first()), name, this);
     action->setMenu(menu);
@@ -514,10 +519,41 @@ QList<OdgItem*> DrawingWidget::placeItems() const
 
 void DrawingWidget::paint(QPainter& painter, bool isExport)
 {
-    if (mCurrentPage)
+    if (isExport)
+        paintPage(painter, mCurrentPage);
+    else if (mCurrentPage)
+    {
+        drawBackground(painter, true, true);
+
+        const QList<OdgItem*> currentPageItems = mCurrentPage->items();
+        if (!mCullingEnabled)
+        {
+            mProfileItemsDrawn = currentPageItems.size();
+            mProfileItemsCulled = 0;
+            drawItems(painter, currentPageItems);
+        }
+        else
+        {
+            // Skip items that paint nothing within the visible area.  The margin covers antialiasing at the edges
+            // of each item, which is a couple of pixels at any zoom level.
+            const QList<OdgItem*> visibleItems = OdgItem::itemsInRect(currentPageItems, visibleRect(), 2 / scale());
+
+            mProfileItemsDrawn = visibleItems.size();
+            mProfileItemsCulled = currentPageItems.size() - visibleItems.size();
+            drawItems(painter, visibleItems);
+        }
+    }
+}
+
+void DrawingWidget::paintPage(QPainter& painter, OdgPage* page, const QRectF& rect)
+{
+    // Renders any page as it is exported: background without border or grid, then every item, or only the items
+    // within rect if it is valid.  Exports may render several pages or bands at once from worker threads, so this must
+    // only read the drawing's state.
+    if (page)
     {
-        drawBackground(painter, !isExport, !isExport);
-        drawItems(painter, mCurrentPage->items());
+        drawBackground(painter, false, false);
+        drawItems(painter, rect.isValid() ? OdgItem::itemsInRect(page->items(), rect, 0) : page->items());
     }
 }
 
@@ -650,6 +686,11 @@ void DrawingWidget::clear()
     selectNone();
     setSelectMode();
 
+    // Abandon any open batch; its commands refer to items that are about to be deleted
+    delete mBatchCommand;
+    mBatchCommand = nullptr;
+    mBatchDepth = 0;
+
     mUndoStack.clear();
 
     mNewPageCount = 0;
@@ -664,6 +705,75 @@ bool DrawingWidget::isClean() const
 
 //======================================================================================================================
 
+void DrawingWidget::setUndoMemoryBudget(qint64 bytes)
+{
+    mUndoStack.setMemoryBudget(bytes);
+}
+
+void DrawingWidget::setUndoSpillEnabled(bool enabled)
+{
+    mUndoStack.setSpillEnabled(enabled);
+}
+
+qint64 DrawingWidget::undoMemoryBudget() const
+{
+    return mUndoStack.memoryBudget();
+}
+
+bool DrawingWidget::isUndoSpillEnabled() const
+{
+    return mUndoStack.isSpillEnabled();
+}
+
+//======================================================================================================================
+
+bool DrawingWidget::isBatchActive() const
+{
+    return (mBatchDepth > 0);
+}
+
+void DrawingWidget::setCullingEnabled(bool enabled)
+{
+    if (mCullingEnabled != enabled)
+    {
+        mCullingEnabled = enabled;
+        viewport()->update();
+    }
+}
+
+bool DrawingWidget::isCullingEnabled() const
+{
+    return mCullingEnabled;
+}
+
+bool DrawingWidget::isProfilerOverlayVisible() const
+{
+    return mProfilerOverlayVisible;
+}
+
+//======================================================================================================================
+
+OdgMemoryUsage DrawingWidget::memoryUsage() const
+{
+    OdgMemoryUsage usage = OdgDrawing::memoryUsage();
+
+    if (mDefaultStyle) usage.add("Default Style", mDefaultStyle->memoryUsage());
+
+    // Undo commands only count the items they own, i.e. items that are not currently part of the drawing
+    usage.add("Undo History", mUndoStack.memoryUsage(), mUndoStack.count());
+
+    if (!mPlaceItems.isEmpty())
+    {
+        qint64 placeItemsBytes = 0;
+        for(auto& item : mPlaceItems) placeItemsBytes += item->memoryUsage();
+        usage.add("Place Items", placeItemsBytes, mPlaceItems.size());
+    }
+
+    return usage;
+}
+
+//======================================================================================================================
+
 void DrawingWidget::insertPage(int index, OdgPage* page)
 {
     if (page)
@@ -784,6 +894,8 @@ void DrawingWidget::reorderItems(OdgPage* page, const QList<OdgItem*>& items)
 
 void DrawingWidget::moveItems(const QList<OdgItem*>& items, const QHash<OdgItem*,QPointF>& positions, bool place)
 {
+    markItemsDirty(items);
+
     // Move the items
     for(auto& item : items) item->setPosition(positions.value(item));
 
@@ -797,10 +909,10 @@ void DrawingWidget::moveItems(const QList<OdgItem*>& items, const QHash<OdgItem*
     if (items == currentItems())
     {
         if (mMode == Odg::SelectMode) updateSelectionCenter();
-        emit currentItemsGeometryChanged(items);
+        notifyCurrentItemsGeometryChanged(items);
     }
 
-    viewport()->update();
+    updateItems(items);
 }
 
 void DrawingWidget::resizeItem(OdgControlPoint* point, const QPointF& position, bool snapTo45Degrees, bool disconnect,
@@ -812,11 +924,13 @@ void DrawingWidget::resizeItem(OdgControlPoint* point, const QPointF& position,
         QList<OdgItem*> items;
         items.append(item);
 
+        markItemsDirty(items);
+
         // Resize the item
         item->resize(point, position, snapTo45Degrees);
 
         // Disconnect this point from its glue point
-        if (disconnect) point->disconnect();
+        if (disconnect) mConnectionGraph.disconnect(point);
 
         // Maintain any connections after the resize (applies to other item control points only since we just
         // disconnected this point)
@@ -829,10 +943,10 @@ void DrawingWidget::resizeItem(OdgControlPoint* point, const QPointF& position,
         if (items == currentItems())
         {
             if (mMode == Odg::SelectMode) updateSelectionCenter();
-            emit currentItemsGeometryChanged(items);
+            notifyCurrentItemsGeometryChanged(items);
         }
 
-        viewport()->update();
+        updateItems(items);
     }
 }
 
@@ -846,13 +960,15 @@ void DrawingWidget::resizeItem2(OdgControlPoint* point1, const QPointF& p1, OdgC
         QList<OdgItem*> items;
         items.append(item1);
 
+        markItemsDirty(items);
+
         // Resize the item
         item1->resize(point1, p1, false);
         item2->resize(point2, p2, false);
 
         // Disconnect this point from its glue point
-        point1->disconnect();
-        point2->disconnect();
+        mConnectionGraph.disconnect(point1);
+        mConnectionGraph.disconnect(point2);
 
         // Maintain any connections after the resize (applies to other item control points only since we just
         // disconnected this point)
@@ -865,10 +981,10 @@ void DrawingWidget::resizeItem2(OdgControlPoint* point1, const QPointF& p1, OdgC
         if (items == currentItems())
         {
             if (mMode == Odg::SelectMode) updateSelectionCenter();
-            emit currentItemsGeometryChanged(items);
+            notifyCurrentItemsGeometryChanged(items);
         }
 
-        viewport()->update();
+        updateItems(items);
     }
 }
 
@@ -876,6 +992,8 @@ void DrawingWidget::resizeItem2(OdgControlPoint* point1, const QPointF& p1, OdgC
 
 void DrawingWidget::rotateItems(const QList<OdgItem*>& items, const QPointF& position)
 {
+    markItemsDirty(items);
+
     // Rotate the items
     for(auto& item : items) item->rotate(position);
 
@@ -883,13 +1001,15 @@ void DrawingWidget::rotateItems(const QList<OdgItem*>& items, const QPointF& pos
     maintainItemConnections(items);
 
     // Signal any listeners that current items' geometry may have changed
-    if (items == currentItems()) emit currentItemsGeometryChanged(items);
+    if (items == currentItems()) notifyCurrentItemsGeometryChanged(items);
 
-    viewport()->update();
+    updateItems(items);
 }
 
 void DrawingWidget::rotateBackItems(const QList<OdgItem*>& items, const QPointF& position)
 {
+    markItemsDirty(items);
+
     // Rotate the items back
     for(auto& item : items) item->rotateBack(position);
 
@@ -897,13 +1017,15 @@ void DrawingWidget::rotateBackItems(const QList<OdgItem*>& items, const QPointF&
     maintainItemConnections(items);
 
     // Signal any listeners that current items' geometry may have changed
-    if (items == currentItems()) emit currentItemsGeometryChanged(items);
+    if (items == currentItems()) notifyCurrentItemsGeometryChanged(items);
 
-    viewport()->update();
+    updateItems(items);
 }
 
 void DrawingWidget::flipItemsHorizontal(const QList<OdgItem*>& items, const QPointF& position)
 {
+    markItemsDirty(items);
+
     // Flip the items horizontally
     for(auto& item : items) item->flipHorizontal(position);
 
@@ -911,13 +1033,15 @@ void DrawingWidget::flipItemsHorizontal(const QList<OdgItem*>& items, const QPoi
     maintainItemConnections(items);
 
     // Signal any listeners that current items' geometry may have changed
-    if (items == currentItems()) emit currentItemsGeometryChanged(items);
+    if (items == currentItems()) notifyCurrentItemsGeometryChanged(items);
 
-    viewport()->update();
+    updateItems(items);
 }
 
 void DrawingWidget::flipItemsVertical(const QList<OdgItem*>& items, const QPointF& position)
 {
+    markItemsDirty(items);
+
     // Flip the items vertically
     for(auto& item : items) item->flipVertical(position);
 
@@ -925,9 +1049,9 @@ void DrawingWidget::flipItemsVertical(const QList<OdgItem*>& items, const QPoint
     maintainItemConnections(items);
 
     // Signal any listeners that current items' geometry may have changed
-    if (items == currentItems()) emit currentItemsGeometryChanged(items);
+    if (items == currentItems()) notifyCurrentItemsGeometryChanged(items);
 
-    viewport()->update();
+    updateItems(items);
 }
 
 //======================================================================================================================
@@ -939,6 +1063,8 @@ void DrawingWidget::insertItemPoint(OdgItem* item, int index, OdgControlPoint* p
         QList<OdgItem*> items;
         items.append(item);
 
+        markItemsDirty(items);
+
         // Insert the new point
         item->insertControlPoint(index, point);
 
@@ -946,11 +1072,11 @@ void DrawingWidget::insertItemPoint(OdgItem* item, int index, OdgControlPoint* p
         if (items == currentItems())
         {
             if (mMode == Odg::SelectMode) updateSelectionCenter();
-            emit currentItemsGeometryChanged(items);
+            notifyCurrentItemsGeometryChanged(items);
         }
 
         updateActions();
-        viewport()->update();
+        updateItems(items);
     }
 }
 
@@ -961,6 +1087,8 @@ void DrawingWidget::removeItemPoint(OdgItem* item, OdgControlPoint* point)
         QList<OdgItem*> items;
         items.append(item);
 
+        markItemsDirty(items);
+
         // Remove the current point
         item->removeControlPoint(point);
 
@@ -968,11 +1096,11 @@ void DrawingWidget::removeItemPoint(OdgItem* item, OdgControlPoint* point)
         if (items == currentItems())
         {
             if (mMode == Odg::SelectMode) updateSelectionCenter();
-            emit currentItemsGeometryChanged(items);
+            notifyCurrentItemsGeometryChanged(items);
         }
 
         updateActions();
-        viewport()->update();
+        updateItems(items);
     }
 }
 
@@ -980,6 +1108,8 @@ void DrawingWidget::removeItemPoint(OdgItem* item, OdgControlPoint* point)
 
 void DrawingWidget::placeItems(const QList<OdgItem*>& items)
 {
+    DrawingProfileScope profileScope("DrawingWidget::placeItems");
+
     if (mCurrentPage)
     {
         QList<OdgGluePoint*> currentPageItemGluePoints;
@@ -1000,7 +1130,7 @@ void DrawingWidget::placeItems(const QList<OdgItem*>& items)
                         for(auto& controlPoint : qAsConst(controlPoints))
                         {
                             if (shouldConnect(controlPoint, currentPageItemGluePoint))
-                                controlPoint->connect(currentPageItemGluePoint);
+                                mConnectionGraph.connect(controlPoint, currentPageItemGluePoint);
                         }
                     }
                 }
@@ -1025,7 +1155,7 @@ void DrawingWidget::unplaceItems(const QList<OdgItem*>& items)
         {
             gluePoint = controlPoint->gluePoint();
             if (gluePoint && !items.contains(gluePoint->item()))
-                controlPoint->disconnect();
+                mConnectionGraph.disconnect(controlPoint);
         }
 
         // Disconnect each glue point connected to a control point of an item not in items
@@ -1036,7 +1166,7 @@ void DrawingWidget::unplaceItems(const QList<OdgItem*>& items)
             for(auto& controlPoint : qAsConst(controlPoints))
             {
                 if (!items.contains(controlPoint->item()))
-                    controlPoint->disconnect();
+                    mConnectionGraph.disconnect(controlPoint);
             }
         }
     }
@@ -1044,12 +1174,19 @@ void DrawingWidget::unplaceItems(const QList<OdgItem*>& items)
 
 void DrawingWidget::maintainItemConnections(const QList<OdgItem*>& items)
 {
+    DrawingProfileScope profileScope("DrawingWidget::maintainItemConnections");
+
     QList<OdgGluePoint*> gluePoints;
     QList<OdgControlPoint*> controlPoints;
     OdgItem* targetItem = nullptr;
     QPointF gluePointScenePosition;
+    QList<OdgItem*> resizedItems;
+    QSet<OdgItem*> resizedItemsSet;
 
-    for(auto& item : items)
+    // Visit items and everything glued downstream of them in topological order so that each affected item is
+    // updated once, after all of the items it is glued to have reached their final positions
+    const QList<OdgItem*> orderedItems = connectionGraph().propagationOrder(items);
+    for(auto& item : orderedItems)
     {
         gluePoints = item->gluePoints();
         for(auto& gluePoint : qAsConst(gluePoints))
@@ -1061,16 +1198,40 @@ void DrawingWidget::maintainItemConnections(const QList<OdgItem*>& items)
             {
                 targetItem = controlPoint->item();
                 if (targetItem && targetItem->mapToScene(controlPoint->position()) != gluePointScenePosition)
-                    resizeItem(controlPoint, gluePointScenePosition, false, false, false);
+                {
+                    if (!resizedItemsSet.contains(targetItem))
+                    {
+                        markItemsDirty(QList<OdgItem*>(1, targetItem));
+                        resizedItemsSet.insert(targetItem);
+                        resizedItems.append(targetItem);
+                    }
+
+                    targetItem->resize(controlPoint, gluePointScenePosition, false);
+                }
             }
         }
     }
+
+    if (!resizedItems.isEmpty())
+    {
+        // Signal any listeners that current items' geometry may have changed
+        const QList<OdgItem*> current = currentItems();
+        if (current.size() == 1 && resizedItemsSet.contains(current.first()))
+        {
+            if (mMode == Odg::SelectMode) updateSelectionCenter();
+            notifyCurrentItemsGeometryChanged(current);
+        }
+
+        updateItems(resizedItems);
+    }
 }
 
 //======================================================================================================================
 
 void DrawingWidget::setItemsProperty(const QList<OdgItem*>& items, const QString& name, const QVariant& value)
 {
+    markItemsDirty(items);
+
     // Update the items' property
     for(auto& item : items) item->setProperty(name, value);
 
@@ -1078,15 +1239,17 @@ void DrawingWidget::setItemsProperty(const QList<OdgItem*>& items, const QString
     if (items == currentItems())
     {
         if (mMode == Odg::SelectMode) updateSelectionCenter();
-        emit currentItemsPropertyChanged(items);
+        notifyCurrentItemsPropertyChanged(items);
     }
 
-    viewport()->update();
+    updateItems(items);
 }
 
 void DrawingWidget::setItemsProperty(const QList<OdgItem*>& items, const QString& name,
                                      const QHash<OdgItem*,QVariant>& values)
 {
+    markItemsDirty(items);
+
     // Update the items' property
     for(auto& item : items) item->setProperty(name, values.value(item));
 
@@ -1094,10 +1257,10 @@ void DrawingWidget::setItemsProperty(const QList<OdgItem*>& items, const QString
     if (items == currentItems())
     {
         if (mMode == Odg::SelectMode) updateSelectionCenter();
-        emit currentItemsPropertyChanged(items);
+        notifyCurrentItemsPropertyChanged(items);
     }
 
-    viewport()->update();
+    updateItems(items);
 }
 
 //======================================================================================================================
@@ -1106,6 +1269,9 @@ void DrawingWidget::setSelectedItems(const QList<OdgItem*>& items)
 {
     if (mSelectedItems != items)
     {
+        // A drag in progress only knows the initial positions of the items that were selected when it started
+        finishSelectDrag();
+
         // Set previous items as no longer selected
         for(auto& item : qAsConst(mSelectedItems)) item->setSelected(false);
 
@@ -1116,9 +1282,10 @@ void DrawingWidget::setSelectedItems(const QList<OdgItem*>& items)
         updateActions();
 
         // Signal any listeners that the current items changed
-        if (mMode == Odg::SelectMode) emit currentItemsChanged(mSelectedItems);
+        if (mMode == Odg::SelectMode) notifyCurrentItemsChanged(mSelectedItems);
 
-        viewport()->update();
+        if (mBatchDepth > 0) mBatchFullUpdate = true;
+        else viewport()->update();
     }
 }
 
@@ -1243,6 +1410,7 @@ void DrawingWidget::setScrollMode()
     if (mMode != Odg::ScrollMode)
     {
         // Clear select mode state
+        finishSelectDrag();
         selectNone();
         mSelectMouseDownItem = nullptr;
         mSelectMouseDownPoint = nullptr;
@@ -1270,6 +1438,7 @@ void DrawingWidget::setZoomMode()
 {
     if (mMode != Odg::ZoomMode)
     {
+        finishSelectDrag();
         selectNone();
         mSelectMouseDownItem = nullptr;
         mSelectMouseDownPoint = nullptr;
@@ -1298,6 +1467,7 @@ void DrawingWidget::setPlaceMode(const QList<OdgItem*>& items, bool placeByMouse
     if (!items.isEmpty() && (mMode != Odg::PlaceMode || mPlaceItems != items))
     {
         // Clear select mode state
+        finishSelectDrag();
         selectNone();
         mSelectMouseDownItem = nullptr;
         mSelectMouseDownPoint = nullptr;
@@ -1335,21 +1505,97 @@ void DrawingWidget::setPlaceMode(const QList<OdgItem*>& items, bool placeByMouse
 
 void DrawingWidget::undo()
 {
-    if (mMode == Odg::SelectMode) mUndoStack.undo();
+    if (mBatchDepth > 0 || isSelectDragActive()) return;
+
+    if (mMode == Odg::SelectMode)
+    {
+        DrawingProfileScope profileScope("DrawingWidget::undo");
+        mUndoStack.undo();
+        if (mProfilerOverlayVisible) mProfileCommandTime = profileScope.elapsed();
+    }
     else setSelectMode();
 }
 
 void DrawingWidget::redo()
 {
-    if (mMode == Odg::SelectMode) mUndoStack.redo();
+    if (mBatchDepth > 0 || isSelectDragActive()) return;
+
+    if (mMode == Odg::SelectMode)
+    {
+        DrawingProfileScope profileScope("DrawingWidget::redo");
+        mUndoStack.redo();
+        if (mProfilerOverlayVisible) mProfileCommandTime = profileScope.elapsed();
+    }
     else setSelectMode();
 }
 
 //======================================================================================================================
 
+void DrawingWidget::beginBatch()
+{
+    if (mBatchDepth == 0)
+    {
+        mBatchDirtyRect = QRectF();
+        mBatchFullUpdate = false;
+        mBatchItemsChanged = false;
+        mBatchGeometryChanged = false;
+        mBatchPropertyChanged = false;
+    }
+
+    mBatchDepth++;
+}
+
+void DrawingWidget::commitBatch()
+{
+    if (mBatchDepth > 0)
+    {
+        mBatchDepth--;
+        if (mBatchDepth == 0)
+        {
+            // Push all of the commands collected during the batch as a single undo step
+            DrawingBatchCommand* batchCommand = mBatchCommand;
+            mBatchCommand = nullptr;
+            if (batchCommand && batchCommand->commandCount() > 0)
+                mUndoStack.push(batchCommand);
+            else
+                delete batchCommand;
+
+            // Signal any listeners once for the whole batch.  Listeners reload everything about the current items
+            // on any of these signals, so only the most general one is needed.
+            if (mBatchItemsChanged)
+                emit currentItemsChanged(currentItems());
+            else if (mBatchPropertyChanged)
+                emit currentItemsPropertyChanged(currentItems());
+            else if (mBatchGeometryChanged)
+                emit currentItemsGeometryChanged(currentItems());
+
+            // Repaint the union of the areas touched by the batch once
+            if (mBatchFullUpdate)
+                viewport()->update();
+            else if (mBatchDirtyRect.isValid())
+                viewport()->update(mapFromScene(mBatchDirtyRect).adjusted(-16, -16, 16, 16));
+        }
+    }
+}
+
+//======================================================================================================================
+
+void DrawingWidget::setProfilerOverlayVisible(bool visible)
+{
+    if (mProfilerOverlayVisible != visible)
+    {
+        // The overlay is the opt-in for the profiler; nothing is recorded while it is hidden
+        mProfilerOverlayVisible = visible;
+        DrawingProfiler::setEnabled(visible);
+        viewport()->update();
+    }
+}
+
+//======================================================================================================================
+
 void DrawingWidget::setDrawingProperty(const QString& name, const QVariant& value)
 {
-    if (mCurrentPage) mUndoStack.push(new DrawingSetPropertyCommand(this, name, value));
+    if (mCurrentPage) pushCommand(new DrawingSetPropertyCommand(this, name, value));
 }
 
 //======================================================================================================================
@@ -1378,7 +1624,7 @@ void DrawingWidget::insertPage()
 
     // Create the new page and add it to the view
     OdgPage* newPage = new OdgPage(name);
-    mUndoStack.push(new DrawingInsertPageCommand(this, newPage, currentPageIndex() + 1));
+    pushCommand(new DrawingInsertPageCommand(this, newPage, currentPageIndex() + 1));
     zoomFit();
 }
 
@@ -1413,19 +1659,19 @@ void DrawingWidget::duplicatePage()
         QList<OdgItem*> copiedItems = OdgItem::copyItems(mCurrentPage->items());
         for(auto& item : copiedItems) newPage->addItem(item);
 
-        mUndoStack.push(new DrawingInsertPageCommand(this, newPage, currentPageIndex() + 1));
+        pushCommand(new DrawingInsertPageCommand(this, newPage, currentPageIndex() + 1));
         zoomFit();
     }
 }
 
 void DrawingWidget::removePage()
 {
-    if (mCurrentPage) mUndoStack.push(new DrawingRemovePageCommand(this, mCurrentPage));
+    if (mCurrentPage) pushCommand(new DrawingRemovePageCommand(this, mCurrentPage));
 }
 
 void DrawingWidget::movePage(int index)
 {
-    if (mCurrentPage) mUndoStack.push(new DrawingMovePageCommand(this, mCurrentPage, index));
+    if (mCurrentPage) pushCommand(new DrawingMovePageCommand(this, mCurrentPage, index));
 }
 
 //======================================================================================================================
@@ -1438,6 +1684,7 @@ void DrawingWidget::setCurrentPage(OdgPage* page)
         setSelectMode();
 
         mCurrentPage = page;
+        mConnectionGraph.clear();
         emit currentPageChanged(mCurrentPage);
         emit currentPageIndexChanged(currentPageIndex());
         viewport()->update();
@@ -1453,7 +1700,7 @@ void DrawingWidget::setCurrentPageIndex(int index)
 
 void DrawingWidget::setPageProperty(const QString& name, const QVariant& value)
 {
-    if (mCurrentPage) mUndoStack.push(new DrawingSetPagePropertyCommand(this, mCurrentPage, name, value));
+    if (mCurrentPage) pushCommand(new DrawingSetPagePropertyCommand(this, mCurrentPage, name, value));
 }
 
 void DrawingWidget::renamePage(const QString& name)
@@ -1468,7 +1715,7 @@ void DrawingWidget::removeItems()
     if (mCurrentPage && mMode == Odg::SelectMode)
     {
         if (!mSelectedItems.isEmpty())
-            mUndoStack.push(new DrawingRemoveItemsCommand(this, mCurrentPage, mSelectedItems));
+            pushCommand(new DrawingRemoveItemsCommand(this, mCurrentPage, mSelectedItems));
     }
     else setSelectMode();
 }
@@ -1484,57 +1731,51 @@ void DrawingWidget::cut()
 void DrawingWidget::copy()
 {
     if (mCurrentPage && mMode == Odg::SelectMode && !mSelectedItems.isEmpty())
-    {
-        OdgWriter writer;
-        writer.setUnits(mUnits);
-        writer.setPageSize(mPageSize);
-        writer.setPageMargins(mPageMargins);
-        writer.setBackgroundColor(mBackgroundColor);
-        writer.setGrid(mGrid);
-        writer.setGridStyle(mGridStyle);
-        writer.setGridColor(mGridColor);
-        writer.setGridSpacingMajor(mGridSpacingMajor);
-        writer.setGridSpacingMinor(mGridSpacingMinor);
-
-        writer.setDefaultStyle(mDefaultStyle);
-
-        OdgPage* page = new OdgPage(mCurrentPage->name());
-        for(auto& item : qAsConst(mSelectedItems))
-            page->addItem(item);
-        writer.setPages(QList<OdgPage*>(1, page));
-
-        writer.writeToClipboard();
-    }
+        QGuiApplication::clipboard()->setMimeData(new DrawingMimeData(this, mCurrentPage->name(), mSelectedItems));
 }
 
 void DrawingWidget::paste()
 {
     if (mCurrentPage && mMode == Odg::SelectMode)
     {
-        OdgReader reader;
-        reader.readFromClipboard();
+        QList<OdgItem*> items;
+        Odg::Units itemUnits = mUnits;
 
-        const QList<OdgPage*> pages = reader.takePages();
-        if (!pages.isEmpty())
+        const DrawingMimeData* drawingData = DrawingMimeData::fromMimeData(QGuiApplication::clipboard()->mimeData());
+        if (drawingData)
         {
-            OdgPage* page = pages.first();
-
-            const QList<OdgItem*> items = page->items();
-            for(auto& item : qAsConst(items))
-                page->removeItem(item);
+            // Items copied within this process are copied again directly rather than parsed back from the XML
+            items = OdgItem::copyItems(drawingData->items());
+            itemUnits = drawingData->units();
+        }
+        else
+        {
+            OdgReader reader;
+            reader.readFromClipboard();
 
-            if (mUnits != reader.units())
+            const QList<OdgPage*> pages = reader.takePages();
+            if (!pages.isEmpty())
             {
-                double scaleFactor = Odg::convertUnits(1.0, reader.units(), mUnits);
+                OdgPage* page = pages.first();
+
+                items = page->items();
                 for(auto& item : qAsConst(items))
-                    item->scaleBy(scaleFactor);
+                    page->removeItem(item);
             }
+            itemUnits = reader.units();
+
+            qDeleteAll(pages);
+        }
 
-            if (!items.isEmpty())
-                setPlaceMode(items, false);
+        if (mUnits != itemUnits)
+        {
+            double scaleFactor = Odg::convertUnits(1.0, itemUnits, mUnits);
+            for(auto& item : qAsConst(items))
+                item->scaleBy(scaleFactor);
         }
 
-        qDeleteAll(pages);
+        if (!items.isEmpty())
+            setPlaceMode(items, false);
     }
 }
 
@@ -1558,7 +1799,7 @@ void DrawingWidget::move(const QPointF& position)
     {
         QHash<OdgItem*,QPointF> newPositions;
         newPositions.insert(mSelectedItems.first(), position);
-        mUndoStack.push(new DrawingMoveItemsCommand(this, mSelectedItems, newPositions, true));
+        pushCommand(new DrawingMoveItemsCommand(this, mSelectedItems, newPositions, true));
     }
 }
 
@@ -1569,20 +1810,20 @@ void DrawingWidget::moveDelta(const QPointF& delta)
         QHash<OdgItem*,QPointF> newPositions;
         for(auto& item : mSelectedItems)
             newPositions.insert(item, item->position() + delta);
-        mUndoStack.push(new DrawingMoveItemsCommand(this, mSelectedItems, newPositions, true));
+        pushCommand(new DrawingMoveItemsCommand(this, mSelectedItems, newPositions, true));
     }
 }
 
 void DrawingWidget::resize(OdgControlPoint* point, const QPointF& position)
 {
     if (point && mMode == Odg::SelectMode && mSelectedItems.size() == 1)
-        mUndoStack.push(new DrawingResizeItemCommand(this, point, position, false, true));
+        pushCommand(new DrawingResizeItemCommand(this, point, position, false, true));
 }
 
 void DrawingWidget::resize2(OdgControlPoint* point1, const QPointF& p1, OdgControlPoint* point2, const QPointF& p2)
 {
     if (point1 && point2 && mMode == Odg::SelectMode && mSelectedItems.size() == 1)
-        mUndoStack.push(new DrawingResizeItem2Command(this, point1, p1, point2, p2, true));
+        pushCommand(new DrawingResizeItem2Command(this, point1, p1, point2, p2, true));
 }
 
 //======================================================================================================================
@@ -1592,7 +1833,7 @@ void DrawingWidget::rotate()
     if (mMode == Odg::SelectMode)
     {
         if (!mSelectedItems.isEmpty())
-            mUndoStack.push(new DrawingRotateItemsCommand(this, mSelectedItems, mSelectedItemsCenter));
+            pushCommand(new DrawingRotateItemsCommand(this, mSelectedItems, mSelectedItemsCenter));
     }
     else if (mMode == Odg::PlaceMode)
     {
@@ -1609,7 +1850,7 @@ void DrawingWidget::rotateBack()
     if (mMode == Odg::SelectMode)
     {
         if (!mSelectedItems.isEmpty())
-            mUndoStack.push(new DrawingRotateBackItemsCommand(this, mSelectedItems, mSelectedItemsCenter));
+            pushCommand(new DrawingRotateBackItemsCommand(this, mSelectedItems, mSelectedItemsCenter));
     }
     else if (mMode == Odg::PlaceMode)
     {
@@ -1626,7 +1867,7 @@ void DrawingWidget::flipHorizontal()
     if (mMode == Odg::SelectMode)
     {
         if (!mSelectedItems.isEmpty())
-            mUndoStack.push(new DrawingFlipItemsHorizontalCommand(this, mSelectedItems, mSelectedItemsCenter));
+            pushCommand(new DrawingFlipItemsHorizontalCommand(this, mSelectedItems, mSelectedItemsCenter));
     }
     else if (mMode == Odg::PlaceMode)
     {
@@ -1643,7 +1884,7 @@ void DrawingWidget::flipVertical()
     if (mMode == Odg::SelectMode)
     {
         if (!mSelectedItems.isEmpty())
-            mUndoStack.push(new DrawingFlipItemsVerticalCommand(this, mSelectedItems, mSelectedItemsCenter));
+            pushCommand(new DrawingFlipItemsVerticalCommand(this, mSelectedItems, mSelectedItemsCenter));
     }
     else if (mMode == Odg::PlaceMode)
     {
@@ -1674,7 +1915,7 @@ void DrawingWidget::bringForward()
             }
         }
 
-        mUndoStack.push(new DrawingReorderItemsCommand(this, mCurrentPage, itemsOrdered));
+        pushCommand(new DrawingReorderItemsCommand(this, mCurrentPage, itemsOrdered));
     }
 }
 
@@ -1695,7 +1936,7 @@ void DrawingWidget::sendBackward()
             }
         }
 
-        mUndoStack.push(new DrawingReorderItemsCommand(this, mCurrentPage, itemsOrdered));
+        pushCommand(new DrawingReorderItemsCommand(this, mCurrentPage, itemsOrdered));
     }
 }
 
@@ -1716,7 +1957,7 @@ void DrawingWidget::bringToFront()
             }
         }
 
-        mUndoStack.push(new DrawingReorderItemsCommand(this, mCurrentPage, itemsOrdered));
+        pushCommand(new DrawingReorderItemsCommand(this, mCurrentPage, itemsOrdered));
     }
 }
 
@@ -1737,7 +1978,7 @@ void DrawingWidget::sendToBack()
             }
         }
 
-        mUndoStack.push(new DrawingReorderItemsCommand(this, mCurrentPage, itemsOrdered));
+        pushCommand(new DrawingReorderItemsCommand(this, mCurrentPage, itemsOrdered));
     }
 }
 
@@ -1755,7 +1996,7 @@ void DrawingWidget::group()
         }
 
         if (!itemsToGroup.isEmpty())
-            mUndoStack.push(new DrawingGroupItemsCommand(this, mCurrentPage, itemsToGroup));
+            pushCommand(new DrawingGroupItemsCommand(this, mCurrentPage, itemsToGroup));
     }
 }
 
@@ -1763,9 +2004,9 @@ void DrawingWidget::ungroup()
 {
     if (mCurrentPage && mMode == Odg::SelectMode && mSelectedItems.size() == 1)
     {
-        OdgGroupItem* groupItem = dynamic_cast<OdgGroupItem*>(mSelectedItems.first());
-        if (groupItem && mCurrentPage->items().contains(groupItem))
-            mUndoStack.push(new DrawingUngroupItemsCommand(this, mCurrentPage, groupItem));
+        OdgItem* item = mSelectedItems.first();
+        if (item->type() == OdgItem::GroupType && mCurrentPage->items().contains(item))
+            pushCommand(new DrawingUngroupItemsCommand(this, mCurrentPage, static_cast<OdgGroupItem*>(item)));
     }
 }
 
@@ -1782,7 +2023,7 @@ void DrawingWidget::insertPoint()
             if (insertIndex >= 0)
             {
                 const QPointF position = item->mapFromScene(roundToGrid(mMouseButtonDownScenePosition));
-                mUndoStack.push(new DrawingInsertPointCommand(this, item, insertIndex, new OdgControlPoint(position)));
+                pushCommand(new DrawingInsertPointCommand(this, item, insertIndex, new OdgControlPoint(position)));
             }
         }
     }
@@ -1797,7 +2038,7 @@ void DrawingWidget::removePoint()
         {
             int removeIndex = item->removePointIndex(mMouseButtonDownScenePosition);
             if (0 <= removeIndex && removeIndex < item->controlPoints().size())
-                mUndoStack.push(new DrawingRemovePointCommand(this, item, item->controlPoints().at(removeIndex)));
+                pushCommand(new DrawingRemovePointCommand(this, item, item->controlPoints().at(removeIndex)));
         }
     }
 }
@@ -1809,7 +2050,7 @@ void DrawingWidget::setItemsProperty(const QString& name, const QVariant& value)
     if (mMode == Odg::SelectMode)
     {
         if (!mSelectedItems.isEmpty())
-            mUndoStack.push(new DrawingSetItemsPropertyCommand(this, mSelectedItems, name, value));
+            pushCommand(new DrawingSetItemsPropertyCommand(this, mSelectedItems, name, value));
     }
     else if (mMode == Odg::PlaceMode)
     {
@@ -1818,6 +2059,14 @@ void DrawingWidget::setItemsProperty(const QString& name, const QVariant& value)
     }
 }
 
+void DrawingWidget::setItemsProperties(const QHash<QString,QVariant>& properties)
+{
+    beginBatch();
+    for(auto propertyIter = properties.cbegin(); propertyIter != properties.cend(); propertyIter++)
+        setItemsProperty(propertyIter.key(), propertyIter.value());
+    commitBatch();
+}
+
 void DrawingWidget::setDefaultStyleProperty(const QString& name, const QVariant& value)
 {
     if (mDefaultStyle)
@@ -1857,6 +2106,8 @@ void DrawingWidget::setDefaultStyleProperty(const QString& name, const QVariant&
 
 void DrawingWidget::paintEvent(QPaintEvent* event)
 {
+    DrawingProfileScope profileScope("DrawingWidget::paintEvent");
+
     QPainter painter(viewport());
     painter.setBrush(palette().brush(QPalette::Dark));
     painter.setPen(QPen(Qt::NoPen));
@@ -1887,6 +2138,14 @@ void DrawingWidget::paintEvent(QPaintEvent* event)
             break;
         }
     }
+
+    if (mProfilerOverlayVisible)
+    {
+        mProfilePaintTime = profileScope.elapsed();
+        DrawingProfiler::addCounter("itemsDrawn", mProfileItemsDrawn);
+        DrawingProfiler::addCounter("itemsCulled", mProfileItemsCulled);
+        drawProfilerOverlay(painter);
+    }
 }
 
 void DrawingWidget::drawBackground(QPainter& painter, bool drawBorder, bool drawGrid)
@@ -1967,14 +2226,8 @@ void DrawingWidget::drawGridLines(QPainter& painter, const QColor& color, int sp
 
 void DrawingWidget::drawItems(QPainter& painter, const QList<OdgItem*>& items)
 {
-    painter.setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing, true);
-
-    for(auto& item : items)
-    {
-        painter.setTransform(item->transform(), true);
-        item->paint(painter);
-        painter.setTransform(item->transformInverse(), true);
-    }
+    DrawingProfileScope profileScope("DrawingWidget::drawItems");
+    OdgItem::paintItems(painter, items);
 }
 
 void DrawingWidget::drawItemPoints(QPainter& painter, const QList<OdgItem*>& items)
@@ -2009,6 +2262,8 @@ void DrawingWidget::drawItemPoints(QPainter& painter, const QList<OdgItem*>& ite
 
 void DrawingWidget::drawHotpoints(QPainter& painter, const QList<OdgItem*>& items)
 {
+    DrawingProfileScope profileScope("DrawingWidget::drawHotpoints");
+
     painter.setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing, false);
     painter.setBrush(QBrush(QColor(255, 128, 0, 192)));
     painter.setPen(QPen(Qt::NoPen));
@@ -2070,6 +2325,44 @@ void DrawingWidget::drawRubberBand(QPainter& painter, const QRect& rect)
     }
 }
 
+void DrawingWidget::drawProfilerOverlay(QPainter& painter)
+{
+    QStringList lines;
+    lines << QString("Paint: %1 ms").arg(mProfilePaintTime / 1E6, 0, 'f', 2);
+    lines << QString("Items: %1 drawn, %2 culled").arg(mProfileItemsDrawn).arg(mProfileItemsCulled);
+    lines << QString("Hit test: %1 candidates").arg(mProfileHitTestCandidates);
+    lines << QString("Command: %1 ms").arg(mProfileCommandTime / 1E6, 0, 'f', 2);
+
+    painter.save();
+    painter.resetTransform();
+    painter.setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing, false);
+
+    QFont font = viewport()->font();
+    font.setStyleHint(QFont::Monospace);
+    font.setFamily("monospace");
+    painter.setFont(font);
+
+    const QFontMetrics fontMetrics(font);
+    int width = 0;
+    for(auto& line : qAsConst(lines))
+        width = qMax(width, fontMetrics.horizontalAdvance(line));
+
+    const int padding = 6;
+    const QRect rect(8, 8, width + 2 * padding, lines.size() * fontMetrics.height() + 2 * padding);
+    painter.setBrush(QColor(0, 0, 0, 160));
+    painter.setPen(Qt::NoPen);
+    painter.drawRect(rect);
+
+    painter.setPen(QColor(255, 255, 255));
+    for(int i = 0; i < lines.size(); i++)
+    {
+        painter.drawText(rect.left() + padding, rect.top() + padding + i * fontMetrics.height() + fontMetrics.ascent(),
+                         lines.at(i));
+    }
+
+    painter.restore();
+}
+
 //======================================================================================================================
 
 void DrawingWidget::resizeEvent(QResizeEvent* event)
@@ -2289,6 +2582,13 @@ void DrawingWidget::mouseReleaseEvent(QMouseEvent* event)
     }
 }
 
+void DrawingWidget::focusOutEvent(QFocusEvent* event)
+{
+    // The mouse release that would end a drag may never arrive once another window has the focus
+    finishSelectDrag();
+    QAbstractScrollArea::focusOutEvent(event);
+}
+
 void DrawingWidget::wheelEvent(QWheelEvent* event)
 {
     if (event && (event->modifiers() & Qt::ControlModifier))
@@ -2383,7 +2683,11 @@ void DrawingWidget::selectModeLeftMouseDragEvent(QMouseEvent* event)
 
 void DrawingWidget::selectModeLeftMouseReleaseEvent(QMouseEvent* event)
 {
-    switch (mSelectMouseState)
+    // The state is cleared first so that the commands pushed below aren't mistaken for changes made during a drag
+    const SelectModeMouseState selectMouseState = mSelectMouseState;
+    mSelectMouseState = SelectMouseIdle;
+
+    switch (selectMouseState)
     {
     case SelectMouseSelectItem:
         selectModeSingleSelectEvent(event);			// Select or deselect single item as needed
@@ -2402,7 +2706,6 @@ void DrawingWidget::selectModeLeftMouseReleaseEvent(QMouseEvent* event)
         break;
     }
 
-    mSelectMouseState = SelectMouseIdle;
     mSelectMouseDownItem = nullptr;
     mSelectMouseDownPoint = nullptr;
 }
@@ -2541,24 +2844,39 @@ void DrawingWidget::selectModeMoveItems(const QPointF& mousePosition, bool final
     if (!mSelectedItems.isEmpty())
     {
         const QPointF deltaPosition = roundToGrid(mousePosition - mMouseButtonDownScenePosition);
-        if (finalMove || deltaPosition != mSelectMoveItemsPreviousDeltaPosition)
+        if (finalMove)
         {
+            // Push a single undo command for the entire drag.  The items are already at their new positions, so
+            // the command needs to be told where they started.
             QHash<OdgItem*,QPointF> newPositions;
             for(auto& item : qAsConst(mSelectedItems))
                 newPositions.insert(item, mSelectMoveItemsInitialPositions.value(item) + deltaPosition);
 
-            mUndoStack.push(new DrawingMoveItemsCommand(this, mSelectedItems, newPositions, placeItems));
+            pushCommand(new DrawingMoveItemsCommand(this, mSelectedItems, newPositions,
+                                                    mSelectMoveItemsInitialPositions, placeItems));
 
-            if (!finalMove)
-            {
-                const QPointF position2 = newPositions.value(mSelectedItems.first());
-                const QPointF position1 = position2 - deltaPosition;
-                emit mouseInfoChanged(createMouseInfo(position1, position2));
-            }
-            else emit mouseInfoChanged("");
+            emit mouseInfoChanged("");
+        }
+        else if (deltaPosition != mSelectMoveItemsPreviousDeltaPosition)
+        {
+            // While dragging, move the items directly rather than creating (and merging) an undo command each time.
+            // The step runs as a batch so that only the area covered by the items before and after the move (and by
+            // any connected items) is repainted.  Listeners are told about the new geometry once, when the final
+            // move command is pushed on release.
+            beginBatch();
+            markItemsDirty(mSelectedItems);
+            for(auto& item : qAsConst(mSelectedItems))
+                item->setPosition(mSelectMoveItemsInitialPositions.value(item) + deltaPosition);
+            maintainItemConnections(mSelectedItems);
+            markItemsDirty(mSelectedItems);
+            updateSelectionCenter();
+            commitBatch();
 
-            mSelectMoveItemsPreviousDeltaPosition = deltaPosition;
+            const QPointF position1 = mSelectMoveItemsInitialPositions.value(mSelectedItems.first());
+            emit mouseInfoChanged(createMouseInfo(position1, position1 + deltaPosition));
         }
+
+        mSelectMoveItemsPreviousDeltaPosition = deltaPosition;
     }
 }
 
@@ -2591,18 +2909,71 @@ void DrawingWidget::selectModeResizeItem(const QPointF& mousePosition, bool snap
     if (mSelectMouseDownItem && mSelectMouseDownPoint)
     {
         const QPointF newPosition = roundToGrid(mousePosition);
-        if (finalResize || newPosition != mSelectResizeItemPreviousPosition)
+        if (finalResize)
         {
-            mUndoStack.push(new DrawingResizeItemCommand(this, mSelectMouseDownPoint, newPosition, snapTo45Degrees,
-                                                         finalResize));
+            // Push a single undo command for the entire drag, starting from the point's original position
+            pushCommand(new DrawingResizeItemCommand(this, mSelectMouseDownPoint, newPosition,
+                                                     mSelectResizeItemInitialPosition, snapTo45Degrees, true));
+            emit mouseInfoChanged("");
+        }
+        else if (newPosition != mSelectResizeItemPreviousPosition)
+        {
+            // While dragging, resize the item directly rather than creating an undo command each time
+            resizeItem(mSelectMouseDownPoint, newPosition, snapTo45Degrees, true, false);
+            emit mouseInfoChanged(createMouseInfo(mSelectResizeItemInitialPosition, newPosition));
+        }
 
-            if (!finalResize)
-                emit mouseInfoChanged(createMouseInfo(mSelectResizeItemInitialPosition, newPosition));
-            else
-                emit mouseInfoChanged("");
+        mSelectResizeItemPreviousPosition = newPosition;
+    }
+}
+
+//======================================================================================================================
+
+bool DrawingWidget::isSelectDragActive() const
+{
+    return (mMode == Odg::SelectMode &&
+            (mSelectMouseState == SelectMouseMoveItems || mSelectMouseState == SelectMouseResizeItem));
+}
+
+void DrawingWidget::finishSelectDrag()
+{
+    // Items are changed directly while they are dragged, with the undo command only pushed on mouse release.  If the
+    // drag ends any other way (mode change, selection change, loss of focus), the command for the changes made so far
+    // is pushed here so that they can still be undone.
+    if (isSelectDragActive())
+    {
+        const SelectModeMouseState selectMouseState = mSelectMouseState;
+        mSelectMouseState = SelectMouseIdle;
 
-            mSelectResizeItemPreviousPosition = newPosition;
+        if (selectMouseState == SelectMouseMoveItems && !mSelectMoveItemsPreviousDeltaPosition.isNull())
+        {
+            QHash<OdgItem*,QPointF> newPositions;
+            for(auto& item : qAsConst(mSelectedItems))
+                newPositions.insert(item, mSelectMoveItemsInitialPositions.value(item) +
+                                              mSelectMoveItemsPreviousDeltaPosition);
+            pushCommand(new DrawingMoveItemsCommand(this, mSelectedItems, newPositions,
+                                                    mSelectMoveItemsInitialPositions, false));
+        }
+        else if (selectMouseState == SelectMouseResizeItem && mSelectMouseDownItem && mSelectMouseDownPoint)
+        {
+            // The point is already where the drag left it (including any 45-degree snap)
+            const QPointF position = mSelectMouseDownItem->mapToScene(mSelectMouseDownPoint->position());
+            if (position != mSelectResizeItemInitialPosition)
+            {
+                pushCommand(new DrawingResizeItemCommand(this, mSelectMouseDownPoint, position,
+                                                         mSelectResizeItemInitialPosition, false, false));
+            }
         }
+
+        mSelectMoveItemsInitialPositions.clear();
+        mSelectMoveItemsPreviousDeltaPosition = QPointF();
+        mSelectResizeItemInitialPosition = QPointF();
+        mSelectResizeItemPreviousPosition = QPointF();
+        mSelectMouseDownItem = nullptr;
+        mSelectMouseDownPoint = nullptr;
+
+        emit mouseInfoChanged("");
+        viewport()->update();
     }
 }
 
@@ -2732,7 +3103,7 @@ void DrawingWidget::placeModeLeftMouseReleaseEvent(QMouseEvent* event)
     if (mCurrentPage && (mPlaceItems.size() > 1 || (mPlaceItems.size() == 1 && mPlaceItems.first()->isValid())))
     {
         // Add the items to the scene
-        mUndoStack.push(new DrawingAddItemsCommand(this, mCurrentPage, mPlaceItems, true));
+        pushCommand(new DrawingAddItemsCommand(this, mCurrentPage, mPlaceItems, true));
 
         // Create a new set of place items
         QList<OdgItem*> newPlaceItems = OdgItem::copyItems(mPlaceItems);
@@ -2766,6 +3137,9 @@ QString DrawingWidget::createMouseInfo(const QPointF& p1, const QPointF& p2) con
 
 OdgItem* DrawingWidget::itemAt(const QPointF& position) const
 {
+    DrawingProfileScope profileScope("DrawingWidget::itemAt");
+    mProfileHitTestCandidates = 0;
+
     if (mCurrentPage)
     {
         // Favor selected items; if not found in the selected items, search all items in the scene
@@ -2788,6 +3162,9 @@ OdgItem* DrawingWidget::itemAt(const QPointF& position) const
 
 QList<OdgItem*> DrawingWidget::items(const QRectF& rect) const
 {
+    DrawingProfileScope profileScope("DrawingWidget::items");
+    mProfileHitTestCandidates = 0;
+
     QList<OdgItem*> foundItems;
 
     if (mCurrentPage)
@@ -2807,10 +3184,7 @@ QList<OdgItem*> DrawingWidget::items(const QRectF& rect) const
 
 QRectF DrawingWidget::itemsRect(const QList<OdgItem*>& items) const
 {
-    QRectF rect;
-    for(auto& item : items)
-        rect = rect.united(item->mapToScene(item->boundingRect()).normalized());
-    return rect;
+    return OdgItem::itemsBoundingRect(items);
 }
 
 QPointF DrawingWidget::itemsCenter(const QList<OdgItem*>& items) const
@@ -2824,11 +3198,14 @@ QPointF DrawingWidget::itemsCenter(const QList<OdgItem*>& items) const
 
 bool DrawingWidget::isItemInRect(OdgItem* item, const QRectF& rect) const
 {
+    mProfileHitTestCandidates++;
     return rect.contains(item->mapToScene(item->boundingRect()).normalized());
 }
 
 bool DrawingWidget::isPointInItem(OdgItem* item, const QPointF& position) const
 {
+    mProfileHitTestCandidates++;
+
     // Check item shape
     if (itemAdjustedShape(item).contains(item->mapFromScene(position))) return true;
 
@@ -2883,6 +3260,15 @@ bool DrawingWidget::shouldConnect(OdgControlPoint* controlPoint, OdgGluePoint* g
     return false;
 }
 
+OdgConnectionGraph& DrawingWidget::connectionGraph()
+{
+    // Rebuilt lazily whenever connections were changed outside of the graph (for example by undo, paste, or load);
+    // otherwise it is kept up to date incrementally by placeItems, unplaceItems, and resizeItem
+    if (!mConnectionGraph.isValid())
+        mConnectionGraph.build(mCurrentPage ? mCurrentPage->items() : QList<OdgItem*>());
+    return mConnectionGraph;
+}
+
 QRectF DrawingWidget::pointRect(OdgControlPoint* point) const
 {
     OdgItem* item = point->item();
@@ -2917,8 +3303,7 @@ void DrawingWidget::updateSelectionCenter()
 void DrawingWidget::updateActions()
 {
     const bool canGroup = (mSelectedItems.size() > 1);
-    const bool canUngroup = (mSelectedItems.size() == 1 &&
-                             dynamic_cast<OdgGroupItem*>(mSelectedItems.first()) != nullptr);
+    const bool canUngroup = (mSelectedItems.size() == 1 && mSelectedItems.first()->type() == OdgItem::GroupType);
     const bool canInsertPoints = (mSelectedItems.size() == 1 && mSelectedItems.first()->canInsertPoints());
     const bool canRemovePoints = (mSelectedItems.size() == 1 && mSelectedItems.first()->canRemovePoints());
 
@@ -2931,6 +3316,68 @@ void DrawingWidget::updateActions()
 
 //======================================================================================================================
 
+void DrawingWidget::pushCommand(DrawingUndoCommand* command)
+{
+    // Pushing a command executes it, so this measures the command's first redo
+    DrawingProfileScope profileScope("DrawingWidget::pushCommand");
+
+    // Any other change made during a drag is recorded after the drag itself
+    finishSelectDrag();
+
+    if (mBatchDepth > 0)
+    {
+        if (!mBatchCommand) mBatchCommand = new DrawingBatchCommand(this);
+        mBatchCommand->addCommand(command);
+    }
+    else mUndoStack.push(command);
+
+    if (mProfilerOverlayVisible) mProfileCommandTime = profileScope.elapsed();
+}
+
+void DrawingWidget::updateItems(const QList<OdgItem*>& items)
+{
+    if (mBatchDepth > 0) markItemsDirty(items);
+    else viewport()->update();
+}
+
+void DrawingWidget::markItemsDirty(const QList<OdgItem*>& items)
+{
+    // Only needed while a batch is open; otherwise the whole viewport is repainted after each change
+    if (mBatchDepth > 0 && !mBatchFullUpdate) mBatchDirtyRect = mBatchDirtyRect.united(itemsRect(items));
+}
+
+void DrawingWidget::notifyCurrentItemsChanged(const QList<OdgItem*>& items)
+{
+    if (mBatchDepth > 0) mBatchItemsChanged = true;
+    else
+    {
+        DrawingProfileScope profileScope("DrawingWidget::currentItemsChanged");
+        emit currentItemsChanged(items);
+    }
+}
+
+void DrawingWidget::notifyCurrentItemsGeometryChanged(const QList<OdgItem*>& items)
+{
+    if (mBatchDepth > 0) mBatchGeometryChanged = true;
+    else
+    {
+        DrawingProfileScope profileScope("DrawingWidget::currentItemsGeometryChanged");
+        emit currentItemsGeometryChanged(items);
+    }
+}
+
+void DrawingWidget::notifyCurrentItemsPropertyChanged(const QList<OdgItem*>& items)
+{
+    if (mBatchDepth > 0) mBatchPropertyChanged = true;
+    else
+    {
+        DrawingProfileScope profileScope("DrawingWidget::currentItemsPropertyChanged");
+        emit currentItemsPropertyChanged(items);
+    }
+}
+
+//======================================================================================================================
+
 void DrawingWidget::mousePanEvent()
 {
     if (mPanCurrentPosition.x() - mPanStartPosition.x() < 0)
@@ -3145,6 +3592,27 @@ void DrawingWidget::setModeFromAction(QAction* action)
     }
 }
 
+void DrawingWidget::populatePathItemsMenu()
+{
+    QMenu* menu = qobject_cast<QMenu*>(sender());
+    if (menu && mPathItemsPalettes.contains(menu))
+    {
+        disconnect(menu, SIGNAL(aboutToShow()), this, SLOT(populatePathItemsMenu()));
+
+        const PathItemsPalette palette = mPathItemsPalettes.take(menu);
+        const QList<OdgPathItem*> items = palette.createItems();
+
+        mPathItems.append(items);
+        for(int i = 0; i < items.size() && i < palette.icons.size(); i++)
+        {
+            QAction* menuAction = new QAction("Place " + items[i]->pathName(), mModeActionGroup);
+            menuAction->setIcon(QIcon(palette.icons[i]));
+            menuAction->setCheckable(true);
+            menu->addAction(menuAction);
+        }
+    }
+}
+
 void DrawingWidget::emitCleanChanged(bool clean)
 {
     emit cleanChanged(clean);
@@ -18,8 +18,9 @@
 #define DRAWINGWIDGET_H
 
 #include <QAbstractScrollArea>
-#include <QUndoStack>
 #include <QTimer>
+#include "DrawingUndo.h"
+#include "OdgConnectionGraph.h"
 #include "OdgDrawing.h"
 #include "OdgMarker.h"
 
@@ -68,7 +69,15 @@ private:
 
     Odg::DrawingMode mMode;
 
-    QUndoStack mUndoStack;
+    DrawingUndoStack mUndoStack;
+
+    int mBatchDepth;
+    DrawingBatchCommand* mBatchCommand;
+    QRectF mBatchDirtyRect;
+    bool mBatchFullUpdate;
+    bool mBatchItemsChanged;
+    bool mBatchGeometryChanged;
+    bool mBatchPropertyChanged;
 
     MouseState mMouseState;
     QPoint mMouseButtonDownPosition;
@@ -95,6 +104,17 @@ private:
     QList<OdgItem*> mPlaceItems;
     bool mPlaceByMousePressAndRelease;
 
+    OdgConnectionGraph mConnectionGraph;
+
+    bool mCullingEnabled;
+
+    bool mProfilerOverlayVisible;
+    qint64 mProfilePaintTime;
+    qint64 mProfileCommandTime;
+    int mProfileItemsDrawn;
+    int mProfileItemsCulled;
+    mutable int mProfileHitTestCandidates;
+
     Qt::CursorShape mPanOriginalCursor;
     QPoint mPanStartPosition;
     QPoint mPanCurrentPosition;
@@ -107,6 +127,13 @@ private:
     QMenu* mSingleGroupItemContextMenu;
     QMenu* mMultipleItemContextMenu;
 
+    // Path item palettes are only created when their menu is first shown
+    struct PathItemsPalette
+    {
+        QList<OdgPathItem*> (*createItems)();
+        QStringList icons;
+    };
+    QHash<QMenu*,PathItemsPalette> mPathItemsPalettes;
     QList<OdgPathItem*> mPathItems;
 
 public:
@@ -120,7 +147,7 @@ private:
                          const QString& iconPath = QString(), const QString& keySequence = QString());
     void addModeAction(const QString& text, const QString& iconPath = QString(),
                        const QString& keySequence = QString());
-    void addPathItems(const QString& name, const QList<OdgPathItem*>& items, const QStringList& icons);
+    void addPathItems(const QString& name, QList<OdgPathItem*> (*createItems)(), const QStringList& icons);
 public:
     void setDrawingTemplate(OdgDrawing* temp);
     void setStyleTemplate(OdgStyle* style);
@@ -161,7 +188,11 @@ public:
     OdgItem* focusItem() const;
     QList<OdgItem*> placeItems() const;
 
+    OdgItem* itemAt(const QPointF& position) const;
+    QList<OdgItem*> items(const QRectF& rect) const;
+
     void paint(QPainter& painter, bool isExport = false);
+    void paintPage(QPainter& painter, OdgPage* page, const QRectF& rect = QRectF());
 
     void createNew();
     bool load(const QString& fileName);
@@ -169,6 +200,20 @@ public:
     void clear();
     bool isClean() const;
 
+    void setUndoMemoryBudget(qint64 bytes);
+    void setUndoSpillEnabled(bool enabled);
+    qint64 undoMemoryBudget() const;
+    bool isUndoSpillEnabled() const;
+
+    bool isBatchActive() const;
+
+    void setCullingEnabled(bool enabled);
+    bool isCullingEnabled() const;
+
+    bool isProfilerOverlayVisible() const;
+
+    OdgMemoryUsage memoryUsage() const override;
+
     void insertPage(int index, OdgPage* page) override;
     void removePage(OdgPage* page) override;
 
@@ -221,6 +266,11 @@ public slots:
     void undo();
     void redo();
 
+    void beginBatch();
+    void commitBatch();
+
+    void setProfilerOverlayVisible(bool visible);
+
     void setDrawingProperty(const QString& name, const QVariant& value);
 
     void insertPage();
@@ -265,6 +315,7 @@ public slots:
     void removePoint();
 
     void setItemsProperty(const QString& name, const QVariant& value);
+    void setItemsProperties(const QHash<QString,QVariant>& properties);
     void setDefaultStyleProperty(const QString& name, const QVariant& value);
 
 signals:
@@ -297,6 +348,7 @@ private:
     void drawItemPoints(QPainter& painter, const QList<OdgItem*>& items);
     void drawHotpoints(QPainter& painter, const QList<OdgItem*>& items);
     void drawRubberBand(QPainter& painter, const QRect& rect);
+    void drawProfilerOverlay(QPainter& painter);
 
     void resizeEvent(QResizeEvent* event) override;
     void updateTransformAndScrollBars(double scale = 0.0);
@@ -305,6 +357,7 @@ private:
     void mouseDoubleClickEvent(QMouseEvent* event) override;
     void mouseMoveEvent(QMouseEvent* event) override;
     void mouseReleaseEvent(QMouseEvent* event) override;
+    void focusOutEvent(QFocusEvent* event) override;
     void wheelEvent(QWheelEvent* event) override;
 
     void selectModeNoButtonMouseMoveEvent(QMouseEvent* event);
@@ -330,6 +383,9 @@ private:
     void selectModeResizeItemEndEvent(QMouseEvent* event);
 	void selectModeResizeItem(const QPointF& mousePosition, bool snapTo45Degrees, bool finalResize);
 
+    bool isSelectDragActive() const;
+    void finishSelectDrag();
+
     void scrollModeNoButtonMouseMoveEvent(QMouseEvent* event);
     void scrollModeLeftMousePressEvent(QMouseEvent* event);
     void scrollModeLeftMouseDragEvent(QMouseEvent* event);
@@ -348,9 +404,6 @@ private:
     QString createMouseInfo(const QPointF& position) const;
     QString createMouseInfo(const QPointF& p1, const QPointF& p2) const;
 
-	OdgItem* itemAt(const QPointF& position) const;
-	QList<OdgItem*> items(const QRectF& rect) const;
-
     QRectF itemsRect(const QList<OdgItem*>& items) const;
     QPointF itemsCenter(const QList<OdgItem*>& items) const;
     bool isItemInRect(OdgItem* item, const QRectF& rect) const;
@@ -358,16 +411,25 @@ private:
     QPainterPath itemAdjustedShape(OdgItem* item) const;
 
     bool shouldConnect(OdgControlPoint* controlPoint, OdgGluePoint* gluePoint) const;
+    OdgConnectionGraph& connectionGraph();
     QRectF pointRect(OdgControlPoint* point) const;
     QRectF pointRect(OdgGluePoint* point) const;
 
 	void updateSelectionCenter();
 	void updateActions();
 
+    void pushCommand(DrawingUndoCommand* command);
+    void updateItems(const QList<OdgItem*>& items);
+    void markItemsDirty(const QList<OdgItem*>& items);
+    void notifyCurrentItemsChanged(const QList<OdgItem*>& items);
+    void notifyCurrentItemsGeometryChanged(const QList<OdgItem*>& items);
+    void notifyCurrentItemsPropertyChanged(const QList<OdgItem*>& items);
+
 private slots:
     void mousePanEvent();
 
     void setModeFromAction(QAction* action);
+    void populatePathItemsMenu();
     void emitCleanChanged(bool clean);
 };
 
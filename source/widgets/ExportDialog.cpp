@@ -15,23 +15,31 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "ExportDialog.h"
+#include "MultiScalePngWriter.h"
 #include <QDialogButtonBox>
+#include <QDir>
 #include <QDoubleValidator>
 #include <QFileDialog>
+#include <QFileInfo>
 #include <QFormLayout>
 #include <QGroupBox>
 #include <QHBoxLayout>
 #include <QIntValidator>
+#include <QLabel>
 #include <QLineEdit>
+#include <QMessageBox>
 #include <QPushButton>
 #include <QRadioButton>
+#include <QRegularExpression>
 #include <QTextEdit>
 #include <QVBoxLayout>
 
 ExportDialog::ExportDialog(QWidget* parent) : QDialog(parent),
-    mPromptOverwrite(true), mPageRect(), mItemsRect(), mUnits(Odg::UnitsInches), mPathEdit(nullptr), mPathButton(nullptr),
-    mPageRectButton(nullptr), mItemsRectButton(nullptr), mScaleEdit(nullptr), mWidthEdit(nullptr), mHeightEdit(nullptr),
-    mOkButton(nullptr), mCancelButton(nullptr)
+    mPromptOverwrite(true), mPageRect(), mItemsRect(), mUnits(Odg::UnitsInches), mPageNames(), mCurrentPageIndex(0),
+    mPathEdit(nullptr), mPathButton(nullptr), mCurrentPageButton(nullptr), mAllPagesButton(nullptr),
+    mPageRangeButton(nullptr), mPageRangeEdit(nullptr), mFileNamePatternEdit(nullptr), mPageRectButton(nullptr),
+    mItemsRectButton(nullptr), mScaleEdit(nullptr), mWidthEdit(nullptr), mHeightEdit(nullptr),
+    mResolutionsEdit(nullptr), mOkButton(nullptr), mCancelButton(nullptr)
 {
     // Create path group
     mPathEdit = new QTextEdit();
@@ -44,6 +52,39 @@ ExportDialog::ExportDialog(QWidget* parent) : QDialog(parent),
     pathLayout->addWidget(mPathButton, 0, Qt::AlignRight | Qt::AlignTop);
     pathGroup->setLayout(pathLayout);
 
+    // Create pages group
+    mCurrentPageButton = new QRadioButton("Current page");
+    mAllPagesButton = new QRadioButton("All pages");
+    mPageRangeButton = new QRadioButton("Pages:");
+    mPageRangeEdit = new QLineEdit();
+    mPageRangeEdit->setPlaceholderText("e.g. 1-3, 5");
+    mFileNamePatternEdit = new QLineEdit("{name}");
+    mFileNamePatternEdit->setToolTip("Name of each exported file when exporting several pages.  {name} is replaced "
+                                     "by the page name and {index} by the page number.");
+    mCurrentPageButton->setChecked(true);
+    connect(mCurrentPageButton, SIGNAL(toggled(bool)), this, SLOT(updatePageControls()));
+    connect(mAllPagesButton, SIGNAL(toggled(bool)), this, SLOT(updatePageControls()));
+    connect(mPageRangeButton, SIGNAL(toggled(bool)), this, SLOT(updatePageControls()));
+
+    QHBoxLayout* pageRangeLayout = new QHBoxLayout();
+    pageRangeLayout->addWidget(mPageRangeButton);
+    pageRangeLayout->addWidget(mPageRangeEdit, 100);
+    pageRangeLayout->setContentsMargins(0, 0, 0, 0);
+
+    QHBoxLayout* fileNamePatternLayout = new QHBoxLayout();
+    fileNamePatternLayout->addWidget(new QLabel("File names:"));
+    fileNamePatternLayout->addWidget(mFileNamePatternEdit, 100);
+    fileNamePatternLayout->setContentsMargins(0, 0, 0, 0);
+
+    QGroupBox* pagesGroup = new QGroupBox("Pages");
+    QVBoxLayout* pagesLayout = new QVBoxLayout();
+    pagesLayout->addWidget(mCurrentPageButton);
+    pagesLayout->addWidget(mAllPagesButton);
+    pagesLayout->addLayout(pageRangeLayout);
+    pagesLayout->addLayout(fileNamePatternLayout);
+    pagesGroup->setLayout(pagesLayout);
+    updatePageControls();
+
     // Create options group
     mPageRectButton = new QRadioButton("Export entire page");
     mItemsRectButton = new QRadioButton("Export page items only");
@@ -71,12 +112,18 @@ ExportDialog::ExportDialog(QWidget* parent) : QDialog(parent),
     connect(mWidthEdit, SIGNAL(editingFinished()), this, SLOT(updateScaleAndHeightFromWidth()));
     connect(mHeightEdit, SIGNAL(editingFinished()), this, SLOT(updateScaleAndWidthFromHeight()));
 
+    mResolutionsEdit = new QLineEdit();
+    mResolutionsEdit->setPlaceholderText("Single image");
+    mResolutionsEdit->setToolTip("Scale factors to export each page at, i.e. \"1, 2, 0.25\".  Each is written to "
+                                 "name@<factor>x.png from a single render of the page.");
+
     int labelWidth = QFontMetrics(font()).boundingRect("Height:").width() + 12;
     QGroupBox* sizeGroup = new QGroupBox("Size");
     QFormLayout* sizeLayout = new QFormLayout();
     sizeLayout->addRow("Scale:", mScaleEdit);
     sizeLayout->addRow("Width:", mWidthEdit);
     sizeLayout->addRow("Height:", mHeightEdit);
+    sizeLayout->addRow("Resolutions:", mResolutionsEdit);
     sizeLayout->setRowWrapPolicy(QFormLayout::DontWrapRows);
     sizeLayout->setLabelAlignment(Qt::AlignLeft | Qt::AlignVCenter);
     sizeLayout->setFieldGrowthPolicy(QFormLayout::AllNonFixedFieldsGrow);
@@ -95,13 +142,14 @@ ExportDialog::ExportDialog(QWidget* parent) : QDialog(parent),
     // Assemble dialog layout
     QVBoxLayout* layout = new QVBoxLayout();
     layout->addWidget(pathGroup);
+    layout->addWidget(pagesGroup);
     layout->addWidget(optionsGroup);
     layout->addWidget(sizeGroup);
     layout->addWidget(buttonBox);
     setLayout(layout);
 
-    setMinimumSize(400, 380);
-    resize(400, 380);
+    setMinimumSize(400, 520);
+    resize(400, 520);
 }
 
 //======================================================================================================================
@@ -147,6 +195,24 @@ void ExportDialog::setExportItemsOnly(bool itemsOnly)
     updateWidthAndHeightFromScale();
 }
 
+void ExportDialog::setPages(const QStringList& pageNames, int currentIndex)
+{
+    mPageNames = pageNames;
+    mCurrentPageIndex = qBound(0, currentIndex, qMax(pageNames.size() - 1, 0));
+    mPageRangeEdit->setText(QString("1-%1").arg(qMax(pageNames.size(), 1)));
+    updatePageControls();
+}
+
+void ExportDialog::setFileNamePattern(const QString& pattern)
+{
+    if (!pattern.isEmpty()) mFileNamePatternEdit->setText(pattern);
+}
+
+void ExportDialog::setResolutions(const QList<double>& factors)
+{
+    mResolutionsEdit->setText(MultiScalePngWriter::formatFactors(factors));
+}
+
 QString ExportDialog::path() const
 {
     return mPathEdit->toPlainText();
@@ -181,13 +247,140 @@ bool ExportDialog::shouldExportItemsOnly() const
     return mItemsRectButton->isChecked();
 }
 
+QString ExportDialog::fileNamePattern() const
+{
+    return mFileNamePatternEdit->text();
+}
+
+QList<double> ExportDialog::resolutions() const
+{
+    if (!mResolutionsEdit->isEnabled()) return QList<double>();
+    return MultiScalePngWriter::parseFactors(mResolutionsEdit->text());
+}
+
+//======================================================================================================================
+
+QList<int> ExportDialog::pageIndices() const
+{
+    QList<int> indices;
+    if (mAllPagesButton->isChecked())
+    {
+        for(int index = 0; index < mPageNames.size(); index++)
+            indices.append(index);
+    }
+    else if (mPageRangeButton->isChecked())
+        indices = pageIndicesFromRange(mPageRangeEdit->text());
+    else
+        indices.append(mCurrentPageIndex);
+    return indices;
+}
+
+QString ExportDialog::pagePath(int pageIndex) const
+{
+    // The current page is exported to the path as given, as is every page of a PDF; otherwise each page is named
+    // using the file name pattern and placed next to the path
+    if (mCurrentPageButton->isChecked() || windowTitle().contains("PDF")) return path();
+
+    // Pages that would share a file name (duplicate page names, or a pattern without placeholders) are told apart by
+    // their page number, so that no two pages are written to the same file
+    QString fileName = pageFileName(pageIndex);
+    const QList<int> indices = pageIndices();
+    for(auto& otherPageIndex : indices)
+    {
+        if (otherPageIndex != pageIndex && pageFileName(otherPageIndex).compare(fileName, Qt::CaseInsensitive) == 0)
+        {
+            fileName += "-" + QString::number(pageIndex + 1);
+            break;
+        }
+    }
+
+    const QFileInfo pathInfo(path());
+    QString suffix = pathInfo.suffix();
+    if (suffix.isEmpty()) suffix = (windowTitle().contains("SVG")) ? "svg" : "png";
+
+    return pathInfo.dir().absoluteFilePath(fileName + "." + suffix);
+}
+
 //======================================================================================================================
 
 void ExportDialog::accept()
 {
     bool scaleOk = false;
     const double scale = mScaleEdit->text().toDouble(&scaleOk);
-    if (scaleOk && scale > 0 && !path().isEmpty()) QDialog::accept();
+    bool resolutionsOk = true;
+    if (mResolutionsEdit->isEnabled()) MultiScalePngWriter::parseFactors(mResolutionsEdit->text(), &resolutionsOk);
+
+    // Page numbers appended by pagePath() could still collide with another page's name (e.g. "Page" and "Page-2")
+    bool pathsUnique = true;
+    if (!windowTitle().contains("PDF"))
+    {
+        QStringList paths;
+        const QList<int> indices = pageIndices();
+        for(auto& pageIndex : indices)
+            paths.append(pagePath(pageIndex).toLower());
+        pathsUnique = (paths.removeDuplicates() == 0);
+        if (!pathsUnique)
+        {
+            QMessageBox::warning(this, windowTitle(), "Some of the selected pages would be exported to the same file."
+                                 "\nInclude {index} in the file name pattern to give each page its own file.");
+        }
+    }
+
+    if (scaleOk && scale > 0 && !path().isEmpty() && !pageIndices().isEmpty() &&
+        (!mFileNamePatternEdit->isEnabled() || !fileNamePattern().trimmed().isEmpty()) && resolutionsOk && pathsUnique)
+    {
+        QDialog::accept();
+    }
+}
+
+//======================================================================================================================
+
+QList<int> ExportDialog::pageIndicesFromRange(const QString& range) const
+{
+    // Accepts comma-separated page numbers and ranges such as "1-3, 5, 8-"; pages are numbered from 1
+    QList<int> indices;
+    const QStringList parts = range.split(',', Qt::SkipEmptyParts);
+    for(auto& part : parts)
+    {
+        const QStringList bounds = part.split('-');
+        if (bounds.size() > 2) return QList<int>();
+
+        bool firstOk = false, lastOk = false;
+        const int first = bounds.first().trimmed().toInt(&firstOk);
+        int last = first;
+        lastOk = firstOk;
+        if (bounds.size() == 2)
+        {
+            const QString lastText = bounds.last().trimmed();
+            if (lastText.isEmpty())
+            {
+                last = mPageNames.size();
+                lastOk = true;
+            }
+            else last = lastText.toInt(&lastOk);
+        }
+        if (!firstOk || !lastOk || first < 1 || last < first || last > mPageNames.size()) return QList<int>();
+
+        for(int page = first; page <= last; page++)
+        {
+            if (!indices.contains(page - 1)) indices.append(page - 1);
+        }
+    }
+    return indices;
+}
+
+QString ExportDialog::pageFileName(int pageIndex) const
+{
+    static const QRegularExpression invalidCharacters(R"([\\/:*?"<>|])");
+    QString pageName = mPageNames.value(pageIndex);
+    pageName.replace(invalidCharacters, "_");
+    if (pageName.trimmed().isEmpty()) pageName = QString::number(pageIndex + 1);
+
+    QString fileName = fileNamePattern();
+    fileName.replace("{name}", pageName);
+    fileName.replace("{index}", QString::number(pageIndex + 1));
+    fileName.replace(invalidCharacters, "_");
+    return fileName;
 }
 
 //======================================================================================================================
@@ -196,7 +389,9 @@ void ExportDialog::browseForPath()
 {
     QString fileFilter;
     if (windowTitle().contains("SVG"))
-        fileFilter = "Scalable Vector Graphics (*.svg);;All Files (*)";
+        fileFilter = "Scalable Vector Graphics (*.svg);;Compressed SVG (*.svgz);;All Files (*)";
+    else if (windowTitle().contains("PDF"))
+        fileFilter = "Portable Document Format (*.pdf);;All Files (*)";
     else
         fileFilter = "Portable Network Graphics (*.png);;All Files (*)";
 
@@ -206,6 +401,13 @@ void ExportDialog::browseForPath()
     if (!selectedPath.isEmpty()) setPath(selectedPath);
 }
 
+void ExportDialog::updatePageControls()
+{
+    mPageRangeEdit->setEnabled(mPageRangeButton->isChecked());
+    mFileNamePatternEdit->setEnabled(!mCurrentPageButton->isChecked() && !windowTitle().contains("PDF"));
+    mResolutionsEdit->setEnabled(windowTitle().contains("PNG"));
+}
+
 void ExportDialog::updateWidthAndHeightFromScale()
 {
     bool scaleOk = false;
@@ -18,6 +18,7 @@
 #define EXPORTDIALOG_H
 
 #include <QDialog>
+#include <QStringList>
 #include "OdgGlobal.h"
 
 class QLineEdit;
@@ -33,16 +34,25 @@ private:
     QRectF mPageRect;
     QRectF mItemsRect;
     Odg::Units mUnits;
+    QStringList mPageNames;
+    int mCurrentPageIndex;
 
     QTextEdit* mPathEdit;
     QPushButton* mPathButton;
 
+    QRadioButton* mCurrentPageButton;
+    QRadioButton* mAllPagesButton;
+    QRadioButton* mPageRangeButton;
+    QLineEdit* mPageRangeEdit;
+    QLineEdit* mFileNamePatternEdit;
+
     QRadioButton* mPageRectButton;
     QRadioButton* mItemsRectButton;
 
     QLineEdit* mScaleEdit;
     QLineEdit* mWidthEdit;
     QLineEdit* mHeightEdit;
+    QLineEdit* mResolutionsEdit;
 
     QPushButton* mOkButton;
     QPushButton* mCancelButton;
@@ -57,6 +67,9 @@ public:
     void setUnits(Odg::Units units);
     void setPixelsPerInch(double pixelsPerInch);
     void setExportItemsOnly(bool itemsOnly);
+    void setPages(const QStringList& pageNames, int currentIndex);
+    void setFileNamePattern(const QString& pattern);
+    void setResolutions(const QList<double>& factors);
     QString path() const;
     bool shouldPromptOverwrite() const;
     QRectF pageRect() const;
@@ -64,12 +77,22 @@ public:
     Odg::Units units() const;
     double pixelsPerInch() const;
     bool shouldExportItemsOnly() const;
+    QString fileNamePattern() const;
+    QList<double> resolutions() const;
+
+    QList<int> pageIndices() const;
+    QString pagePath(int pageIndex) const;
 
 public slots:
     void accept() override;
 
+private:
+    QList<int> pageIndicesFromRange(const QString& range) const;
+    QString pageFileName(int pageIndex) const;
+
 private slots:
     void browseForPath();
+    void updatePageControls();
     void updateWidthAndHeightFromScale();
     void updateScaleAndHeightFromWidth();
     void updateScaleAndWidthFromHeight();
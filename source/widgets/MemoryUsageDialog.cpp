@@ -0,0 +1,80 @@
+// File: MemoryUsageDialog.cpp
+// Copyright (C) 2023  Jason Allen
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "MemoryUsageDialog.h"
+#include "DrawingWidget.h"
+#include <QDialogButtonBox>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPushButton>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+MemoryUsageDialog::MemoryUsageDialog(DrawingWidget* drawingWidget, QWidget* parent) : QDialog(parent),
+    mDrawingWidget(drawingWidget), mTreeWidget(nullptr), mTotalLabel(nullptr)
+{
+    mTreeWidget = new QTreeWidget();
+    mTreeWidget->setHeaderLabels(QStringList() << "Category" << "Count" << "Size");
+    mTreeWidget->setRootIsDecorated(false);
+    mTreeWidget->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+
+    mTotalLabel = new QLabel();
+
+    QDialogButtonBox* buttonBox = new QDialogButtonBox(Qt::Horizontal);
+    buttonBox->setCenterButtons(true);
+    QPushButton* refreshButton = buttonBox->addButton("Refresh", QDialogButtonBox::ActionRole);
+    QPushButton* okButton = buttonBox->addButton(QDialogButtonBox::Ok);
+    connect(refreshButton, SIGNAL(clicked()), this, SLOT(refresh()));
+    connect(okButton, SIGNAL(clicked()), this, SLOT(accept()));
+
+    QVBoxLayout* vLayout = new QVBoxLayout();
+    vLayout->addWidget(mTreeWidget, 100);
+    vLayout->addWidget(mTotalLabel);
+    vLayout->addWidget(buttonBox);
+    vLayout->setSpacing(8);
+    setLayout(vLayout);
+
+    setWindowTitle("Memory Usage");
+    resize(400, 360);
+
+    refresh();
+}
+
+//======================================================================================================================
+
+void MemoryUsageDialog::refresh()
+{
+    mTreeWidget->clear();
+    if (!mDrawingWidget) return;
+
+    const OdgMemoryUsage usage = mDrawingWidget->memoryUsage();
+    const QList<OdgMemoryUsage::Category> categories = usage.categories();
+    for(auto& category : categories)
+    {
+        QTreeWidgetItem* treeItem = new QTreeWidgetItem();
+        treeItem->setText(0, category.name);
+        treeItem->setData(1, Qt::DisplayRole, category.count);
+        treeItem->setText(2, OdgMemoryUsage::formatBytes(category.bytes));
+        treeItem->setTextAlignment(1, Qt::AlignRight | Qt::AlignVCenter);
+        treeItem->setTextAlignment(2, Qt::AlignRight | Qt::AlignVCenter);
+        mTreeWidget->addTopLevelItem(treeItem);
+    }
+
+    mTreeWidget->resizeColumnToContents(1);
+    mTreeWidget->resizeColumnToContents(2);
+
+    mTotalLabel->setText("Estimated total: " + OdgMemoryUsage::formatBytes(usage.totalBytes()));
+}
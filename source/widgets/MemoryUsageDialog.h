@@ -0,0 +1,43 @@
+// File: MemoryUsageDialog.h
+// Copyright (C) 2023  Jason Allen
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef MEMORYUSAGEDIALOG_H
+#define MEMORYUSAGEDIALOG_H
+
+#include <QDialog>
+
+class QLabel;
+class QTreeWidget;
+class DrawingWidget;
+
+class MemoryUsageDialog : public QDialog
+{
+    Q_OBJECT
+
+private:
+    DrawingWidget* mDrawingWidget;
+
+    QTreeWidget* mTreeWidget;
+    QLabel* mTotalLabel;
+
+public:
+    MemoryUsageDialog(DrawingWidget* drawingWidget, QWidget* parent = nullptr);
+
+public slots:
+    void refresh();
+};
+
+#endif
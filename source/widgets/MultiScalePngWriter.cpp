@@ -0,0 +1,133 @@
+// File: MultiScalePngWriter.cpp
+// Copyright (C) 2023  Jason Allen
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "MultiScalePngWriter.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QThread>
+#include <QThreadPool>
+#include <QVector>
+
+MultiScalePngWriter::MultiScalePngWriter(const QRectF& rect) : mRect(rect), mOutputs(), mThreadCount(0)
+{
+    // Nothing more to do here.
+}
+
+//======================================================================================================================
+
+void MultiScalePngWriter::addOutput(double scale, const QString& path)
+{
+    if (scale > 0) mOutputs.append({ scale, path });
+}
+
+void MultiScalePngWriter::clearOutputs()
+{
+    mOutputs.clear();
+}
+
+int MultiScalePngWriter::outputCount() const
+{
+    return mOutputs.size();
+}
+
+//======================================================================================================================
+
+void MultiScalePngWriter::setThreadCount(int count)
+{
+    mThreadCount = qMax(count, 0);
+}
+
+int MultiScalePngWriter::threadCount() const
+{
+    return mThreadCount;
+}
+
+//======================================================================================================================
+
+bool MultiScalePngWriter::write(const PngWriter::PaintFunction& paint)
+{
+    if (mOutputs.isEmpty()) return false;
+
+    // Outputs are written concurrently and share the threads between them for their bands.  Each band paints only
+    // the items that intersect it, so no output replays the whole page for every band.
+    const int threadCount = (mThreadCount > 0) ? mThreadCount : qMax(QThread::idealThreadCount(), 1);
+    const int outputThreadCount = qMax(threadCount / mOutputs.size(), 1);
+    QVector<bool> results(mOutputs.size(), false);
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(qMin(threadCount, mOutputs.size()));
+    for(int outputIndex = 0; outputIndex < mOutputs.size(); outputIndex++)
+    {
+        pool.start([this, &paint, &results, outputThreadCount, outputIndex]()
+        {
+            const Output& output = mOutputs.at(outputIndex);
+
+            PngWriter pngWriter(mRect, output.scale);
+            pngWriter.setThreadCount(outputThreadCount);
+            results[outputIndex] = pngWriter.write(output.path, paint);
+        });
+    }
+    pool.waitForDone();
+
+    return !results.contains(false);
+}
+
+//======================================================================================================================
+
+QString MultiScalePngWriter::scaledPath(const QString& path, double factor)
+{
+    // name.png -> name@2x.png
+    const QFileInfo pathInfo(path);
+    const QString suffix = pathInfo.suffix().isEmpty() ? "png" : pathInfo.suffix();
+    return pathInfo.dir().filePath(pathInfo.completeBaseName() + "@" + QString::number(factor, 'g', 6) + "x." +
+                                   suffix);
+}
+
+QList<double> MultiScalePngWriter::parseFactors(const QString& text, bool* ok)
+{
+    // Accepts factors separated by commas or spaces, each optionally followed by an 'x' (i.e. "1x, 2x, 0.25x")
+    static const QRegularExpression separators("[,\\s]+");
+
+    QList<double> factors;
+    bool factorsOk = true;
+
+    const QStringList factorStrs = text.split(separators, Qt::SkipEmptyParts);
+    for(auto& factorStr : factorStrs)
+    {
+        QString numberStr = factorStr.trimmed();
+        if (numberStr.endsWith('x', Qt::CaseInsensitive)) numberStr.chop(1);
+
+        bool factorOk = false;
+        const double factor = numberStr.toDouble(&factorOk);
+        if (factorOk && factor > 0)
+        {
+            if (!factors.contains(factor)) factors.append(factor);
+        }
+        else factorsOk = false;
+    }
+
+    if (ok) *ok = factorsOk;
+    return (factorsOk) ? factors : QList<double>();
+}
+
+QString MultiScalePngWriter::formatFactors(const QList<double>& factors)
+{
+    QStringList factorStrs;
+    for(auto& factor : factors)
+        factorStrs.append(QString::number(factor, 'g', 6));
+    return factorStrs.join(", ");
+}
@@ -0,0 +1,58 @@
+// File: MultiScalePngWriter.h
+// Copyright (C) 2023  Jason Allen
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef MULTISCALEPNGWRITER_H
+#define MULTISCALEPNGWRITER_H
+
+#include <QList>
+#include <QRectF>
+#include <QString>
+#include "PngWriter.h"
+
+// Writes a region of a drawing to several PNG files at different scales (i.e. name@1x.png, name@2x.png and a
+// thumbnail for responsive web pages) in one pass.  The scales are rasterized concurrently, each through its own
+// PngWriter that paints the drawing band by band and shares the thread budget with the others.
+class MultiScalePngWriter
+{
+private:
+    struct Output
+    {
+        double scale;
+        QString path;
+    };
+
+    QRectF mRect;
+    QList<Output> mOutputs;
+    int mThreadCount;
+
+public:
+    MultiScalePngWriter(const QRectF& rect);
+
+    void addOutput(double scale, const QString& path);
+    void clearOutputs();
+    int outputCount() const;
+
+    void setThreadCount(int count);
+    int threadCount() const;
+
+    bool write(const PngWriter::PaintFunction& paint);
+
+    static QString scaledPath(const QString& path, double factor);
+    static QList<double> parseFactors(const QString& text, bool* ok = nullptr);
+    static QString formatFactors(const QList<double>& factors);
+};
+
+#endif
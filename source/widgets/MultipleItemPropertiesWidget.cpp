@@ -124,7 +124,7 @@ QGroupBox* MultipleItemPropertiesWidget::createMarkerGroup(int labelWidth)
     connect(mStartMarkerStyleCombo, SIGNAL(activated(int)), this, SLOT(handleStartMarkerStyleChange(int)));
 
     mStartMarkerSizeCheck = new QCheckBox("Start Marker Size:");
-    connect(mStartMarkerStyleCheck, SIGNAL(clicked(bool)), this, SLOT(handleStartMarkerSizeCheckClicked(bool)));
+    connect(mStartMarkerSizeCheck, SIGNAL(clicked(bool)), this, SLOT(handleStartMarkerSizeCheckClicked(bool)));
     mStartMarkerSizeEdit = new LengthEdit();
     connect(mStartMarkerSizeEdit, SIGNAL(lengthChanged(double)), this, SLOT(handleStartMarkerSizeChange(double)));
 
@@ -137,7 +137,7 @@ QGroupBox* MultipleItemPropertiesWidget::createMarkerGroup(int labelWidth)
     connect(mEndMarkerStyleCombo, SIGNAL(activated(int)), this, SLOT(handleEndMarkerStyleChange(int)));
 
     mEndMarkerSizeCheck = new QCheckBox("End Marker Size:");
-    connect(mEndMarkerStyleCheck, SIGNAL(clicked(bool)), this, SLOT(handleEndMarkerSizeCheckClicked(bool)));
+    connect(mEndMarkerSizeCheck, SIGNAL(clicked(bool)), this, SLOT(handleEndMarkerSizeCheckClicked(bool)));
     mEndMarkerSizeEdit = new LengthEdit();
     connect(mEndMarkerSizeEdit, SIGNAL(lengthChanged(double)), this, SLOT(handleEndMarkerSizeChange(double)));
 
@@ -677,25 +677,25 @@ void MultipleItemPropertiesWidget::handleCornerRadiusChange(double length)
 void MultipleItemPropertiesWidget::handlePenStyleCheckClicked(bool checked)
 {
     mPenStyleCombo->setEnabled(checked);
-    if (checked) handlePenStyleChange(mPenStyleCombo->currentIndex());
+    if (checked) emit itemsPropertiesChanged(penBrushProperties());
 }
 
 void MultipleItemPropertiesWidget::handlePenWidthCheckClicked(bool checked)
 {
     mPenWidthEdit->setEnabled(checked);
-    if (checked) handlePenWidthChange(mPenWidthEdit->length());
+    if (checked) emit itemsPropertiesChanged(penBrushProperties());
 }
 
 void MultipleItemPropertiesWidget::handlePenColorCheckClicked(bool checked)
 {
     mPenColorWidget->setEnabled(checked);
-    if (checked) handlePenColorChange(mPenColorWidget->color());
+    if (checked) emit itemsPropertiesChanged(penBrushProperties());
 }
 
 void MultipleItemPropertiesWidget::handleBrushColorCheckClicked(bool checked)
 {
     mBrushColorWidget->setEnabled(checked);
-    if (checked) handleBrushColorChange(mBrushColorWidget->color());
+    if (checked) emit itemsPropertiesChanged(penBrushProperties());
 }
 
 void MultipleItemPropertiesWidget::handlePenStyleChange(int index)
@@ -723,25 +723,25 @@ void MultipleItemPropertiesWidget::handleBrushColorChange(const QColor& color)
 void MultipleItemPropertiesWidget::handleStartMarkerStyleCheckClicked(bool checked)
 {
     mStartMarkerStyleCombo->setEnabled(checked);
-    if (checked) handleStartMarkerStyleChange(mStartMarkerStyleCombo->currentIndex());
+    if (checked) emit itemsPropertiesChanged(markerProperties());
 }
 
 void MultipleItemPropertiesWidget::handleStartMarkerSizeCheckClicked(bool checked)
 {
     mStartMarkerSizeEdit->setEnabled(checked);
-    if (checked) handleStartMarkerSizeChange(mStartMarkerSizeEdit->length());
+    if (checked) emit itemsPropertiesChanged(markerProperties());
 }
 
 void MultipleItemPropertiesWidget::handleEndMarkerStyleCheckClicked(bool checked)
 {
     mEndMarkerStyleCombo->setEnabled(checked);
-    if (checked) handleEndMarkerStyleChange(mEndMarkerStyleCombo->currentIndex());
+    if (checked) emit itemsPropertiesChanged(markerProperties());
 }
 
 void MultipleItemPropertiesWidget::handleEndMarkerSizeCheckClicked(bool checked)
 {
     mEndMarkerSizeEdit->setEnabled(checked);
-    if (checked) handleEndMarkerSizeChange(mEndMarkerSizeEdit->length());
+    if (checked) emit itemsPropertiesChanged(markerProperties());
 }
 
 void MultipleItemPropertiesWidget::handleStartMarkerStyleChange(int index)
@@ -769,37 +769,37 @@ void MultipleItemPropertiesWidget::handleEndMarkerSizeChange(double length)
 void MultipleItemPropertiesWidget::handleFontFamilyCheckClicked(bool checked)
 {
     mFontFamilyCombo->setEnabled(checked);
-    if (checked) handleFontFamilyChange(mFontFamilyCombo->currentIndex());
+    if (checked) emit itemsPropertiesChanged(textProperties());
 }
 
 void MultipleItemPropertiesWidget::handleFontSizeCheckClicked(bool checked)
 {
     mFontSizeEdit->setEnabled(checked);
-    if (checked) handleFontSizeChange(mFontSizeEdit->length());
+    if (checked) emit itemsPropertiesChanged(textProperties());
 }
 
 void MultipleItemPropertiesWidget::handleFontStyleCheckClicked(bool checked)
 {
     mFontStyleWidget->setEnabled(checked);
-    if (checked) handleFontStyleChange();
+    if (checked) emit itemsPropertiesChanged(textProperties());
 }
 
 void MultipleItemPropertiesWidget::handleTextAlignmentCheckClicked(bool checked)
 {
     mTextAlignmentWidget->setEnabled(checked);
-    if (checked) handleTextAlignmentChange();
+    if (checked) emit itemsPropertiesChanged(textProperties());
 }
 
 void MultipleItemPropertiesWidget::handleTextPaddingCheckClicked(bool checked)
 {
     mTextPaddingWidget->setEnabled(checked);
-    if (checked) handleTextPaddingChange(mTextPaddingWidget->size());
+    if (checked) emit itemsPropertiesChanged(textProperties());
 }
 
 void MultipleItemPropertiesWidget::handleTextColorCheckClicked(bool checked)
 {
     mTextColorWidget->setEnabled(checked);
-    if (checked) handleTextColorChange(mTextColorWidget->color());
+    if (checked) emit itemsPropertiesChanged(textProperties());
 }
 
 void MultipleItemPropertiesWidget::handleFontFamilyChange(int index)
@@ -813,16 +813,85 @@ void MultipleItemPropertiesWidget::handleFontSizeChange(double length)
 }
 
 void MultipleItemPropertiesWidget::handleFontStyleChange()
+{
+    emit itemsPropertyChanged("fontStyle", fontStyleValue());
+}
+
+void MultipleItemPropertiesWidget::handleTextAlignmentChange()
+{
+    emit itemsPropertyChanged("textAlignment", textAlignmentValue());
+}
+
+void MultipleItemPropertiesWidget::handleTextPaddingChange(const QSizeF& size)
+{
+    emit itemsPropertyChanged("textPadding", size);
+}
+
+void MultipleItemPropertiesWidget::handleTextColorChange(const QColor& color)
+{
+    emit itemsPropertyChanged("textColor", color);
+}
+
+//======================================================================================================================
+
+QHash<QString,QVariant> MultipleItemPropertiesWidget::penBrushProperties() const
+{
+    // Checking one of the group's boxes re-applies all of its checked values as a single edit
+    QHash<QString,QVariant> properties;
+    if (mPenStyleCheck->isChecked() && mPenBrushLayout->isRowVisible(mPenStyleCombo))
+        properties.insert("penStyle", mPenStyleCombo->currentIndex());
+    if (mPenWidthCheck->isChecked() && mPenBrushLayout->isRowVisible(mPenWidthEdit))
+        properties.insert("penWidth", mPenWidthEdit->length());
+    if (mPenColorCheck->isChecked() && mPenBrushLayout->isRowVisible(mPenColorWidget))
+        properties.insert("penColor", mPenColorWidget->color());
+    if (mBrushColorCheck->isChecked() && mPenBrushLayout->isRowVisible(mBrushColorWidget))
+        properties.insert("brushColor", mBrushColorWidget->color());
+    return properties;
+}
+
+QHash<QString,QVariant> MultipleItemPropertiesWidget::markerProperties() const
+{
+    QHash<QString,QVariant> properties;
+    if (mStartMarkerStyleCheck->isChecked() && mMarkerLayout->isRowVisible(mStartMarkerStyleCombo))
+        properties.insert("startMarkerStyle", mStartMarkerStyleCombo->currentIndex());
+    if (mStartMarkerSizeCheck->isChecked() && mMarkerLayout->isRowVisible(mStartMarkerSizeEdit))
+        properties.insert("startMarkerSize", mStartMarkerSizeEdit->length());
+    if (mEndMarkerStyleCheck->isChecked() && mMarkerLayout->isRowVisible(mEndMarkerStyleCombo))
+        properties.insert("endMarkerStyle", mEndMarkerStyleCombo->currentIndex());
+    if (mEndMarkerSizeCheck->isChecked() && mMarkerLayout->isRowVisible(mEndMarkerSizeEdit))
+        properties.insert("endMarkerSize", mEndMarkerSizeEdit->length());
+    return properties;
+}
+
+QHash<QString,QVariant> MultipleItemPropertiesWidget::textProperties() const
+{
+    QHash<QString,QVariant> properties;
+    if (mFontFamilyCheck->isChecked() && mTextLayout->isRowVisible(mFontFamilyCombo))
+        properties.insert("fontFamily", mFontFamilyCombo->currentFont().family());
+    if (mFontSizeCheck->isChecked() && mTextLayout->isRowVisible(mFontSizeEdit))
+        properties.insert("fontSize", mFontSizeEdit->length());
+    if (mFontStyleCheck->isChecked() && mTextLayout->isRowVisible(mFontStyleWidget))
+        properties.insert("fontStyle", fontStyleValue());
+    if (mTextAlignmentCheck->isChecked() && mTextLayout->isRowVisible(mTextAlignmentWidget))
+        properties.insert("textAlignment", textAlignmentValue());
+    if (mTextPaddingCheck->isChecked() && mTextLayout->isRowVisible(mTextPaddingWidget))
+        properties.insert("textPadding", mTextPaddingWidget->size());
+    if (mTextColorCheck->isChecked() && mTextLayout->isRowVisible(mTextColorWidget))
+        properties.insert("textColor", mTextColorWidget->color());
+    return properties;
+}
+
+QVariant MultipleItemPropertiesWidget::fontStyleValue() const
 {
     OdgFontStyle fontStyle;
     fontStyle.setBold(mFontBoldButton->isChecked());
     fontStyle.setItalic(mFontItalicButton->isChecked());
     fontStyle.setUnderline(mFontUnderlineButton->isChecked());
     fontStyle.setStrikeOut(mFontStrikeOutButton->isChecked());
-    emit itemsPropertyChanged("fontStyle", QVariant::fromValue<OdgFontStyle>(fontStyle));
+    return QVariant::fromValue<OdgFontStyle>(fontStyle);
 }
 
-void MultipleItemPropertiesWidget::handleTextAlignmentChange()
+QVariant MultipleItemPropertiesWidget::textAlignmentValue() const
 {
     Qt::Alignment horizontal = Qt::AlignLeft;
     if (mTextAlignmentHCenterButton->isChecked())
@@ -836,15 +905,5 @@ void MultipleItemPropertiesWidget::handleTextAlignmentChange()
     else if (mTextAlignmentBottomButton->isChecked())
         vertical = Qt::AlignBottom;
 
-    emit itemsPropertyChanged("textAlignment", static_cast<int>(horizontal | vertical));
-}
-
-void MultipleItemPropertiesWidget::handleTextPaddingChange(const QSizeF& size)
-{
-    emit itemsPropertyChanged("textPadding", size);
-}
-
-void MultipleItemPropertiesWidget::handleTextColorChange(const QColor& color)
-{
-    emit itemsPropertyChanged("textColor", color);
+    return static_cast<int>(horizontal | vertical);
 }
@@ -17,6 +17,7 @@
 #ifndef MULTIPLEITEMPROPERTIESWIDGET_H
 #define MULTIPLEITEMPROPERTIESWIDGET_H
 
+#include <QHash>
 #include <QWidget>
 #include "HelperWidgets.h"
 #include "OdgGlobal.h"
@@ -111,6 +112,7 @@ public slots:
 signals:
     void itemsMovedDelta(const QPointF& delta);
     void itemsPropertyChanged(const QString& name, const QVariant& value);
+    void itemsPropertiesChanged(const QHash<QString,QVariant>& properties);
 
 private:
     void updateRectGroup();
@@ -123,6 +125,12 @@ private:
     QString checkStringProperty(const QString& name, bool& anyItemHasProperty, bool& propertyValuesMatch) const;
     template<class T> T checkProperty(const QString& name, bool& anyItemHasProperty, bool& propertyValuesMatch) const;
 
+    QHash<QString,QVariant> penBrushProperties() const;
+    QHash<QString,QVariant> markerProperties() const;
+    QHash<QString,QVariant> textProperties() const;
+    QVariant fontStyleValue() const;
+    QVariant textAlignmentValue() const;
+
 private slots:
     void handleCornerRadiusCheckClicked(bool checked);
     void handleCornerRadiusChange(double length);
@@ -0,0 +1,130 @@
+// File: PdfWriter.cpp
+// Copyright (C) 2023  Jason Allen
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "PdfWriter.h"
+#include "OdgItem.h"
+#include <QPageSize>
+#include <QPainter>
+#include <QPdfWriter>
+
+PdfWriter::PdfWriter(Odg::Units units) : mUnits(units), mResolution(1200), mTitle(), mCreator(), mPages()
+{
+    // Nothing more to do here.
+}
+
+//======================================================================================================================
+
+void PdfWriter::setResolution(int dpi)
+{
+    if (dpi > 0) mResolution = dpi;
+}
+
+void PdfWriter::setTitle(const QString& title)
+{
+    mTitle = title;
+}
+
+void PdfWriter::setCreator(const QString& creator)
+{
+    mCreator = creator;
+}
+
+int PdfWriter::resolution() const
+{
+    return mResolution;
+}
+
+QString PdfWriter::title() const
+{
+    return mTitle;
+}
+
+QString PdfWriter::creator() const
+{
+    return mCreator;
+}
+
+//======================================================================================================================
+
+void PdfWriter::addPage(const QRectF& rect, const QList<OdgItem*>& items)
+{
+    if (rect.width() > 0 && rect.height() > 0)
+    {
+        Page page = { rect, items };
+        mPages.append(page);
+    }
+}
+
+int PdfWriter::pageCount() const
+{
+    return mPages.size();
+}
+
+//======================================================================================================================
+
+bool PdfWriter::write(const QString& path, const QColor& backgroundColor)
+{
+    if (mPages.isEmpty()) return false;
+
+    // All pages go into a single document, so fonts are embedded once and shared by every page that uses them.
+    // Items are painted in their own coordinates, so repeated symbols produce identical path operators in the content
+    // streams, which compress well.
+    QPdfWriter pdfWriter(path);
+    pdfWriter.setResolution(mResolution);
+    pdfWriter.setTitle(mTitle);
+    pdfWriter.setCreator(mCreator);
+    pdfWriter.setPageMargins(QMarginsF(0, 0, 0, 0));
+
+    const QPageSize::Unit pageSizeUnits = (mUnits == Odg::UnitsInches) ? QPageSize::Inch : QPageSize::Millimeter;
+    pdfWriter.setPageSize(QPageSize(mPages.first().rect.size(), pageSizeUnits, QString(), QPageSize::ExactMatch));
+
+    QPainter painter;
+    if (!painter.begin(&pdfWriter)) return false;
+
+    for(int pageIndex = 0; pageIndex < mPages.size(); pageIndex++)
+    {
+        const Page& page = mPages.at(pageIndex);
+        if (pageIndex > 0)
+        {
+            // Each page takes the size of its own export rect
+            pdfWriter.setPageSize(QPageSize(page.rect.size(), pageSizeUnits, QString(), QPageSize::ExactMatch));
+            if (!pdfWriter.newPage()) return false;
+        }
+
+        writePage(painter, page, backgroundColor);
+    }
+
+    return painter.end();
+}
+
+//======================================================================================================================
+
+void PdfWriter::writePage(QPainter& painter, const Page& page, const QColor& backgroundColor)
+{
+    const double scale = (mUnits == Odg::UnitsInches) ? mResolution : mResolution / 25.4;
+
+    painter.resetTransform();
+    painter.scale(scale, scale);
+    painter.translate(-page.rect.left(), -page.rect.top());
+
+    // Background matches SvgWriter: the export rect filled with the background color
+    painter.setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing, false);
+    painter.setBrush(QBrush(backgroundColor));
+    painter.setPen(QPen(Qt::NoPen));
+    painter.drawRect(page.rect);
+
+    OdgItem::paintItems(painter, page.items);
+}
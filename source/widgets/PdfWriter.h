@@ -0,0 +1,66 @@
+// File: PdfWriter.h
+// Copyright (C) 2023  Jason Allen
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef PDFWRITER_H
+#define PDFWRITER_H
+
+#include <QColor>
+#include <QList>
+#include <QRectF>
+#include <QString>
+#include "OdgGlobal.h"
+
+class QPainter;
+class OdgItem;
+
+// Writes one or more regions of a drawing to a multi-page vector PDF, one PDF page per region, by painting the items
+// with OdgItem::paint onto a QPdfWriter.
+class PdfWriter
+{
+private:
+    struct Page
+    {
+        QRectF rect;
+        QList<OdgItem*> items;
+    };
+
+    Odg::Units mUnits;
+    int mResolution;
+    QString mTitle;
+    QString mCreator;
+
+    QList<Page> mPages;
+
+public:
+    PdfWriter(Odg::Units units);
+
+    void setResolution(int dpi);
+    void setTitle(const QString& title);
+    void setCreator(const QString& creator);
+    int resolution() const;
+    QString title() const;
+    QString creator() const;
+
+    void addPage(const QRectF& rect, const QList<OdgItem*>& items);
+    int pageCount() const;
+
+    bool write(const QString& path, const QColor& backgroundColor);
+
+private:
+    void writePage(QPainter& painter, const Page& page, const QColor& backgroundColor);
+};
+
+#endif
@@ -0,0 +1,283 @@
+// File: PngWriter.cpp
+// Copyright (C) 2023  Jason Allen
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "PngWriter.h"
+#include <QFile>
+#include <QMutex>
+#include <QPainter>
+#include <QThread>
+#include <QThreadPool>
+#include <QVector>
+#include <QWaitCondition>
+#include <QtEndian>
+#include <limits>
+#include <zlib.h>
+
+// Tiles are kept well inside the sizes the raster paint engine handles exactly
+static const int sMaximumTileWidth = 8192;
+static const qint64 sTargetBandPixels = 4 * 1024 * 1024;
+static const int sOutputBufferSize = 256 * 1024;
+
+PngWriter::PngWriter(const QRectF& rect, double scale) : mRect(rect), mScale(scale), mBandHeight(0),
+    mThreadCount(0), mCompressionLevel(6)
+{
+    // Nothing more to do here.
+}
+
+//======================================================================================================================
+
+void PngWriter::setBandHeight(int height)
+{
+    mBandHeight = qMax(height, 0);
+}
+
+void PngWriter::setThreadCount(int count)
+{
+    mThreadCount = qMax(count, 0);
+}
+
+void PngWriter::setCompressionLevel(int level)
+{
+    mCompressionLevel = qBound(0, level, 9);
+}
+
+int PngWriter::bandHeight() const
+{
+    return mBandHeight;
+}
+
+int PngWriter::threadCount() const
+{
+    return mThreadCount;
+}
+
+int PngWriter::compressionLevel() const
+{
+    return mCompressionLevel;
+}
+
+//======================================================================================================================
+
+QSize PngWriter::imageSize() const
+{
+    if (mRect.width() <= 0 || mRect.height() <= 0 || mScale <= 0) return QSize();
+
+    // PNG stores its dimensions as 31-bit integers.  Each encoded row (four bytes per pixel plus the filter type)
+    // must also fit in an int and in zlib's 32-bit input count, which limits the width further.
+    const qint64 width = qRound64(mRect.width() * mScale);
+    const qint64 height = qRound64(mRect.height() * mScale);
+    if (width > (std::numeric_limits<int>::max() - 1) / 4 || height > std::numeric_limits<int>::max()) return QSize();
+
+    return QSize(static_cast<int>(width), static_cast<int>(height));
+}
+
+//======================================================================================================================
+
+bool PngWriter::write(const QString& path, const PaintFunction& paint)
+{
+    const QSize size = imageSize();
+    if (size.isEmpty() || !paint) return false;
+
+    QFile pngFile(path);
+    if (!pngFile.open(QFile::WriteOnly)) return false;
+    if (!writeHeader(pngFile, size)) return false;
+
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (deflateInit(&stream, mCompressionLevel) != Z_OK) return false;
+
+    const int bandHeight = effectiveBandHeight(size.width());
+    const int bandCount = static_cast<int>((static_cast<qint64>(size.height()) + bandHeight - 1) / bandHeight);
+    const int threadCount = (mThreadCount > 0) ? mThreadCount : qMax(QThread::idealThreadCount(), 1);
+
+    // Rendered bands wait in a small ring of slots until the encoder reaches them.  A band is only started once the
+    // band that previously used its slot has been encoded, which bounds the memory used to the size of the ring.
+    const int slotCount = qMin(2 * threadCount, bandCount);
+    QVector<QList<QImage>> renderedBands(slotCount);
+    QVector<bool> bandReady(slotCount, false);
+    QMutex mutex;
+    QWaitCondition bandRendered;
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(threadCount);
+
+    auto startBand = [&](int bandIndex)
+    {
+        const int top = bandIndex * bandHeight;
+        const QRect bandRect(0, top, size.width(), qMin(bandHeight, size.height() - top));
+        const int slotIndex = bandIndex % slotCount;
+        pool.start([this, &paint, &renderedBands, &bandReady, &mutex, &bandRendered, bandRect, slotIndex]()
+        {
+            const QList<QImage> tiles = renderBand(bandRect, paint);
+
+            QMutexLocker locker(&mutex);
+            renderedBands[slotIndex] = tiles;
+            bandReady[slotIndex] = true;
+            bandRendered.wakeAll();
+        });
+    };
+
+    for(int bandIndex = 0; bandIndex < slotCount; bandIndex++)
+        startBand(bandIndex);
+
+    // Encode the bands in order.  Each row is prefixed with the Sub filter type, which only depends on the row itself
+    // and compresses the large flat areas typical of drawings well.
+    const int rowBytes = 4 * size.width();
+    QByteArray row(rowBytes + 1, 0);
+    QByteArray buffer(sOutputBufferSize, 0);
+    bool success = true;
+
+    for(int bandIndex = 0; success && bandIndex < bandCount; bandIndex++)
+    {
+        const int slotIndex = bandIndex % slotCount;
+        QList<QImage> tiles;
+        {
+            QMutexLocker locker(&mutex);
+            while (!bandReady[slotIndex]) bandRendered.wait(&mutex);
+            tiles = renderedBands[slotIndex];
+            renderedBands[slotIndex].clear();
+            bandReady[slotIndex] = false;
+        }
+
+        if (bandIndex + slotCount < bandCount) startBand(bandIndex + slotCount);
+
+        success = !tiles.isEmpty();
+        const int rowCount = (success) ? tiles.first().height() : 0;
+        for(int y = 0; success && y < rowCount; y++)
+        {
+            uchar* rowData = reinterpret_cast<uchar*>(row.data());
+            rowData[0] = 1;
+
+            uchar* pixels = rowData + 1;
+            for(auto& tile : qAsConst(tiles))
+            {
+                memcpy(pixels, tile.constScanLine(y), 4 * tile.width());
+                pixels += 4 * tile.width();
+            }
+
+            // Filter from right to left so that each byte is still unfiltered when its right neighbour needs it
+            pixels = rowData + 1;
+            for(int i = rowBytes - 1; i >= 4; i--)
+                pixels[i] = static_cast<uchar>(pixels[i] - pixels[i - 4]);
+
+            stream.next_in = rowData;
+            stream.avail_in = static_cast<uInt>(row.size());
+            success = writeData(pngFile, &stream, buffer, false);
+        }
+    }
+
+    if (success) success = writeData(pngFile, &stream, buffer, true);
+    deflateEnd(&stream);
+
+    // Bands still in flight after an error refer to local state, so let them finish before returning
+    pool.waitForDone();
+
+    if (success) success = writeChunk(pngFile, "IEND", QByteArray());
+    return success;
+}
+
+//======================================================================================================================
+
+int PngWriter::effectiveBandHeight(int width) const
+{
+    if (mBandHeight > 0) return mBandHeight;
+    return static_cast<int>(qBound<qint64>(1, sTargetBandPixels / qMax(width, 1), 1024));
+}
+
+QList<QImage> PngWriter::renderBand(const QRect& bandRect, const PaintFunction& paint) const
+{
+    QList<QImage> tiles;
+
+    for(int left = bandRect.left(); left <= bandRect.right(); left += sMaximumTileWidth)
+    {
+        const QRect tileRect(left, bandRect.top(), qMin(sMaximumTileWidth, bandRect.right() - left + 1),
+                             bandRect.height());
+
+        QImage tile(tileRect.size(), QImage::Format_ARGB32_Premultiplied);
+        if (tile.isNull()) return QList<QImage>();
+        tile.fill(Qt::transparent);
+
+        // The tile's scene rect is padded by a couple of pixels for antialiasing at the edges of items just outside it
+        const double margin = 2 / mScale;
+        const QRectF sceneRect(mRect.left() + tileRect.left() / mScale - margin,
+                               mRect.top() + tileRect.top() / mScale - margin,
+                               tileRect.width() / mScale + 2 * margin, tileRect.height() / mScale + 2 * margin);
+
+        QPainter painter(&tile);
+        painter.translate(-tileRect.left(), -tileRect.top());
+        painter.scale(mScale, mScale);
+        painter.translate(-mRect.left(), -mRect.top());
+        paint(painter, sceneRect);
+        painter.end();
+
+        // PNG wants non-premultiplied RGBA in memory order
+        tile.convertTo(QImage::Format_RGBA8888);
+        tiles.append(tile);
+    }
+
+    return tiles;
+}
+
+//======================================================================================================================
+
+bool PngWriter::writeHeader(QFile& file, const QSize& size) const
+{
+    static const char signature[8] = { '\x89', 'P', 'N', 'G', '\r', '\n', '\x1A', '\n' };
+    if (file.write(signature, sizeof(signature)) != sizeof(signature)) return false;
+
+    // Width, height, 8 bits per channel, RGBA color, deflate compression, adaptive filtering, no interlacing
+    QByteArray header(13, 0);
+    qToBigEndian<quint32>(static_cast<quint32>(size.width()), header.data());
+    qToBigEndian<quint32>(static_cast<quint32>(size.height()), header.data() + 4);
+    header[8] = 8;
+    header[9] = 6;
+    return writeChunk(file, "IHDR", header);
+}
+
+bool PngWriter::writeData(QFile& file, z_stream_s* stream, QByteArray& buffer, bool finish) const
+{
+    // Compress whatever input is pending, writing an IDAT chunk each time the output buffer fills up
+    int result = Z_OK;
+    do
+    {
+        stream->next_out = reinterpret_cast<Bytef*>(buffer.data());
+        stream->avail_out = static_cast<uInt>(buffer.size());
+
+        result = deflate(stream, finish ? Z_FINISH : Z_NO_FLUSH);
+        if (result == Z_STREAM_ERROR) return false;
+
+        const int outputSize = buffer.size() - static_cast<int>(stream->avail_out);
+        if (outputSize > 0 && !writeChunk(file, "IDAT", QByteArray::fromRawData(buffer.constData(), outputSize)))
+            return false;
+    } while (stream->avail_out == 0 || (finish && result != Z_STREAM_END));
+
+    return true;
+}
+
+bool PngWriter::writeChunk(QFile& file, const char* type, const QByteArray& data) const
+{
+    char length[4];
+    qToBigEndian<quint32>(static_cast<quint32>(data.size()), length);
+
+    // The CRC covers the chunk type and data but not the length
+    uLong crc = crc32(0L, reinterpret_cast<const Bytef*>(type), 4);
+    crc = crc32(crc, reinterpret_cast<const Bytef*>(data.constData()), static_cast<uInt>(data.size()));
+    char crcBytes[4];
+    qToBigEndian<quint32>(static_cast<quint32>(crc), crcBytes);
+
+    return (file.write(length, 4) == 4 && file.write(type, 4) == 4 && file.write(data) == data.size() &&
+            file.write(crcBytes, 4) == 4);
+}
@@ -0,0 +1,72 @@
+// File: PngWriter.h
+// Copyright (C) 2023  Jason Allen
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef PNGWRITER_H
+#define PNGWRITER_H
+
+#include <QImage>
+#include <QList>
+#include <QRectF>
+#include <functional>
+
+class QFile;
+class QPainter;
+struct z_stream_s;
+
+// Writes a region of a drawing to a PNG file without ever holding the whole image in memory.  The image is rendered
+// in horizontal bands, each split into tiles no wider than a QImage can comfortably handle.  Bands are rendered in
+// parallel and streamed row by row into the PNG encoder in order, so memory use depends on the image width and the
+// number of threads rather than on the image height.
+class PngWriter
+{
+public:
+    // Paints the drawing in scene coordinates; the painter is already mapped onto the tile being rendered, and
+    // sceneRect is the part of the scene that the tile covers, so items outside it can be skipped.  This is called
+    // concurrently from several threads, so it must not modify shared state.
+    typedef std::function<void(QPainter& painter, const QRectF& sceneRect)> PaintFunction;
+
+private:
+    QRectF mRect;
+    double mScale;
+
+    int mBandHeight;
+    int mThreadCount;
+    int mCompressionLevel;
+
+public:
+    PngWriter(const QRectF& rect, double scale);
+
+    void setBandHeight(int height);
+    void setThreadCount(int count);
+    void setCompressionLevel(int level);
+    int bandHeight() const;
+    int threadCount() const;
+    int compressionLevel() const;
+
+    QSize imageSize() const;
+
+    bool write(const QString& path, const PaintFunction& paint);
+
+private:
+    int effectiveBandHeight(int width) const;
+    QList<QImage> renderBand(const QRect& bandRect, const PaintFunction& paint) const;
+
+    bool writeHeader(QFile& file, const QSize& size) const;
+    bool writeData(QFile& file, z_stream_s* stream, QByteArray& buffer, bool finish) const;
+    bool writeChunk(QFile& file, const char* type, const QByteArray& data) const;
+};
+
+#endif
@@ -21,10 +21,12 @@
 #include "SingleItemPropertiesWidget.h"
 #include <QCheckBox>
 #include <QDialogButtonBox>
+#include <QFormLayout>
 #include <QGroupBox>
 #include <QHBoxLayout>
 #include <QListWidget>
 #include <QPushButton>
+#include <QSpinBox>
 #include <QStackedWidget>
 #include <QVBoxLayout>
 
@@ -58,9 +60,23 @@ PreferencesDialog::PreferencesDialog(QWidget* parent) : QDialog(parent)
     promptLayout->addWidget(mPromptCloseUnsavedCheck);
     promptGroup->setLayout(promptLayout);
 
+    mUndoMemoryBudgetSpin = new QSpinBox();
+    mUndoMemoryBudgetSpin->setRange(0, 65536);
+    mUndoMemoryBudgetSpin->setSingleStep(64);
+    mUndoMemoryBudgetSpin->setSuffix(" MB");
+    mUndoMemoryBudgetSpin->setSpecialValueText("Unlimited");
+    mUndoSpillCheck = new QCheckBox("Move old undo history to a temporary file before discarding it");
+
+    QGroupBox* undoGroup = new QGroupBox("Undo History");
+    QFormLayout* undoLayout = new QFormLayout();
+    undoLayout->addRow("Memory Budget:", mUndoMemoryBudgetSpin);
+    undoLayout->addRow(mUndoSpillCheck);
+    undoGroup->setLayout(undoLayout);
+
     QWidget* generalWidget = new QWidget();
     QVBoxLayout* generalLayout = new QVBoxLayout();
     generalLayout->addWidget(promptGroup);
+    generalLayout->addWidget(undoGroup);
     generalLayout->addWidget(new QWidget(), 100);
     generalWidget->setLayout(generalLayout);
 
@@ -148,6 +164,20 @@ void PreferencesDialog::updatePrompts(bool& overwrite, bool& closeUnsaved)
 
 //======================================================================================================================
 
+void PreferencesDialog::setUndoSettings(int memoryBudget, bool spill)
+{
+    mUndoMemoryBudgetSpin->setValue(memoryBudget);
+    mUndoSpillCheck->setChecked(spill);
+}
+
+void PreferencesDialog::updateUndoSettings(int& memoryBudget, bool& spill)
+{
+    memoryBudget = mUndoMemoryBudgetSpin->value();
+    spill = mUndoSpillCheck->isChecked();
+}
+
+//======================================================================================================================
+
 void PreferencesDialog::setDrawingTemplate(OdgDrawing* drawingTemplate, OdgStyle* styleTemplate)
 {
     if (drawingTemplate)
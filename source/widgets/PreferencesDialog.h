@@ -22,6 +22,7 @@
 class QCheckBox;
 class QListWidget;
 class QPushButton;
+class QSpinBox;
 class QStackedWidget;
 class DrawingPropertiesWidget;
 class OdgDrawing;
@@ -39,6 +40,9 @@ private:
     QCheckBox* mPromptOverwriteCheck;
     QCheckBox* mPromptCloseUnsavedCheck;
 
+    QSpinBox* mUndoMemoryBudgetSpin;
+    QCheckBox* mUndoSpillCheck;
+
     DrawingPropertiesWidget* mDrawingPropertiesWidget;
     SingleItemPropertiesWidget* mStylePropertiesWidget;
 
@@ -51,6 +55,9 @@ public:
     void setPrompts(bool overwrite, bool closeUnsaved);
     void updatePrompts(bool& overwrite, bool& closeUnsaved);
 
+    void setUndoSettings(int memoryBudget, bool spill);
+    void updateUndoSettings(int& memoryBudget, bool& spill);
+
     void setDrawingTemplate(OdgDrawing* drawingTemplate, OdgStyle* styleTemplate);
     void updateDrawingTemplate(OdgDrawing* drawingTemplate, OdgStyle* styleTemplate);
 };
@@ -32,34 +32,12 @@ PropertiesWidget::PropertiesWidget(DrawingWidget* drawing) : QStackedWidget(),
 {
     Q_ASSERT(mDrawing != nullptr);
 
-    // Add drawing properties widget
+    // Only the drawing properties are visible at startup.  The item defaults tab and the single and multiple item
+    // properties widgets are large, so each of them is created the first time it is shown.
     mDrawingPropertiesWidget = new DrawingPropertiesWidget();
+    mDrawingPropertiesScrollArea = createScrollArea(mDrawingPropertiesWidget);
 
-    QWidget* drawingPropertiesWidget = new QWidget();
-    QVBoxLayout* drawingPropertiesLayout = new QVBoxLayout();
-    drawingPropertiesLayout->addWidget(mDrawingPropertiesWidget);
-    drawingPropertiesLayout->addWidget(new QWidget(), 100);
-    drawingPropertiesLayout->setContentsMargins(0, 0, 0, 0);
-    drawingPropertiesWidget->setLayout(drawingPropertiesLayout);
-
-    mDrawingPropertiesScrollArea = new QScrollArea();
-    mDrawingPropertiesScrollArea->setWidget(drawingPropertiesWidget);
-    mDrawingPropertiesScrollArea->setWidgetResizable(true);
-
-    // Add default item properties widget
-    mDefaultItemPropertiesWidget = new SingleItemPropertiesWidget();
-    mDefaultItemPropertiesWidget->setUnits(mDrawingPropertiesWidget->units());
-
-    QWidget* defaultItemPropertiesWidget = new QWidget();
-    QVBoxLayout* defaultItemPropertiesLayout = new QVBoxLayout();
-    defaultItemPropertiesLayout->addWidget(mDefaultItemPropertiesWidget);
-    defaultItemPropertiesLayout->addWidget(new QWidget(), 100);
-    defaultItemPropertiesLayout->setContentsMargins(0, 0, 0, 0);
-    defaultItemPropertiesWidget->setLayout(defaultItemPropertiesLayout);
-
-    mDefaultItemPropertiesScrollArea = new QScrollArea();
-    mDefaultItemPropertiesScrollArea->setWidget(defaultItemPropertiesWidget);
-    mDefaultItemPropertiesScrollArea->setWidgetResizable(true);
+    mDefaultItemPropertiesScrollArea = createScrollArea();
 
     // Add tab widget
     mTabWidget = new QTabWidget();
@@ -70,38 +48,7 @@ PropertiesWidget::PropertiesWidget(DrawingWidget* drawing) : QStackedWidget(),
     mTabWidget->setStyleSheet("QTabWidget::pane { "
                               "margin: 0px,0px,0px,0px; "
                               "border: 0px solid #020202; }");
-
-    // Add multiple item properties widget
-    mMultipleItemPropertiesWidget = new MultipleItemPropertiesWidget();
-    mMultipleItemPropertiesWidget->setUnits(mDrawingPropertiesWidget->units());
-
-    QWidget* multipleItemPropertiesWidget = new QWidget();
-    QVBoxLayout* multipleItemPropertiesLayout = new QVBoxLayout();
-    multipleItemPropertiesLayout->addWidget(mMultipleItemPropertiesWidget);
-    multipleItemPropertiesLayout->addWidget(new QWidget(), 100);
-    multipleItemPropertiesLayout->setContentsMargins(0, 0, 0, 0);
-    multipleItemPropertiesWidget->setLayout(multipleItemPropertiesLayout);
-
-    mMultipleItemPropertiesScrollArea = new QScrollArea();
-    mMultipleItemPropertiesScrollArea->setWidget(multipleItemPropertiesWidget);
-    mMultipleItemPropertiesScrollArea->setWidgetResizable(true);
-    addWidget(mMultipleItemPropertiesScrollArea);
-
-    // Add single item properties widget
-    mSingleItemPropertiesWidget = new SingleItemPropertiesWidget();
-    mSingleItemPropertiesWidget->setUnits(mDrawingPropertiesWidget->units());
-
-    QWidget* singleItemPropertiesWidget = new QWidget();
-    QVBoxLayout* singleItemPropertiesLayout = new QVBoxLayout();
-    singleItemPropertiesLayout->addWidget(mSingleItemPropertiesWidget);
-    singleItemPropertiesLayout->addWidget(new QWidget(), 100);
-    singleItemPropertiesLayout->setContentsMargins(0, 0, 0, 0);
-    singleItemPropertiesWidget->setLayout(singleItemPropertiesLayout);
-
-    mSingleItemPropertiesScrollArea = new QScrollArea();
-    mSingleItemPropertiesScrollArea->setWidget(singleItemPropertiesWidget);
-    mSingleItemPropertiesScrollArea->setWidgetResizable(true);
-    addWidget(mSingleItemPropertiesScrollArea);
+    connect(mTabWidget, SIGNAL(currentChanged(int)), this, SLOT(showTab(int)));
 
     // Connect signals/slots between drawing widget and properties widgets
     connect(mDrawing, SIGNAL(propertyChanged(QString,QVariant)), this, SLOT(setDrawingProperty(QString,QVariant)));
@@ -112,24 +59,6 @@ PropertiesWidget::PropertiesWidget(DrawingWidget* drawing) : QStackedWidget(),
 
     connect(mDrawingPropertiesWidget, SIGNAL(propertyChanged(QString,QVariant)),
             mDrawing, SLOT(setDrawingProperty(QString,QVariant)));
-    connect(mDefaultItemPropertiesWidget, SIGNAL(itemPropertyChanged(QString,QVariant)),
-            mDrawing, SLOT(setDefaultStyleProperty(QString,QVariant)));
-
-    connect(mMultipleItemPropertiesWidget, SIGNAL(itemsMovedDelta(QPointF)), mDrawing, SLOT(moveDelta(QPointF)));
-    connect(mMultipleItemPropertiesWidget, SIGNAL(itemsPropertyChanged(QString,QVariant)),
-            mDrawing, SLOT(setItemsProperty(QString,QVariant)));
-
-    connect(mSingleItemPropertiesWidget, SIGNAL(itemMoved(QPointF)), mDrawing, SLOT(move(QPointF)));
-    connect(mSingleItemPropertiesWidget, SIGNAL(itemResized(OdgControlPoint*,QPointF)), mDrawing,
-            SLOT(resize(OdgControlPoint*,QPointF)));
-    connect(mSingleItemPropertiesWidget, SIGNAL(itemResized2(OdgControlPoint*,QPointF,OdgControlPoint*,QPointF)),
-            mDrawing, SLOT(resize2(OdgControlPoint*,QPointF,OdgControlPoint*,QPointF)));
-    connect(mSingleItemPropertiesWidget, SIGNAL(itemPropertyChanged(QString,QVariant)),
-            mDrawing, SLOT(setItemsProperty(QString,QVariant)));
-
-    connect(mDrawingPropertiesWidget, SIGNAL(unitsChanged(int)), mDefaultItemPropertiesWidget, SLOT(setUnits(int)));
-    connect(mDrawingPropertiesWidget, SIGNAL(unitsChanged(int)), mMultipleItemPropertiesWidget, SLOT(setUnits(int)));
-    connect(mDrawingPropertiesWidget, SIGNAL(unitsChanged(int)), mSingleItemPropertiesWidget, SLOT(setUnits(int)));
 }
 
 //======================================================================================================================
@@ -154,6 +83,15 @@ void PropertiesWidget::setAllDrawingProperties()
     mDrawingPropertiesWidget->setGridSpacingMajor(mDrawing->gridSpacingMajor());
     mDrawingPropertiesWidget->setGridSpacingMinor(mDrawing->gridSpacingMinor());
 
+    setDefaultItemProperties();
+
+    setCurrentIndex(0);
+}
+
+void PropertiesWidget::setDefaultItemProperties()
+{
+    if (!mDefaultItemPropertiesWidget) return;
+
     OdgStyle* style = mDrawing->defaultStyle();
     mDefaultItemPropertiesWidget->setPenStyle(style->penStyle());
     mDefaultItemPropertiesWidget->setPenWidth(style->penWidth());
@@ -171,8 +109,6 @@ void PropertiesWidget::setAllDrawingProperties()
     mDefaultItemPropertiesWidget->setTextAlignment(style->textAlignment());
     mDefaultItemPropertiesWidget->setTextPadding(style->textPadding());
     mDefaultItemPropertiesWidget->setTextColor(style->textColor());
-
-    setCurrentIndex(0);
 }
 
 void PropertiesWidget::setDrawingProperty(const QString& name, const QVariant& value)
@@ -185,13 +121,93 @@ void PropertiesWidget::setItems(const QList<OdgItem*>& items)
 {
     if (items.size() > 1)
     {
+        if (!mMultipleItemPropertiesWidget) createMultipleItemPropertiesWidget();
         mMultipleItemPropertiesWidget->setItems(items);
-        setCurrentIndex(1);
+        setCurrentWidget(mMultipleItemPropertiesScrollArea);
     }
     else if (items.size() == 1)
     {
+        if (!mSingleItemPropertiesWidget) createSingleItemPropertiesWidget();
         mSingleItemPropertiesWidget->setItem(items.first());
-        setCurrentIndex(2);
+        setCurrentWidget(mSingleItemPropertiesScrollArea);
     }
     else setCurrentIndex(0);
 }
+
+//======================================================================================================================
+
+void PropertiesWidget::showTab(int index)
+{
+    if (mTabWidget->widget(index) == mDefaultItemPropertiesScrollArea && !mDefaultItemPropertiesWidget)
+        createDefaultItemPropertiesWidget();
+}
+
+//======================================================================================================================
+
+void PropertiesWidget::createDefaultItemPropertiesWidget()
+{
+    mDefaultItemPropertiesWidget = new SingleItemPropertiesWidget();
+    mDefaultItemPropertiesWidget->setUnits(mDrawingPropertiesWidget->units());
+    setDefaultItemProperties();
+
+    setScrollAreaWidget(mDefaultItemPropertiesScrollArea, mDefaultItemPropertiesWidget);
+
+    connect(mDefaultItemPropertiesWidget, SIGNAL(itemPropertyChanged(QString,QVariant)),
+            mDrawing, SLOT(setDefaultStyleProperty(QString,QVariant)));
+    connect(mDrawingPropertiesWidget, SIGNAL(unitsChanged(int)), mDefaultItemPropertiesWidget, SLOT(setUnits(int)));
+}
+
+void PropertiesWidget::createMultipleItemPropertiesWidget()
+{
+    mMultipleItemPropertiesWidget = new MultipleItemPropertiesWidget();
+    mMultipleItemPropertiesWidget->setUnits(mDrawingPropertiesWidget->units());
+
+    mMultipleItemPropertiesScrollArea = createScrollArea(mMultipleItemPropertiesWidget);
+    addWidget(mMultipleItemPropertiesScrollArea);
+
+    connect(mMultipleItemPropertiesWidget, SIGNAL(itemsMovedDelta(QPointF)), mDrawing, SLOT(moveDelta(QPointF)));
+    connect(mMultipleItemPropertiesWidget, SIGNAL(itemsPropertyChanged(QString,QVariant)),
+            mDrawing, SLOT(setItemsProperty(QString,QVariant)));
+    connect(mMultipleItemPropertiesWidget, SIGNAL(itemsPropertiesChanged(QHash<QString,QVariant>)),
+            mDrawing, SLOT(setItemsProperties(QHash<QString,QVariant>)));
+    connect(mDrawingPropertiesWidget, SIGNAL(unitsChanged(int)), mMultipleItemPropertiesWidget, SLOT(setUnits(int)));
+}
+
+void PropertiesWidget::createSingleItemPropertiesWidget()
+{
+    mSingleItemPropertiesWidget = new SingleItemPropertiesWidget();
+    mSingleItemPropertiesWidget->setUnits(mDrawingPropertiesWidget->units());
+
+    mSingleItemPropertiesScrollArea = createScrollArea(mSingleItemPropertiesWidget);
+    addWidget(mSingleItemPropertiesScrollArea);
+
+    connect(mSingleItemPropertiesWidget, SIGNAL(itemMoved(QPointF)), mDrawing, SLOT(move(QPointF)));
+    connect(mSingleItemPropertiesWidget, SIGNAL(itemResized(OdgControlPoint*,QPointF)), mDrawing,
+            SLOT(resize(OdgControlPoint*,QPointF)));
+    connect(mSingleItemPropertiesWidget, SIGNAL(itemResized2(OdgControlPoint*,QPointF,OdgControlPoint*,QPointF)),
+            mDrawing, SLOT(resize2(OdgControlPoint*,QPointF,OdgControlPoint*,QPointF)));
+    connect(mSingleItemPropertiesWidget, SIGNAL(itemPropertyChanged(QString,QVariant)),
+            mDrawing, SLOT(setItemsProperty(QString,QVariant)));
+    connect(mDrawingPropertiesWidget, SIGNAL(unitsChanged(int)), mSingleItemPropertiesWidget, SLOT(setUnits(int)));
+}
+
+QScrollArea* PropertiesWidget::createScrollArea(QWidget* widget)
+{
+    QScrollArea* scrollArea = new QScrollArea();
+    scrollArea->setWidgetResizable(true);
+    if (widget) setScrollAreaWidget(scrollArea, widget);
+    return scrollArea;
+}
+
+void PropertiesWidget::setScrollAreaWidget(QScrollArea* scrollArea, QWidget* widget)
+{
+    // Keep the properties widget at the top of the scroll area, at its natural height
+    QWidget* containerWidget = new QWidget();
+    QVBoxLayout* containerLayout = new QVBoxLayout();
+    containerLayout->addWidget(widget);
+    containerLayout->addWidget(new QWidget(), 100);
+    containerLayout->setContentsMargins(0, 0, 0, 0);
+    containerWidget->setLayout(containerLayout);
+
+    scrollArea->setWidget(containerWidget);
+}
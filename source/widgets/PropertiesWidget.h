@@ -55,6 +55,18 @@ public slots:
     void setAllDrawingProperties();
     void setDrawingProperty(const QString& name, const QVariant& value);
     void setItems(const QList<OdgItem*>& items);
+
+private slots:
+    void showTab(int index);
+
+private:
+    void createDefaultItemPropertiesWidget();
+    void createMultipleItemPropertiesWidget();
+    void createSingleItemPropertiesWidget();
+    QScrollArea* createScrollArea(QWidget* widget = nullptr);
+    void setScrollAreaWidget(QScrollArea* scrollArea, QWidget* widget);
+
+    void setDefaultItemProperties();
 };
 
 #endif
@@ -26,25 +26,105 @@
 #include "OdgTextItem.h"
 #include "OdgTextEllipseItem.h"
 #include "OdgTextRoundedRectItem.h"
+#include <QBuffer>
 #include <QFile>
+#include <QThread>
+#include <QThreadPool>
+#include <QVector>
 #include <QXmlStreamWriter>
+#include <zlib.h>
 
-SvgWriter::SvgWriter(const QRectF& rect, double scale) : mRect(rect), mScale(scale), mMarkers()
+SvgWriter::SvgWriter(const QRectF& rect, double scale) : mRect(rect), mScale(scale), mCompact(false), mPrecision(8),
+    mStyleClassesEnabled(false), mCompressed(false), mThreadCount(0), mChunkSize(4096), mMarkers(), mSymbols(),
+    mSymbolIndices(), mPendingStyle(), mStyleClasses(), mStyles()
 {
     // Nothing more to do here.
 }
 
 //======================================================================================================================
 
+void SvgWriter::setProfile(Profile profile)
+{
+    const bool compact = (profile == CompactProfile);
+    setCompact(compact);
+    setPrecision(compact ? 5 : 8);
+    setStyleClassesEnabled(compact);
+}
+
+void SvgWriter::setCompact(bool compact)
+{
+    mCompact = compact;
+}
+
+void SvgWriter::setPrecision(int digits)
+{
+    mPrecision = qBound(1, digits, 17);
+}
+
+void SvgWriter::setStyleClassesEnabled(bool enabled)
+{
+    mStyleClassesEnabled = enabled;
+}
+
+void SvgWriter::setCompressed(bool compressed)
+{
+    mCompressed = compressed;
+}
+
+void SvgWriter::setThreadCount(int count)
+{
+    mThreadCount = qMax(count, 0);
+}
+
+void SvgWriter::setChunkSize(int itemCount)
+{
+    mChunkSize = qMax(itemCount, 1);
+}
+
+bool SvgWriter::isCompact() const
+{
+    return mCompact;
+}
+
+int SvgWriter::precision() const
+{
+    return mPrecision;
+}
+
+bool SvgWriter::areStyleClassesEnabled() const
+{
+    return mStyleClassesEnabled;
+}
+
+bool SvgWriter::isCompressed() const
+{
+    return mCompressed;
+}
+
+int SvgWriter::threadCount() const
+{
+    return mThreadCount;
+}
+
+int SvgWriter::chunkSize() const
+{
+    return mChunkSize;
+}
+
+//======================================================================================================================
+
 bool SvgWriter::write(const QString& path, const QColor& backgroundColor, const QList<OdgItem*>& items)
 {
     if (mRect.width() <= 0 || mRect.height() <= 0 || mScale <= 0) return false;
 
-    QFile svgFile(path);
-    if (!svgFile.open(QFile::WriteOnly)) return false;
+    // The document is assembled in memory so that it can be compressed and so that the style sheet, which is only
+    // known once every item has been written, can be placed ahead of the items
+    QByteArray svgData;
+    QBuffer svgBuffer(&svgData);
+    svgBuffer.open(QBuffer::WriteOnly);
 
-    QXmlStreamWriter xml(&svgFile);
-    xml.setAutoFormatting(true);
+    QXmlStreamWriter xml(&svgBuffer);
+    xml.setAutoFormatting(!mCompact);
     xml.setAutoFormattingIndent(2);
 
     xml.writeStartDocument();
@@ -54,20 +134,44 @@ bool SvgWriter::write(const QString& path, const QColor& backgroundColor, const
     xml.writeAttribute("viewBox", viewBoxToString(mRect));
     xml.writeAttribute("version", "1.1");
     xml.writeAttribute("xmlns", "http://www.w3.org/2000/svg");
+    xml.writeAttribute("xmlns:xlink", "http://www.w3.org/1999/xlink");
 
     xml.writeStartElement("defs");
     mMarkers.clear();
     writeMarkers(xml, items);
+    mSymbols.clear();
+    mSymbolIndices.clear();
+    findSymbols(items);
+    writeSymbolDefs(xml, items);
     xml.writeEndElement();
 
-    writeBackgroundColor(xml, backgroundColor);
-    writeItems(xml, items);
+    // Items are serialized separately from the header, in parallel for large pages, and then appended after the
+    // style sheet they refer to
+    mPendingStyle.clear();
+    mStyleClasses.clear();
+    mStyles.clear();
+    QByteArray itemsData;
+    {
+        QXmlStreamWriter backgroundXml(&itemsData);
+        backgroundXml.setAutoFormatting(!mCompact);
+        backgroundXml.setAutoFormattingIndent(2);
+        writeBackgroundColor(backgroundXml, backgroundColor);
+    }
+    itemsData += serializeItems(items);
+
+    // The separate writers start at the top level, but the items belong inside <svg>, so indent them one more level.
+    // Every newline in the items' XML is formatting: captions are written one line per <tspan> and attribute values
+    // have their newlines escaped.
+    if (!mCompact) itemsData.replace("\n", "\n  ");
+
+    writeStyleSheet(xml);
+    svgBuffer.write(itemsData);
 
     xml.writeEndElement();
     xml.writeEndDocument();
 
-    svgFile.close();
-    return true;
+    svgBuffer.close();
+    return writeFile(path, svgData);
 }
 
 //======================================================================================================================
@@ -75,50 +179,42 @@ bool SvgWriter::write(const QString& path, const QColor& backgroundColor, const
 void SvgWriter::writeMarkers(QXmlStreamWriter& xml, const QList<OdgItem*>& items)
 {
     OdgCurveItem* curveItem = nullptr;
-    OdgGroupItem* groupItem = nullptr;
     OdgLineItem* lineItem = nullptr;
     OdgPolylineItem* polylineItem = nullptr;
 
     for(auto& item : items)
     {
-        lineItem = dynamic_cast<OdgLineItem*>(item);
-        if (lineItem)
+        switch (item->type())
         {
+        case OdgItem::LineType:
+            lineItem = static_cast<OdgLineItem*>(item);
             if (lineItem->pen().style() != Qt::NoPen && lineItem->pen().brush().color().alpha() != 0)
             {
                 writeMarkerDef(xml, lineItem->startMarker(), lineItem->pen());
                 writeMarkerDef(xml, lineItem->endMarker(), lineItem->pen());
             }
-            continue;
-        }
-
-        curveItem = dynamic_cast<OdgCurveItem*>(item);
-        if (curveItem)
-        {
+            break;
+        case OdgItem::CurveType:
+            curveItem = static_cast<OdgCurveItem*>(item);
             if (curveItem->pen().style() != Qt::NoPen && curveItem->pen().brush().color().alpha() != 0)
             {
                 writeMarkerDef(xml, curveItem->startMarker(), curveItem->pen());
                 writeMarkerDef(xml, curveItem->endMarker(), curveItem->pen());
             }
-            continue;
-        }
-
-        polylineItem = dynamic_cast<OdgPolylineItem*>(item);
-        if (polylineItem)
-        {
+            break;
+        case OdgItem::PolylineType:
+            polylineItem = static_cast<OdgPolylineItem*>(item);
             if (polylineItem->pen().style() != Qt::NoPen && polylineItem->pen().brush().color().alpha() != 0)
             {
                 writeMarkerDef(xml, polylineItem->startMarker(), polylineItem->pen());
                 writeMarkerDef(xml, polylineItem->endMarker(), polylineItem->pen());
             }
-            continue;
-        }
-
-        groupItem = dynamic_cast<OdgGroupItem*>(item);
-        if (groupItem)
-        {
-            writeMarkers(xml, groupItem->items());
-            continue;
+            break;
+        case OdgItem::GroupType:
+            writeMarkers(xml, static_cast<OdgGroupItem*>(item)->items());
+            break;
+        default:
+            break;
         }
     }
 }
@@ -135,7 +231,7 @@ void SvgWriter::writeMarkerDef(QXmlStreamWriter& xml, const OdgMarker& marker, c
         writeElement = !mMarkers.contains(name);
         if (writeElement)
         {
-            mMarkers.append(name);
+            mMarkers.insert(name);
 
             const double arrowWidth = marker.size() / pen.widthF();
             const double arrowHeight = 2 * arrowWidth / qSqrt(3);
@@ -160,7 +256,7 @@ void SvgWriter::writeMarkerDef(QXmlStreamWriter& xml, const OdgMarker& marker, c
         writeElement = !mMarkers.contains(name);
         if (writeElement)
         {
-            mMarkers.append(name);
+            mMarkers.insert(name);
 
             const double diameter = marker.size() / pen.widthF();
 
@@ -243,6 +339,118 @@ QString SvgWriter::createMarkerName(const OdgMarker& marker, const QPen& pen) co
 
 //======================================================================================================================
 
+void SvgWriter::findSymbols(const QList<OdgItem*>& items)
+{
+    OdgPathItem* pathItem = nullptr;
+
+    for(auto& item : items)
+    {
+        switch (item->type())
+        {
+        case OdgItem::PathType:
+            pathItem = static_cast<OdgPathItem*>(item);
+            if (pathItem->pathRect().width() != 0 && pathItem->pathRect().height() != 0)
+            {
+                const int symbolIndex = findSymbol(pathItem);
+                if (symbolIndex >= 0)
+                    mSymbols[symbolIndex].useCount++;
+                else
+                {
+                    Symbol symbol = { pathItem->path(), 1, QString() };
+                    mSymbolIndices[symbolKey(pathItem)].append(mSymbols.size());
+                    mSymbols.append(symbol);
+                }
+            }
+            break;
+        case OdgItem::GroupType:
+            findSymbols(static_cast<OdgGroupItem*>(item)->items());
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+void SvgWriter::writeSymbolDefs(QXmlStreamWriter& xml, const QList<OdgItem*>& items)
+{
+    OdgPathItem* pathItem = nullptr;
+    int symbolIndex = -1;
+
+    // Walk the items rather than mSymbols so that the definitions are written in a stable order.  Shapes used only
+    // once are left inline where they are drawn.
+    for(auto& item : items)
+    {
+        switch (item->type())
+        {
+        case OdgItem::PathType:
+            pathItem = static_cast<OdgPathItem*>(item);
+            symbolIndex = findSymbol(pathItem);
+            if (symbolIndex >= 0 && mSymbols.at(symbolIndex).useCount > 1 && mSymbols.at(symbolIndex).id.isEmpty())
+            {
+                Symbol& symbol = mSymbols[symbolIndex];
+                symbol.id = "Symbol_" + QString::number(symbolIndex + 1);
+
+                xml.writeStartElement("path");
+                xml.writeAttribute("id", symbol.id);
+                xml.writeAttribute("d", pathToString(pathItemPath(pathItem)));
+                xml.writeEndElement();
+            }
+            break;
+        case OdgItem::GroupType:
+            writeSymbolDefs(xml, static_cast<OdgGroupItem*>(item)->items());
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+int SvgWriter::findSymbol(OdgPathItem* item) const
+{
+    // Items with the same key draw the same shape at the same size if their paths also match
+    const QList<int> symbolIndices = mSymbolIndices.value(symbolKey(item));
+    if (!symbolIndices.isEmpty())
+    {
+        const QPainterPath path = item->path();
+        for(auto& symbolIndex : symbolIndices)
+        {
+            if (mSymbols.at(symbolIndex).path == path) return symbolIndex;
+        }
+    }
+    return -1;
+}
+
+QString SvgWriter::symbolKey(OdgPathItem* item) const
+{
+    // The item's rect is part of the key because the path is scaled to fit it; scaling in a <use> transform would
+    // scale the stroke width as well
+    const QRectF rect = item->rect();
+    const QRectF pathRect = item->pathRect();
+    return item->pathName() + "|" + QString::number(rect.left()) + "," + QString::number(rect.top()) + "," +
+           QString::number(rect.width()) + "," + QString::number(rect.height()) + "|" +
+           QString::number(pathRect.left()) + "," + QString::number(pathRect.top()) + "," +
+           QString::number(pathRect.width()) + "," + QString::number(pathRect.height());
+}
+
+//======================================================================================================================
+
+void SvgWriter::writeStyleSheet(QXmlStreamWriter& xml)
+{
+    if (!mStyles.isEmpty())
+    {
+        const QString separator = (mCompact) ? "" : "\n";
+
+        QStringList rules;
+        for(auto& style : qAsConst(mStyles))
+            rules.append("." + mStyleClasses.value(style) + "{" + style + "}");
+
+        xml.writeStartElement("style");
+        xml.writeAttribute("type", "text/css");
+        xml.writeCharacters(separator + rules.join(separator) + separator);
+        xml.writeEndElement();
+    }
+}
+
 void SvgWriter::writeBackgroundColor(QXmlStreamWriter& xml, const QColor& backgroundColor)
 {
     xml.writeStartElement("rect");
@@ -259,105 +467,119 @@ void SvgWriter::writeBackgroundColor(QXmlStreamWriter& xml, const QColor& backgr
 
 void SvgWriter::writeItems(QXmlStreamWriter& xml, const QList<OdgItem*>& items)
 {
-    OdgCurveItem* curveItem = nullptr;
-    OdgEllipseItem* ellipseItem = nullptr;
-    OdgGroupItem* groupItem = nullptr;
-    OdgLineItem* lineItem = nullptr;
-    OdgPathItem* pathItem = nullptr;
-    OdgPolygonItem* polygonItem = nullptr;
-    OdgPolylineItem* polylineItem = nullptr;
-    OdgRectItem* rectItem = nullptr;
-    OdgRoundedRectItem* roundedRectItem = nullptr;
-    OdgTextEllipseItem* textEllipseItem = nullptr;
-    OdgTextItem* textItem = nullptr;
-    OdgTextRoundedRectItem* textRoundedRectItem = nullptr;
-
     for(auto& item : items)
     {
-        lineItem = dynamic_cast<OdgLineItem*>(item);
-        if (lineItem)
-        {
-            writeLineItem(xml, lineItem);
-            continue;
-        }
-
-        curveItem = dynamic_cast<OdgCurveItem*>(item);
-        if (curveItem)
-        {
-            writeCurveItem(xml, curveItem);
-            continue;
-        }
-
-        polylineItem = dynamic_cast<OdgPolylineItem*>(item);
-        if (polylineItem)
+        switch (item->type())
         {
-            writePolylineItem(xml, polylineItem);
-            continue;
-        }
-
-        textItem = dynamic_cast<OdgTextItem*>(item);
-        if (textItem)
-        {
-            writeTextItem(xml, textItem);
-            continue;
-        }
-
-        textRoundedRectItem = dynamic_cast<OdgTextRoundedRectItem*>(item);
-        if (textRoundedRectItem)
-        {
-            writeTextRoundedRectItem(xml, textRoundedRectItem);
-            continue;
+        case OdgItem::LineType:
+            writeLineItem(xml, static_cast<OdgLineItem*>(item));
+            break;
+        case OdgItem::CurveType:
+            writeCurveItem(xml, static_cast<OdgCurveItem*>(item));
+            break;
+        case OdgItem::PolylineType:
+            writePolylineItem(xml, static_cast<OdgPolylineItem*>(item));
+            break;
+        case OdgItem::RectType:
+            writeRectItem(xml, static_cast<OdgRectItem*>(item));
+            break;
+        case OdgItem::RoundedRectType:
+            writeRoundedRectItem(xml, static_cast<OdgRoundedRectItem*>(item));
+            break;
+        case OdgItem::EllipseType:
+            writeEllipseItem(xml, static_cast<OdgEllipseItem*>(item));
+            break;
+        case OdgItem::PolygonType:
+            writePolygonItem(xml, static_cast<OdgPolygonItem*>(item));
+            break;
+        case OdgItem::PathType:
+            writePathItem(xml, static_cast<OdgPathItem*>(item));
+            break;
+        case OdgItem::TextType:
+            writeTextItem(xml, static_cast<OdgTextItem*>(item));
+            break;
+        case OdgItem::TextRoundedRectType:
+            writeTextRoundedRectItem(xml, static_cast<OdgTextRoundedRectItem*>(item));
+            break;
+        case OdgItem::TextEllipseType:
+            writeTextEllipseItem(xml, static_cast<OdgTextEllipseItem*>(item));
+            break;
+        case OdgItem::GroupType:
+            writeGroupItem(xml, static_cast<OdgGroupItem*>(item));
+            break;
         }
+    }
+}
 
-        roundedRectItem = dynamic_cast<OdgRoundedRectItem*>(item);
-        if (roundedRectItem)
-        {
-            writeRoundedRectItem(xml, roundedRectItem);
-            continue;
-        }
+QByteArray SvgWriter::serializeItems(const QList<OdgItem*>& items)
+{
+    const int chunkCount = static_cast<int>((static_cast<qint64>(items.size()) + mChunkSize - 1) / mChunkSize);
+    const int threadCount = (mThreadCount > 0) ? mThreadCount : qMax(QThread::idealThreadCount(), 1);
 
-        textEllipseItem = dynamic_cast<OdgTextEllipseItem*>(item);
-        if (textEllipseItem)
-        {
-            writeTextEllipseItem(xml, textEllipseItem);
-            continue;
-        }
+    if (chunkCount <= 1 || threadCount <= 1)
+    {
+        QByteArray itemsData;
+        QXmlStreamWriter xml(&itemsData);
+        xml.setAutoFormatting(!mCompact);
+        xml.setAutoFormattingIndent(2);
+        writeItems(xml, items);
+        return itemsData;
+    }
 
-        ellipseItem = dynamic_cast<OdgEllipseItem*>(item);
-        if (ellipseItem)
-        {
-            writeEllipseItem(xml, ellipseItem);
-            continue;
-        }
+    QThreadPool pool;
+    pool.setMaxThreadCount(threadCount);
 
-        pathItem = dynamic_cast<OdgPathItem*>(item);
-        if (pathItem)
+    // With style classes, a first pass finds the styles used by each chunk, in the order they appear.  Numbering
+    // them chunk by chunk gives every style the same class as a single-threaded write would, and leaves the table
+    // complete so that the chunks below only read it.
+    if (mStyleClassesEnabled)
+    {
+        QVector<QStringList> chunkStyles(chunkCount);
+        for(int chunkIndex = 0; chunkIndex < chunkCount; chunkIndex++)
         {
-            writePathItem(xml, pathItem);
-            continue;
+            pool.start([this, &items, &chunkStyles, chunkIndex]()
+            {
+                SvgWriter chunkWriter(*this);
+                chunkWriter.mStyleClasses.clear();
+                chunkWriter.mStyles.clear();
+
+                // Only the styles are kept; the chunk's XML is written again below
+                QByteArray chunkData;
+                QXmlStreamWriter xml(&chunkData);
+                chunkWriter.writeItems(xml, items.mid(chunkIndex * mChunkSize, mChunkSize));
+                chunkStyles[chunkIndex] = chunkWriter.mStyles;
+            });
         }
+        pool.waitForDone();
 
-        rectItem = dynamic_cast<OdgRectItem*>(item);
-        if (rectItem)
+        for(auto& styles : qAsConst(chunkStyles))
         {
-            writeRectItem(xml, rectItem);
-            continue;
+            for(auto& style : styles) styleClass(style);
         }
+    }
 
-        polygonItem = dynamic_cast<OdgPolygonItem*>(item);
-        if (polygonItem)
+    // Each chunk of consecutive items is written by its own copy of the writer into its own buffer.  The copies
+    // only read the markers, symbols and style classes found above, and a writer at the top level formats each item
+    // the same way whether or not other items preceded it, so concatenating the buffers in chunk order gives the
+    // same bytes for any thread count.
+    QVector<QByteArray> chunkData(chunkCount);
+    for(int chunkIndex = 0; chunkIndex < chunkCount; chunkIndex++)
+    {
+        pool.start([this, &items, &chunkData, chunkIndex]()
         {
-            writePolygonItem(xml, polygonItem);
-            continue;
-        }
+            SvgWriter chunkWriter(*this);
 
-        groupItem = dynamic_cast<OdgGroupItem*>(item);
-        if (groupItem)
-        {
-            writeGroupItem(xml, groupItem);
-            continue;
-        }
+            QXmlStreamWriter xml(&chunkData[chunkIndex]);
+            xml.setAutoFormatting(!mCompact);
+            xml.setAutoFormattingIndent(2);
+            chunkWriter.writeItems(xml, items.mid(chunkIndex * mChunkSize, mChunkSize));
+        });
     }
+    pool.waitForDone();
+
+    QByteArray itemsData;
+    for(auto& data : qAsConst(chunkData)) itemsData += data;
+    return itemsData;
 }
 
 //======================================================================================================================
@@ -375,10 +597,11 @@ void SvgWriter::writeLineItem(QXmlStreamWriter& xml, OdgLineItem* item)
     xml.writeAttribute("x2", lengthToString(line.x2()));
     xml.writeAttribute("y2", lengthToString(line.y2()));
 
-    xml.writeAttribute("fill", "none");
+    writeStyleAttribute(xml, "fill", "none");
     writePen(xml, item->pen());
     writeStartMarker(xml, item->startMarker(), item->pen());
     writeEndMarker(xml, item->endMarker(), item->pen());
+    writeStyleClass(xml);
 
     xml.writeEndElement();
 }
@@ -396,10 +619,11 @@ void SvgWriter::writeCurveItem(QXmlStreamWriter& xml, OdgCurveItem* item)
     curvePath.cubicTo(curve.cp1(), curve.cp2(), curve.p2());
     xml.writeAttribute("d", pathToString(curvePath));
 
-    xml.writeAttribute("fill", "none");
+    writeStyleAttribute(xml, "fill", "none");
     writePen(xml, item->pen());
     writeStartMarker(xml, item->startMarker(), item->pen());
     writeEndMarker(xml, item->endMarker(), item->pen());
+    writeStyleClass(xml);
 
     xml.writeEndElement();
 }
@@ -419,6 +643,7 @@ void SvgWriter::writeRectItem(QXmlStreamWriter& xml, OdgRectItem* item)
 
     writeBrush(xml, item->brush());
     writePen(xml, item->pen());
+    writeStyleClass(xml);
 
     xml.writeEndElement();
 }
@@ -445,6 +670,7 @@ void SvgWriter::writeRoundedRectItem(QXmlStreamWriter& xml, OdgRoundedRectItem*
 
     writeBrush(xml, item->brush());
     writePen(xml, item->pen());
+    writeStyleClass(xml);
 
     xml.writeEndElement();
 }
@@ -464,6 +690,7 @@ void SvgWriter::writeEllipseItem(QXmlStreamWriter& xml, OdgEllipseItem* item)
 
     writeBrush(xml, item->brush());
     writePen(xml, item->pen());
+    writeStyleClass(xml);
 
     xml.writeEndElement();
 }
@@ -478,6 +705,7 @@ void SvgWriter::writeTextItem(QXmlStreamWriter& xml, OdgTextItem* item)
     writeFont(xml, item->font());
     writeTextAlignment(xml, item->textAlignment());
     writeTextBrush(xml, item->textBrush());
+    writeStyleClass(xml);
 
     writeCaption(xml, item->caption(), QPointF(0, 0), item->textAlignment(), item->textPadding());
 
@@ -509,6 +737,7 @@ void SvgWriter::writeTextRoundedRectItem(QXmlStreamWriter& xml, OdgTextRoundedRe
 
     writeBrush(xml, item->brush());
     writePen(xml, item->pen());
+    writeStyleClass(xml);
 
     xml.writeEndElement();
 
@@ -518,6 +747,7 @@ void SvgWriter::writeTextRoundedRectItem(QXmlStreamWriter& xml, OdgTextRoundedRe
     writeFont(xml, item->font());
     writeTextAlignment(xml, item->textAlignment());
     writeTextBrush(xml, item->textBrush());
+    writeStyleClass(xml);
 
     writeCaption(xml, item->caption(), item->calculateAnchorPoint(item->textAlignment()),
                  item->textAlignment(), item->textPadding());
@@ -542,12 +772,14 @@ void SvgWriter::writeTextEllipseItem(QXmlStreamWriter& xml, OdgTextEllipseItem*
 
     writeBrush(xml, item->brush());
     writePen(xml, item->pen());
+    writeStyleClass(xml);
 
     xml.writeStartElement("text");
 
     writeFont(xml, item->font());
     writeTextAlignment(xml, item->textAlignment());
     writeTextBrush(xml, item->textBrush());
+    writeStyleClass(xml);
 
     writeCaption(xml, item->caption(), item->calculateAnchorPoint(item->textAlignment()),
                  item->textAlignment(), item->textPadding());
@@ -566,10 +798,11 @@ void SvgWriter::writePolylineItem(QXmlStreamWriter& xml, OdgPolylineItem* item)
 
     xml.writeAttribute("points", pointsToString(item->polyline()));
 
-    xml.writeAttribute("fill", "none");
+    writeStyleAttribute(xml, "fill", "none");
     writePen(xml, item->pen());
     writeStartMarker(xml, item->startMarker(), item->pen());
     writeEndMarker(xml, item->endMarker(), item->pen());
+    writeStyleClass(xml);
 
     xml.writeEndElement();
 }
@@ -585,6 +818,7 @@ void SvgWriter::writePolygonItem(QXmlStreamWriter& xml, OdgPolygonItem* item)
 
     writeBrush(xml, item->brush());
     writePen(xml, item->pen());
+    writeStyleClass(xml);
 
     xml.writeEndElement();
 }
@@ -595,26 +829,40 @@ void SvgWriter::writePathItem(QXmlStreamWriter& xml, OdgPathItem* item)
 
     if (pathRect.width() != 0 && pathRect.height() != 0)
     {
-        xml.writeStartElement("path");
+        const int symbolIndex = findSymbol(item);
+        const bool useSymbol = (symbolIndex >= 0 && !mSymbols.at(symbolIndex).id.isEmpty());
+
+        xml.writeStartElement(useSymbol ? "use" : "path");
 
         const QString transform = transformToString(item->position(), item->isFlipped(), item->rotation());
         if (!transform.isEmpty()) xml.writeAttribute("transform", transform);
 
-        const QRectF rect = item->rect();
-        const double xScale = rect.width() / pathRect.width(), yScale = rect.height() / pathRect.height();
-        QTransform pathTransform;
-        pathTransform.translate(-pathRect.left() * xScale, -pathRect.top() * yScale);
-        pathTransform.translate(rect.left(), rect.top());
-        pathTransform.scale(xScale, yScale);
-        xml.writeAttribute("d", pathToString(pathTransform.map(item->path())));
+        if (useSymbol)
+            xml.writeAttribute("xlink:href", "#" + mSymbols.at(symbolIndex).id);
+        else
+            xml.writeAttribute("d", pathToString(pathItemPath(item)));
 
         writeBrush(xml, item->brush());
         writePen(xml, item->pen());
+        writeStyleClass(xml);
 
         xml.writeEndElement();
     }
 }
 
+QPainterPath SvgWriter::pathItemPath(OdgPathItem* item) const
+{
+    // Map the item's path from its path rect onto its rect
+    const QRectF pathRect = item->pathRect();
+    const QRectF rect = item->rect();
+    const double xScale = rect.width() / pathRect.width(), yScale = rect.height() / pathRect.height();
+    QTransform pathTransform;
+    pathTransform.translate(-pathRect.left() * xScale, -pathRect.top() * yScale);
+    pathTransform.translate(rect.left(), rect.top());
+    pathTransform.scale(xScale, yScale);
+    return pathTransform.map(item->path());
+}
+
 void SvgWriter::writeGroupItem(QXmlStreamWriter& xml, OdgGroupItem* item)
 {
     xml.writeStartElement("g");
@@ -696,13 +944,13 @@ void SvgWriter::writeBrush(QXmlStreamWriter& xml, const QBrush& brush)
     QColor brushColor = brush.color();
     if (brushColor.alpha() == 0)
     {
-        xml.writeAttribute("fill", "none");
+        writeStyleAttribute(xml, "fill", "none");
     }
     else
     {
-        xml.writeAttribute("fill", colorToString(brushColor));
+        writeStyleAttribute(xml, "fill", colorToString(brushColor));
         if (brushColor.alpha() != 255)
-            xml.writeAttribute("fill-opacity", percentToString(brushColor.alphaF()));
+            writeStyleAttribute(xml, "fill-opacity", percentToString(brushColor.alphaF()));
     }
 }
 
@@ -711,16 +959,16 @@ void SvgWriter::writePen(QXmlStreamWriter& xml, const QPen& pen)
     QColor penColor = pen.brush().color();
     if (pen.style() == Qt::NoPen || penColor.alpha() == 0)
     {
-        xml.writeAttribute("stroke", "none");
+        writeStyleAttribute(xml, "stroke", "none");
     }
     else
     {
-        xml.writeAttribute("stroke", colorToString(penColor));
+        writeStyleAttribute(xml, "stroke", colorToString(penColor));
         if (penColor.alpha() != 255)
-            xml.writeAttribute("stroke-opacity", percentToString(penColor.alphaF()));
+            writeStyleAttribute(xml, "stroke-opacity", percentToString(penColor.alphaF()));
     }
 
-    xml.writeAttribute("stroke-width", lengthToString(pen.widthF()));
+    writeStyleAttribute(xml, "stroke-width", lengthToString(pen.widthF()));
 
     const QString dashStr = lengthToString(pen.widthF() * 3);
     const QString gapStr = lengthToString(pen.widthF() * 2);
@@ -728,17 +976,17 @@ void SvgWriter::writePen(QXmlStreamWriter& xml, const QPen& pen)
     switch (pen.style())
     {
     case Qt::DashLine:
-        xml.writeAttribute("stroke-dasharray", dashStr + " " + gapStr);
+        writeStyleAttribute(xml, "stroke-dasharray", dashStr + " " + gapStr);
         break;
     case Qt::DotLine:
-        xml.writeAttribute("stroke-dasharray", dotStr + " " + gapStr);
+        writeStyleAttribute(xml, "stroke-dasharray", dotStr + " " + gapStr);
         break;
     case Qt::DashDotLine:
-        xml.writeAttribute("stroke-dasharray", dashStr + " " + gapStr + " " + dotStr + " " + gapStr);
+        writeStyleAttribute(xml, "stroke-dasharray", dashStr + " " + gapStr + " " + dotStr + " " + gapStr);
         break;
     case Qt::DashDotDotLine:
-        xml.writeAttribute(
-            "stroke-dasharray", dashStr + " " + gapStr + " " + dotStr + " " + gapStr + " " + dotStr + " " + gapStr);
+        writeStyleAttribute(xml, "stroke-dasharray",
+                            dashStr + " " + gapStr + " " + dotStr + " " + gapStr + " " + dotStr + " " + gapStr);
         break;
     default:
         break;
@@ -747,13 +995,13 @@ void SvgWriter::writePen(QXmlStreamWriter& xml, const QPen& pen)
     switch (pen.capStyle())
     {
     case Qt::FlatCap:
-        xml.writeAttribute("stroke-linecap", "butt");
+        writeStyleAttribute(xml, "stroke-linecap", "butt");
         break;
     case Qt::SquareCap:
-        xml.writeAttribute("stroke-linecap", "square");
+        writeStyleAttribute(xml, "stroke-linecap", "square");
         break;
     default:
-        xml.writeAttribute("stroke-linecap", "round");
+        writeStyleAttribute(xml, "stroke-linecap", "round");
         break;
     }
 
@@ -761,13 +1009,13 @@ void SvgWriter::writePen(QXmlStreamWriter& xml, const QPen& pen)
     {
     case Qt::MiterJoin:
     case Qt::SvgMiterJoin:
-        xml.writeAttribute("stroke-linejoin", "miter");
+        writeStyleAttribute(xml, "stroke-linejoin", "miter");
         break;
     case Qt::BevelJoin:
-        xml.writeAttribute("stroke-linejoin", "bevel");
+        writeStyleAttribute(xml, "stroke-linejoin", "bevel");
         break;
     default:
-        xml.writeAttribute("stroke-linejoin", "round");
+        writeStyleAttribute(xml, "stroke-linejoin", "round");
         break;
     }
 }
@@ -775,42 +1023,43 @@ void SvgWriter::writePen(QXmlStreamWriter& xml, const QPen& pen)
 void SvgWriter::writeStartMarker(QXmlStreamWriter& xml, const OdgMarker& marker, const QPen& pen)
 {
     if (marker.style() != Odg::NoMarker)
-        xml.writeAttribute("marker-start", "url(#" + createMarkerName(marker, pen) + ")");
+        writeStyleAttribute(xml, "marker-start", "url(#" + createMarkerName(marker, pen) + ")");
 }
 
 void SvgWriter::writeEndMarker(QXmlStreamWriter& xml, const OdgMarker& marker, const QPen& pen)
 {
     if (marker.style() != Odg::NoMarker)
-        xml.writeAttribute("marker-end", "url(#" + createMarkerName(marker, pen) + ")");
+        writeStyleAttribute(xml, "marker-end", "url(#" + createMarkerName(marker, pen) + ")");
 }
 
 void SvgWriter::writeFont(QXmlStreamWriter& xml, const QFont& font)
 {
-    xml.writeAttribute("font-family", font.family());
-    xml.writeAttribute("font-size", lengthToString(font.pointSizeF()));
-    if (font.bold()) xml.writeAttribute("font-weight", "bold");
-    if (font.italic()) xml.writeAttribute("font-style", "italic");
-    if (font.underline()) xml.writeAttribute("text-decoration", "underline");
-    if (font.strikeOut()) xml.writeAttribute("text-decoration", "line-through");
+    // Family names may contain spaces, which a style sheet needs quoted
+    writeStyleAttribute(xml, "font-family", (mStyleClassesEnabled) ? "'" + font.family() + "'" : font.family());
+    writeStyleAttribute(xml, "font-size", lengthToString(font.pointSizeF()));
+    if (font.bold()) writeStyleAttribute(xml, "font-weight", "bold");
+    if (font.italic()) writeStyleAttribute(xml, "font-style", "italic");
+    if (font.underline()) writeStyleAttribute(xml, "text-decoration", "underline");
+    if (font.strikeOut()) writeStyleAttribute(xml, "text-decoration", "line-through");
 }
 
 void SvgWriter::writeTextAlignment(QXmlStreamWriter& xml, Qt::Alignment alignment)
 {
     Qt::Alignment horizontal = (alignment & Qt::AlignHorizontal_Mask);
     if (horizontal & Qt::AlignHCenter)
-        xml.writeAttribute("text-anchor", "middle");
+        writeStyleAttribute(xml, "text-anchor", "middle");
     else if (horizontal & Qt::AlignRight)
-        xml.writeAttribute("text-anchor", "end");
+        writeStyleAttribute(xml, "text-anchor", "end");
     else
-        xml.writeAttribute("text-anchor", "start");
+        writeStyleAttribute(xml, "text-anchor", "start");
 
     Qt::Alignment vertical = (alignment & Qt::AlignVertical_Mask);
     if (vertical & Qt::AlignVCenter)
-        xml.writeAttribute("dominant-baseline", "central");
+        writeStyleAttribute(xml, "dominant-baseline", "central");
     else if (vertical & Qt::AlignBottom)
-        xml.writeAttribute("dominant-baseline", "text-after-edge");
+        writeStyleAttribute(xml, "dominant-baseline", "text-after-edge");
     else
-        xml.writeAttribute("dominant-baseline", "text-before-edge");
+        writeStyleAttribute(xml, "dominant-baseline", "text-before-edge");
 }
 
 void SvgWriter::writeTextBrush(QXmlStreamWriter& xml, const QBrush& brush)
@@ -818,23 +1067,53 @@ void SvgWriter::writeTextBrush(QXmlStreamWriter& xml, const QBrush& brush)
     QColor brushColor = brush.color();
     if (brushColor.alpha() == 0)
     {
-        xml.writeAttribute("fill", "none");
-        xml.writeAttribute("stroke", "none");
+        writeStyleAttribute(xml, "fill", "none");
+        writeStyleAttribute(xml, "stroke", "none");
     }
     else
     {
-        xml.writeAttribute("fill", colorToString(brushColor));
+        writeStyleAttribute(xml, "fill", colorToString(brushColor));
         if (brushColor.alpha() != 255)
-            xml.writeAttribute("fill-opacity", percentToString(brushColor.alphaF()));
-        xml.writeAttribute("stroke", "none");
+            writeStyleAttribute(xml, "fill-opacity", percentToString(brushColor.alphaF()));
+        writeStyleAttribute(xml, "stroke", "none");
+    }
+}
+
+void SvgWriter::writeStyleAttribute(QXmlStreamWriter& xml, const QString& name, const QString& value)
+{
+    // With style classes enabled, style attributes are collected until the element's class is written
+    if (mStyleClassesEnabled)
+        mPendingStyle += name + ":" + value + ";";
+    else
+        xml.writeAttribute(name, value);
+}
+
+void SvgWriter::writeStyleClass(QXmlStreamWriter& xml)
+{
+    if (!mPendingStyle.isEmpty())
+    {
+        xml.writeAttribute("class", styleClass(mPendingStyle));
+        mPendingStyle.clear();
     }
 }
 
+QString SvgWriter::styleClass(const QString& style)
+{
+    QString className = mStyleClasses.value(style);
+    if (className.isEmpty())
+    {
+        className = "s" + QString::number(mStyleClasses.size() + 1);
+        mStyleClasses.insert(style, className);
+        mStyles.append(style);
+    }
+    return className;
+}
+
 //======================================================================================================================
 
 QString SvgWriter::lengthToString(double length) const
 {
-    return QString::number(length, 'g', 8);
+    return QString::number(length, 'g', mPrecision);
 }
 
 QString SvgWriter::percentToString(double value) const
@@ -851,11 +1130,12 @@ QString SvgWriter::colorToString(const QColor& color) const
 
 QString SvgWriter::transformToString(const QPointF& position, bool flipped, int rotation) const
 {
+    const QString separator = (mCompact) ? "," : ", ";
     QString transformStr;
     if (position.x() != 0 || position.y() != 0)
-        transformStr += "translate(" + lengthToString(position.x()) + ", " + lengthToString(position.y()) + ") ";
+        transformStr += "translate(" + lengthToString(position.x()) + separator + lengthToString(position.y()) + ") ";
     if (flipped)
-        transformStr += "scale(-1, 1) ";
+        transformStr += "scale(-1" + separator + "1) ";
     if (rotation != 0)
         transformStr += "rotate(" + QString::number(rotation * 90) + ") ";
     return transformStr.trimmed();
@@ -863,10 +1143,10 @@ QString SvgWriter::transformToString(const QPointF& position, bool flipped, int
 
 QString SvgWriter::viewBoxToString(const QRectF& viewBox) const
 {
-    QString leftStr = QString::number(viewBox.left(), 'g', 8);
-    QString topStr = QString::number(viewBox.top(), 'g', 8);
-    QString widthStr = QString::number(viewBox.width(), 'g', 8);
-    QString heightStr = QString::number(viewBox.height(), 'g', 8);
+    QString leftStr = lengthToString(viewBox.left());
+    QString topStr = lengthToString(viewBox.top());
+    QString widthStr = lengthToString(viewBox.width());
+    QString heightStr = lengthToString(viewBox.height());
     return leftStr + " " + topStr + " " + widthStr + " " + heightStr;
 }
 
@@ -874,12 +1154,14 @@ QString SvgWriter::pointsToString(const QPolygonF& points) const
 {
     QString pointsStr;
     for(auto& point : points)
-        pointsStr += QString::number(point.x(), 'g', 8) + "," + QString::number(point.y(), 'g', 8) + " ";
+        pointsStr += lengthToString(point.x()) + "," + lengthToString(point.y()) + " ";
     return pointsStr.trimmed();
 }
 
 QString SvgWriter::pathToString(const QPainterPath& path) const
 {
+    // Compact output drops the space after each command letter, which SVG path syntax does not need
+    const QString commandSeparator = (mCompact) ? "" : " ";
     QString pathStr;
 
     const int elementCount = path.elementCount();
@@ -889,22 +1171,45 @@ QString SvgWriter::pathToString(const QPainterPath& path) const
         switch (element.type)
         {
         case QPainterPath::MoveToElement:
-            pathStr += "M " + QString::number(element.x, 'g', 8) + " " + QString::number(element.y, 'g', 8) + " ";
+            pathStr += "M" + commandSeparator;
             break;
         case QPainterPath::LineToElement:
-            pathStr += "L " + QString::number(element.x, 'g', 8) + " " + QString::number(element.y, 'g', 8) + " ";
+            pathStr += "L" + commandSeparator;
             break;
         case QPainterPath::CurveToElement:
-            pathStr += "C " + QString::number(element.x, 'g', 8) + " " + QString::number(element.y, 'g', 8) + " ";
-            break;
-        case QPainterPath::CurveToDataElement:
-            pathStr += QString::number(element.x, 'g', 8) + " " + QString::number(element.y, 'g', 8) + " ";
+            pathStr += "C" + commandSeparator;
             break;
         default:
-            pathStr += QString::number(element.x, 'g', 8) + " " + QString::number(element.y, 'g', 8) + " ";
             break;
         }
+        pathStr += lengthToString(element.x) + " " + lengthToString(element.y) + " ";
     }
 
     return pathStr.trimmed();
 }
+
+//======================================================================================================================
+
+bool SvgWriter::writeFile(const QString& path, const QByteArray& data) const
+{
+    QFile svgFile(path);
+    if (!svgFile.open(QFile::WriteOnly)) return false;
+
+    if (!mCompressed) return (svgFile.write(data) == data.size());
+
+    // Compressed output is a gzip stream (.svgz); a window size of 15 + 16 asks zlib for a gzip header and trailer
+    z_stream stream = {};
+    if (deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) return false;
+
+    QByteArray compressedData(static_cast<int>(deflateBound(&stream, static_cast<uLong>(data.size()))), 0);
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.constData()));
+    stream.avail_in = static_cast<uInt>(data.size());
+    stream.next_out = reinterpret_cast<Bytef*>(compressedData.data());
+    stream.avail_out = static_cast<uInt>(compressedData.size());
+
+    const bool finished = (deflate(&stream, Z_FINISH) == Z_STREAM_END);
+    compressedData.resize(static_cast<int>(stream.total_out));
+    deflateEnd(&stream);
+
+    return (finished && svgFile.write(compressedData) == compressedData.size());
+}
@@ -17,7 +17,11 @@
 #ifndef SVGWRITER_H
 #define SVGWRITER_H
 
+#include <QHash>
+#include <QList>
 #include <QPainterPath>
+#include <QSet>
+#include <QStringList>
 
 class QXmlStreamWriter;
 class OdgCurveItem;
@@ -38,15 +42,61 @@ class OdgTextRoundedRectItem;
 
 class SvgWriter
 {
+public:
+    // The standard profile writes indented, human-readable SVG.  The compact profile is meant for publishing: no
+    // formatting whitespace, fewer significant digits, and repeated pen/brush/font attributes replaced by shared
+    // classes in a <style> block.
+    enum Profile { StandardProfile, CompactProfile };
+
+private:
+    // A path shape used by several path items (i.e. a repeated electric or logic symbol) is written once into
+    // <defs> and each item references it with <use>
+    struct Symbol
+    {
+        QPainterPath path;
+        int useCount;
+        QString id;
+    };
+
 private:
     QRectF mRect;
     double mScale;
 
-    QStringList mMarkers;
+    bool mCompact;
+    int mPrecision;
+    bool mStyleClassesEnabled;
+    bool mCompressed;
+    int mThreadCount;
+    int mChunkSize;
+
+    QSet<QString> mMarkers;
+    QList<Symbol> mSymbols;
+    QHash<QString,QList<int>> mSymbolIndices;
+
+    // Style classes are numbered in the order their styles first appear in the items, and mStyles keeps that order
+    QString mPendingStyle;
+    QHash<QString,QString> mStyleClasses;
+    QStringList mStyles;
 
 public:
     SvgWriter(const QRectF& rect, double scale);
 
+    void setProfile(Profile profile);
+    void setCompact(bool compact);
+    void setPrecision(int digits);
+    void setStyleClassesEnabled(bool enabled);
+    void setCompressed(bool compressed);
+    // Pages with more than one chunk of items are serialized in parallel; a thread count of zero uses one thread
+    // per core
+    void setThreadCount(int count);
+    void setChunkSize(int itemCount);
+    bool isCompact() const;
+    int precision() const;
+    bool areStyleClassesEnabled() const;
+    bool isCompressed() const;
+    int threadCount() const;
+    int chunkSize() const;
+
     bool write(const QString& path, const QColor& backgroundColor, const QList<OdgItem*>& items);
 
 private:
@@ -54,8 +104,15 @@ private:
     void writeMarkerDef(QXmlStreamWriter& xml, const OdgMarker& marker, const QPen& pen);
     QString createMarkerName(const OdgMarker& marker, const QPen& pen) const;
 
+    void findSymbols(const QList<OdgItem*>& items);
+    void writeSymbolDefs(QXmlStreamWriter& xml, const QList<OdgItem*>& items);
+    int findSymbol(OdgPathItem* item) const;
+    QString symbolKey(OdgPathItem* item) const;
+
+    void writeStyleSheet(QXmlStreamWriter& xml);
     void writeBackgroundColor(QXmlStreamWriter& xml, const QColor& color);
     void writeItems(QXmlStreamWriter& xml, const QList<OdgItem*>& items);
+    QByteArray serializeItems(const QList<OdgItem*>& items);
 
     void writeLineItem(QXmlStreamWriter& xml, OdgLineItem* item);
     void writeCurveItem(QXmlStreamWriter& xml, OdgCurveItem* item);
@@ -68,6 +125,7 @@ private:
     void writePolylineItem(QXmlStreamWriter& xml, OdgPolylineItem* item);
     void writePolygonItem(QXmlStreamWriter& xml, OdgPolygonItem* item);
     void writePathItem(QXmlStreamWriter& xml, OdgPathItem* item);
+    QPainterPath pathItemPath(OdgPathItem* item) const;
     void writeGroupItem(QXmlStreamWriter& xml, OdgGroupItem* item);
 
     void writeCaption(QXmlStreamWriter& xml, const QString& caption, const QPointF& anchorPoint,
@@ -82,6 +140,9 @@ private:
     void writeFont(QXmlStreamWriter& xml, const QFont& font);
     void writeTextAlignment(QXmlStreamWriter& xml, Qt::Alignment alignment);
     void writeTextBrush(QXmlStreamWriter& xml, const QBrush& brush);
+    void writeStyleAttribute(QXmlStreamWriter& xml, const QString& name, const QString& value);
+    void writeStyleClass(QXmlStreamWriter& xml);
+    QString styleClass(const QString& style);
 
     QString lengthToString(double length) const;
     QString percentToString(double value) const;
@@ -92,6 +153,7 @@ private:
     QString pointsToString(const QPolygonF& points) const;
     QString pathToString(const QPainterPath& path) const;
 
+    bool writeFile(const QString& path, const QByteArray& data) const;
 };
 
 #endif